@@ -12,6 +12,8 @@ SOURCES += \
     camera.cpp \
     chunk.cpp \
     chunkworker.cpp \
+    demheightsource.cpp \
+    gnssheightsource.cpp \
     gpsfileplayer.cpp \
     immfilter.cpp \
     kalmanfilter.cpp \
@@ -21,16 +23,29 @@ SOURCES += \
     mainwindow.cpp \
     myglwidget.cpp \
     noiseutils.cpp \
+    qualitygovernor.cpp \
     speedcontroller.cpp \
+    terrainbatchbuffers.cpp \
+    terrainbufferpool.cpp \
+    terraincompletionqueue.cpp \
     terraingrid.cpp \
-    terrainmanager.cpp
+    terrainindexbuffers.cpp \
+    terrainjobscheduler.cpp \
+    terrainmanager.cpp \
+    terrainmeshcache.cpp \
+    thermalsource.cpp \
+    tractorsimulation.cpp \
+    viewfrustum.cpp
 
 HEADERS += \
     camera.h \
     chunk.h \
     chunkworker.h \
+    demheightsource.h \
     filterprofiles.h \
+    gnssheightsource.h \
     gpsfileplayer.h \
+    heightsource.h \
     immfilter.h \
     kalmanfilter.h \
     linearkalmanfilter.h \
@@ -38,9 +53,19 @@ HEADERS += \
     mainwindow.h \
     myglwidget.h \
     noiseutils.h \
+    qualitygovernor.h \
     speedcontroller.h \
+    terrainbatchbuffers.h \
+    terrainbufferpool.h \
+    terraincompletionqueue.h \
     terraingrid.h \
+    terrainindexbuffers.h \
+    terrainjobscheduler.h \
     terrainmanager.h \
+    terrainmeshcache.h \
+    thermalsource.h \
+    tractorsimulation.h \
+    viewfrustum.h \
     worldconfig.h
 
 FORMS += \
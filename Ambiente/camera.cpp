@@ -10,7 +10,8 @@ camera::camera() :
     m_pitch(0.0f), // Horizontal.
     m_position(0.0f, 20.0f, 30.0f), // Posição inicial no mundo.
     m_front(0.0f, 0.0f, -1.0f), // Vetor inicial 'para frente'.
-    m_worldUp(0.0f, 1.0f, 0.0f) // Vetor 'up' global (Y positivo).
+    m_worldUp(0.0f, 1.0f, 0.0f), // Vetor 'up' global (Y positivo).
+    m_viewDirty(true) // A matriz de visão é calculada no primeiro uso.
 {
     updateCameraVectors(); // Calcula vetores iniciais com base nos ângulos.
 }
@@ -31,10 +32,19 @@ QVector3D camera::position() const {
  * @param up Vetor que define a direção "para cima".
  */
 void camera::lookAt(const QVector3D &position, const QVector3D &target, const QVector3D &up){
+    const QVector3D front = (target - position).normalized();
+    const QVector3D right = QVector3D::crossProduct(front, up).normalized();
+    // A câmera que segue o trator chama lookAt a cada quadro: se nada mudou (trator parado),
+    // a matriz de visão guardada continua válida.
+    if (position == m_position && front == m_front && right == m_right) {
+        return;
+    }
+
     m_position = position;
+    m_viewDirty = true;
 
-    m_front = (target - m_position).normalized();
-    m_right = QVector3D::crossProduct(m_front, up).normalized();
+    m_front = front;
+    m_right = right;
     m_up = QVector3D::crossProduct(m_right, m_front).normalized();
 
     // Recalcula ângulos a partir do novo vetor 'front'.
@@ -61,12 +71,18 @@ void camera::setPerspective(float fov, float aspect, float nearPlane, float farP
 /**
  * @brief Retorna a matriz de visão atual da câmera.
  * @return QMatrix4x4 da matriz de visão.
+ *
+ * A matriz só é recalculada quando a posição ou a orientação mudou desde a última chamada;
+ * as demais chamadas do quadro devolvem a matriz guardada.
  */
-QMatrix4x4 camera::viewMatrix() const{
-    QMatrix4x4 view;
-    // Simula a câmera olhando de 'm_position' para 'm_position + m_front'.
-    view.lookAt(m_position, m_position + m_front, m_up);
-    return view;
+const QMatrix4x4& camera::viewMatrix() const{
+    if (m_viewDirty) {
+        m_viewMatrix.setToIdentity();
+        // Simula a câmera olhando de 'm_position' para 'm_position + m_front'.
+        m_viewMatrix.lookAt(m_position, m_position + m_front, m_up);
+        m_viewDirty = false;
+    }
+    return m_viewMatrix;
 }
 
 /**
@@ -83,6 +99,7 @@ QMatrix4x4 camera::projectionMatrix() const {
  */
 void camera::moveForward(float amount) {
     m_position += m_front * amount;
+    m_viewDirty = true;
 }
 
 /**
@@ -91,6 +108,7 @@ void camera::moveForward(float amount) {
  */
 void camera::strafeRight(float amount) {
     m_position += m_right * amount;
+    m_viewDirty = true;
 }
 
 /**
@@ -99,6 +117,7 @@ void camera::strafeRight(float amount) {
  */
 void camera::moveUp(float amount) {
     m_position += m_worldUp * amount;
+    m_viewDirty = true;
 }
 
 /**
@@ -138,4 +157,5 @@ void camera::updateCameraVectors() {
     // Recalcula 'right' e 'up' para serem ortogonais a 'front' e entre si.
     m_right = QVector3D::crossProduct(m_front, m_worldUp).normalized();
     m_up = QVector3D::crossProduct(m_right, m_front).normalized();
+    m_viewDirty = true;
 }
@@ -22,7 +22,8 @@ public:
     QVector3D position() const;
 
     // Retorna a matriz de visão atual, transformando coordenadas do mundo para o espaço da câmera.
-    QMatrix4x4 viewMatrix() const;
+    // A matriz é guardada e só é recalculada (lookAt) depois que a posição ou a orientação mudam.
+    const QMatrix4x4& viewMatrix() const;
 
     // Retorna a matriz de projeção atual, transformando coordenadas da câmera para o espaço de corte.
     QMatrix4x4 projectionMatrix() const;
@@ -62,6 +63,10 @@ private:
     QVector3D m_worldUp;
     // Matriz de projeção da câmera (perspectiva).
     QMatrix4x4 m_projectionMatrix;
+    // Matriz de visão guardada por `viewMatrix()`; válida enquanto `m_viewDirty` for falso.
+    mutable QMatrix4x4 m_viewMatrix;
+    // Indica que a posição ou a orientação mudou desde o último cálculo de `m_viewMatrix`.
+    mutable bool m_viewDirty;
 };
 
 #endif // CAMERA_H
@@ -2,6 +2,47 @@
 #include "noiseutils.h" // Inclui NoiseUtils para obter altura e normal do terreno.
 #include <QDebug> // Para mensagens de depuração (qInfo, qWarning).
 #include "worldconfig.h" // Inclui WorldConfig para acessar parâmetros como chunkSize.
+#include "terrainindexbuffers.h" // Buffers de índices compartilhados por resolução.
+#include "terrainbufferpool.h" // Pool de VBOs reaproveitados entre chunks.
+#include "terrainbatchbuffers.h" // Páginas de vértices do desenho em lote.
+#include <cmath> // Para std::abs, std::round, std::lround.
+#include <algorithm> // Para std::clamp, std::min e std::minmax_element.
+
+namespace {
+
+/**
+ * @brief Converte um float em [-1, 1] para snorm8.
+ */
+qint8 toSnorm8(float value)
+{
+    return static_cast<qint8>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+}
+
+/**
+ * @brief Codifica uma normal unitária em octaedro (2 componentes em [-1, 1]).
+ * @param n A normal normalizada.
+ * @param out As duas componentes codificadas, em snorm8.
+ *
+ * A normal é projetada no octaedro |x| + |y| + |z| = 1 e o hemisfério inferior (y < 0)
+ * é dobrado sobre o superior, de modo que o plano XZ guarda a direção inteira.
+ * O shader do formato compacto faz a decodificação inversa.
+ */
+void encodeOctNormal(const QVector3D& n, qint8 out[2])
+{
+    float l1 = std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z());
+    float px = n.x() / l1;
+    float pz = n.z() / l1;
+    if (n.y() < 0.0f) {
+        float fx = (1.0f - std::abs(pz)) * (px >= 0.0f ? 1.0f : -1.0f);
+        float fz = (1.0f - std::abs(px)) * (pz >= 0.0f ? 1.0f : -1.0f);
+        px = fx;
+        pz = fz;
+    }
+    out[0] = toSnorm8(px);
+    out[1] = toSnorm8(pz);
+}
+
+} // namespace
 
 /**
  * @brief Construtor padrão da classe chunk.
@@ -11,19 +52,27 @@
 chunk::chunk() :
     m_chunkGridX(0), // Inicializa a coordenada X do chunk na grade.
     m_chunkGridZ(0), // Inicializa a coordenada Z do chunk na grade.
-    // m_vao, m_vbo, m_ebo são inicializados por seus próprios construtores padrão (std::unique_ptr é nullptr por padrão).
+    // m_vao, m_vbo são inicializados por seus próprios construtores padrão (std::unique_ptr é nullptr por padrão).
     m_indexCount(0), // Inicializa a contagem de índices para 0.
     m_vertexCount(0), // Inicializa a contagem de vértices para 0.
     // m_modelMatrix é inicializada como identidade por padrão por QMatrix4x4.
+    m_format(TerrainVertexFormat::Full), // Formato padrão até o primeiro upload.
+    m_gridStep(0.0f), // Passo da grade desconhecido até o primeiro upload.
+    m_indexType(GL_UNSIGNED_INT), // Tipo de índice padrão até o primeiro upload.
+    m_vboSize(0), // Nenhum VBO até o primeiro upload.
     m_currentResolution(0), // Inicializa a resolução atual.
     m_currentLOD(-1), // Inicializa o LOD (Nível de Detalhe) para um valor inválido.
-    m_hasPendingMesh(false) // Inicializa a flag de malha pendente como falsa.
+    m_minHeight(0.0f), // Sem malha, sem extensão em Y.
+    m_maxHeight(0.0f),
+    m_heightBase(0.0f), // Sem malha compacta, alturas absolutas.
+    m_hasPendingMesh(false), // Inicializa a flag de malha pendente como falsa.
+    m_generation(std::make_shared<std::atomic<quint32>>(0)) // Cria o contador de geração compartilhado.
 {}
 
 /**
  * @brief Destrutor da classe chunk.
  *
- * Os membros `std::unique_ptr` (m_vao, m_vbo, m_ebo) gerenciam a vida útil
+ * Os membros `std::unique_ptr` (m_vao, m_vbo) gerenciam a vida útil
  * dos objetos OpenGL. Seus destrutores serão chamados automaticamente,
  * liberando os recursos da GPU quando o chunk for destruído.
  */
@@ -34,7 +83,7 @@ chunk::~chunk() {}
  * @param other O objeto chunk do qual os recursos serão movidos.
  *
  * Permite que objetos `chunk` sejam movidos eficientemente, transferindo
- * a propriedade dos recursos OpenGL (VAO, VBO, EBO) de um objeto temporário
+ * a propriedade dos recursos OpenGL (VAO, VBO) de um objeto temporário
  * ou expirado para um novo, evitando cópias desnecessárias e caras.
  */
 chunk::chunk(chunk&& other) noexcept(true)
@@ -42,12 +91,22 @@ chunk::chunk(chunk&& other) noexcept(true)
     m_chunkGridZ(other.m_chunkGridZ), // Move o valor de m_chunkGridZ.
     m_indexCount(other.m_indexCount), // Move o valor de m_indexCount.
     m_vertexCount(other.m_vertexCount), // Move o valor de m_vertexCount.
+    m_format(other.m_format), // Move o formato de vértice.
+    m_gridStep(other.m_gridStep), // Move o passo da grade.
+    m_indexType(other.m_indexType), // Move o tipo de índice.
+    m_vboSize(other.m_vboSize), // Move o tamanho do VBO.
     m_currentResolution(other.m_currentResolution), // Move o valor de m_currentResolution.
     m_currentLOD(other.m_currentLOD), // Move o valor de m_currentLOD.
+    m_minHeight(other.m_minHeight), // Move a extensão em Y da malha.
+    m_maxHeight(other.m_maxHeight),
+    m_heightBase(other.m_heightBase), // Move a altura de referência da malha compacta.
+    m_batchSlot(other.m_batchSlot), // Move o slot do desenho em lote.
     m_vao(std::move(other.m_vao)),         // Move a propriedade do unique_ptr m_vao.
     m_vbo(std::move(other.m_vbo)),         // Move a propriedade do unique_ptr m_vbo.
-    m_ebo(std::move(other.m_ebo)),         // Move a propriedade do unique_ptr m_ebo.
-    m_modelMatrix(std::move(other.m_modelMatrix)) // QMatrix4x4 também suporta movimento.
+    m_heightTexture(std::move(other.m_heightTexture)), // Move a textura de alturas.
+    m_modelMatrix(std::move(other.m_modelMatrix)), // QMatrix4x4 também suporta movimento.
+    m_hasPendingMesh(false), // A malha pendente não é transferida.
+    m_generation(std::move(other.m_generation)) // Move o contador de geração compartilhado.
 {
     // Deixa o objeto 'other' em um estado válido, mas "vazio" ou resetado,
     // para que seu destrutor não tente liberar recursos que foram movidos.
@@ -55,9 +114,12 @@ chunk::chunk(chunk&& other) noexcept(true)
     other.m_chunkGridZ = 0; // Zera a coordenada Z do objeto 'other'.
     other.m_indexCount = 0; // Zera a contagem de índices do objeto 'other'.
     other.m_vertexCount = 0; // Zera a contagem de vértices do objeto 'other'.
+    other.m_vboSize = 0; // O VBO foi movido.
     other.m_currentResolution = 0; // Zera a resolução do objeto 'other'.
     other.m_currentLOD = -1; // Define o LOD do objeto 'other' como inválido.
-    // Os objetos m_vao, m_vbo, m_ebo em 'other' agora estão em um estado "movido de"
+    other.m_batchSlot = TerrainBatchSlot(); // O slot agora pertence a este chunk.
+    other.m_generation = std::make_shared<std::atomic<quint32>>(0); // Dá ao 'other' um contador próprio.
+    // Os objetos m_vao, m_vbo em 'other' agora estão em um estado "movido de"
     // (geralmente inválido para uso, mas seguro para destruição).
     // qInfo() << "Chunk Move Constructed";
 }
@@ -79,160 +141,428 @@ chunk& chunk::operator=(chunk&& other) noexcept(true) {
         m_chunkGridZ = other.m_chunkGridZ; // Move o valor de m_chunkGridZ.
         m_indexCount = other.m_indexCount; // Move o valor de m_indexCount.
         m_vertexCount = other.m_vertexCount; // Move o valor de m_vertexCount.
+        m_format = other.m_format; // Move o formato de vértice.
+        m_gridStep = other.m_gridStep; // Move o passo da grade.
+        m_indexType = other.m_indexType; // Move o tipo de índice.
+        m_vboSize = other.m_vboSize; // Move o tamanho do VBO.
         m_currentResolution = other.m_currentResolution; // Move o valor de m_currentResolution.
         m_currentLOD = other.m_currentLOD; // Move o valor de m_currentLOD.
+        m_minHeight = other.m_minHeight; // Move a extensão em Y da malha.
+        m_maxHeight = other.m_maxHeight;
+        m_heightBase = other.m_heightBase; // Move a altura de referência da malha compacta.
+        m_batchSlot = other.m_batchSlot; // Move o slot do desenho em lote.
         m_vao = std::move(other.m_vao); // Move a propriedade do unique_ptr m_vao.
         m_vbo = std::move(other.m_vbo); // Move a propriedade do unique_ptr m_vbo.
-        m_ebo = std::move(other.m_ebo); // Move a propriedade do unique_ptr m_ebo.
+        m_heightTexture = std::move(other.m_heightTexture); // Move a textura de alturas.
         m_modelMatrix = std::move(other.m_modelMatrix); // Move a QMatrix4x4.
+        m_generation = std::move(other.m_generation); // Move o contador de geração compartilhado.
         // Resetar o objeto 'other' para um estado válido, mas vazio.
         other.m_chunkGridX = 0;
         other.m_chunkGridZ = 0;
         other.m_indexCount = 0;
         other.m_vertexCount = 0;
+        other.m_vboSize = 0;
         other.m_currentResolution = 0;
         other.m_currentLOD = -1;
+        other.m_batchSlot = TerrainBatchSlot();
+        other.m_generation = std::make_shared<std::atomic<quint32>>(0);
     }
     // qInfo() << "Chunk Move Assigned";
     return *this; // Retorna uma referência ao objeto atual.
 }
 
 /**
- * @brief Gera os dados de vértices e índices para a malha de um chunk.
+ * @brief Gera os vértices da malha de um chunk.
  * @param cX Coordenada X do chunk na grade.
  * @param cZ Coordenada Z do chunk na grade.
  * @param resolution A resolução da malha a ser gerada (número de vértices por lado).
- * @param chunkSize O tamanho do chunk, usado para calcular posições no mundo.
- * @return MeshData Uma estrutura contendo os dados de vértices e índices gerados.
+ * @param config A configuração do mundo (tamanho do chunk e formato de vértice).
+ * @param isCancelled Função opcional consultada a cada linha; se retornar true, a geração é abandonada.
+ * @return MeshData Uma estrutura contendo os vértices gerados
+ *         (vazia se a geração foi cancelada).
  *
  * Esta função é intensiva em CPU e deve ser executada em uma thread separada.
- * Ela itera sobre uma grade para criar vértices, calcula suas posições (incluindo altura do ruído)
- * e normais, e então gera os índices para formar triângulos.
+ * Ela avalia a altura uma vez por ponto de uma grade com borda de uma amostra e, a partir
+ * dela, calcula as posições e as normais (por diferenças centrais, ou pelas amostras
+ * deslocadas de NoiseUtils::getNormal com `WorldConfig::analyticTerrainNormals`) e a
+ * altura de cada vértice na malha do próximo nível de LOD, usada no morphing entre níveis.
+ * Os índices não são gerados aqui: a topologia é a mesma para todos os chunks de
+ * uma resolução e vem do buffer compartilhado (TerrainIndexBuffers).
+ * No formato compacto, cada vértice guarda apenas a coluna/linha na grade, a altura
+ * quantizada e a normal codificada em octaedro. No formato HeightTexture, apenas as
+ * alturas são calculadas (uma por vértice, mais uma borda de uma amostra).
  */
-chunk::MeshData chunk::generateMeshData(int cX, int cZ, int resolution, int chunkSize)
+chunk::MeshData chunk::generateMeshData(int cX, int cZ, int resolution, const WorldConfig& config,
+                                        const std::function<bool()>& isCancelled)
 {
+    const int chunkSize = config.chunkSize;
+    const bool heightTexture = config.heightTextureTerrain;
+    const bool compact = !heightTexture && config.compactTerrainVertices;
+
     MeshData data; // Cria uma estrutura MeshData para armazenar os resultados.
     data.chunkGridX = cX; // Armazena a coordenada X do chunk.
     data.chunkGridZ = cZ; // Armazena a coordenada Z do chunk.
     data.resolution = resolution; // Armazena a resolução utilizada.
+    data.format = heightTexture ? TerrainVertexFormat::HeightTexture
+                                : (compact ? TerrainVertexFormat::Compact : TerrainVertexFormat::Full);
 
     if (resolution <= 1) return data; // Retorna dados vazios se a resolução não for válida (mínimo 2x2 para triângulos).
 
-    // Reserva espaço nos vetores para otimizar alocações de memória.
-    data.vertices.reserve(static_cast<size_t>(resolution) * static_cast<size_t>(resolution));
-    data.indices.reserve(static_cast<size_t>(resolution - 1) * static_cast<size_t>(resolution - 1) * 6);
-
     // Calcula o tamanho do passo entre os vértices com base no tamanho do chunk e na resolução.
-    float step = static_cast<float>(chunkSize) / (resolution - 1);
+    const float step = static_cast<float>(chunkSize) / (resolution - 1);
+    data.gridStep = step;
+    const float baseX = static_cast<float>(cX * chunkSize); // Posição base do chunk no mundo.
+    const float baseZ = static_cast<float>(cZ * chunkSize);
+
+    // Amostragem das alturas:
+    // Cada altura é avaliada uma única vez, em uma grade com uma amostra de borda de cada lado
+    // ((resolution + 2)² valores). As normais saem por diferenças centrais desse buffer, em vez
+    // de quatro avaliações extras da função de altura por vértice.
+    // No formato HeightTexture, este buffer é o próprio resultado.
+    // Cada linha é avaliada de uma vez pelo kernel vetorizado de NoiseUtils (SSE/AVX2/NEON).
+    const int side = resolution + 2;
+    std::vector<float> borderedHeights;
+    std::vector<float>& heights = heightTexture ? data.heights : borderedHeights;
+    heights.resize(static_cast<size_t>(side) * static_cast<size_t>(side));
+    for (int r = -1; r <= resolution; ++r) {
+        // Abandona o trabalho se ele se tornou obsoleto (chunk reciclado ou LOD alterado).
+        if (isCancelled && isCancelled()) {
+            data.heights.clear();
+            return data;
+        }
+        NoiseUtils::getHeightRow(baseX - step, step, baseZ + r * step, side,
+                                 &heights[static_cast<size_t>(r + 1) * side]);
+    }
+
+    // Extensão em Y da caixa envolvente (culling por frustum). Inclui a borda, o que é
+    // conservador, e cobre as alturas de morphing, que são médias de alturas vizinhas.
+    // A margem de um passo de quantização cobre o arredondamento do formato compacto.
+    const auto heightRange = std::minmax_element(heights.begin(), heights.end());
+    data.minHeight = *heightRange.first - config.compactHeightStep;
+    data.maxHeight = *heightRange.second + config.compactHeightStep;
+    // No formato compacto, as alturas são quantizadas em relação ao meio da faixa do chunk, e não
+    // ao zero do mundo: o int16 cobre ±327 m em torno dele, em qualquer altitude do DEM. A base é
+    // múltipla do passo, então vértices da borda comum a dois chunks caem na mesma altura.
+    if (compact) {
+        data.heightBase = std::round(0.5f * (data.minHeight + data.maxHeight) / config.compactHeightStep)
+                          * config.compactHeightStep;
+    }
+
+    if (heightTexture) {
+        // Nada de normais nem de posições: o shader reconstrói X/Z e calcula as normais.
+        return data;
+    }
+
+    // Reserva espaço no vetor para otimizar alocações de memória.
+    const size_t vertexCount = static_cast<size_t>(resolution) * static_cast<size_t>(resolution);
+    if (compact) {
+        data.compactVertices.reserve(vertexCount);
+    } else {
+        data.vertices.reserve(vertexCount);
+    }
+
+    // Fator de quantização da altura no formato compacto.
+    const float invHeightStep = 1.0f / config.compactHeightStep;
+    const bool analyticNormals = config.analyticTerrainNormals;
+
+    // Relação entre esta resolução e a do próximo nível de LOD (1 no nível mais grosso:
+    // a altura de morphing é a própria altura).
+    const int coarserResolution = nextLodResolution(resolution, config);
+    const int morphRatio = coarserResolution > 1 ? (resolution - 1) / (coarserResolution - 1) : 1;
+    const int coarseCells = (resolution - 1) / morphRatio;
+    auto sampleAt = [&heights, side](int column, int row) {
+        return heights[static_cast<size_t>(row + 1) * side + (column + 1)];
+    };
 
     // Geração de Vértices:
     // Itera sobre cada ponto da grade para criar um vértice.
     for (int r = 0; r < resolution; ++r) { // Loop para as linhas (eixo Z local).
+        // Abandona o trabalho se ele se tornou obsoleto (chunk reciclado ou LOD alterado).
+        if (isCancelled && isCancelled()) {
+            data.vertices.clear();
+            data.compactVertices.clear();
+            return data;
+        }
+        // Linha atual e vizinhas no buffer com borda (deslocado de uma amostra em X e em Z).
+        const float* rowUp = &heights[static_cast<size_t>(r) * side];
+        const float* row = rowUp + side;
+        const float* rowDown = row + side;
+        // Célula do nível seguinte em que a linha cai e a posição dentro dela (0 a 1).
+        const int coarseRow = std::min(r / morphRatio, coarseCells - 1) * morphRatio;
+        const float fz = static_cast<float>(r - coarseRow) / morphRatio;
         for (int c = 0; c < resolution; ++c) { // Loop para as colunas (eixo X local).
             Vertex v; // Cria uma nova estrutura de vértice.
             float localX = c * step; // Calcula a coordenada X local do vértice dentro do chunk.
             float localZ = r * step; // Calcula a coordenada Z local do vértice dentro do chunk.
+            v.position = QVector3D(localX, row[c + 1], localZ);
 
-            // Calcula as coordenadas globais X e Z para a função de ruído.
-            // Soma a posição base do chunk no mundo (cX * chunkSize, cZ * chunkSize) com as coordenadas locais.
-            float noise_coord_x (static_cast<float>(cX * chunkSize) + localX);
-            float noise_coord_z (static_cast<float>(cZ * chunkSize) + localZ);
-            // Define a posição do vértice, obtendo a altura do terreno via NoiseUtils::getHeight.
-            v.position = QVector3D(localX, NoiseUtils::getHeight(noise_coord_x, noise_coord_z), localZ);
+            // Altura de morphing: onde este ponto cai na malha do nível seguinte (`morphRatio`
+            // vezes mais grossa). Os vértices nos múltiplos de `morphRatio` existem nos dois
+            // níveis; os demais ficam sobre um dos dois triângulos (divididos pela diagonal
+            // topRight-bottomLeft, a mesma dos índices) de um quadrado do nível mais grosso.
+            const int coarseColumn = std::min(c / morphRatio, coarseCells - 1) * morphRatio;
+            const float fx = static_cast<float>(c - coarseColumn) / morphRatio;
+            const float hTR = sampleAt(coarseColumn + morphRatio, coarseRow);
+            const float hBL = sampleAt(coarseColumn, coarseRow + morphRatio);
+            if (fx + fz <= 1.0f) {
+                const float hTL = sampleAt(coarseColumn, coarseRow);
+                v.morphHeight = hTL + (hTR - hTL) * fx + (hBL - hTL) * fz;
+            } else {
+                const float hBR = sampleAt(coarseColumn + morphRatio, coarseRow + morphRatio);
+                v.morphHeight = hBR + (hBL - hBR) * (1.0f - fx) + (hTR - hBR) * (1.0f - fz);
+            }
 
             // Lógica da normal:
-            // As normais são usadas para iluminação. São calculadas aproximando as mudanças de altura ao redor do vértice.
-            float offset_norm = 0.1f; // Pequeno offset para amostragem da altura ao redor do ponto.
-            // Amostra a altura em pontos ligeiramente deslocados para calcular as diferenças.
-            float hL = NoiseUtils::getHeight(noise_coord_x - offset_norm, noise_coord_z); // Altura à esquerda.
-            float hR = NoiseUtils::getHeight(noise_coord_x + offset_norm, noise_coord_z); // Altura à direita.
-            float hD = NoiseUtils::getHeight(noise_coord_x, noise_coord_z - offset_norm); // Altura para baixo (Z-).
-            float hU = NoiseUtils::getHeight(noise_coord_x, noise_coord_z + offset_norm); // Altura para cima (Z+).
-            // Calcula o vetor normal usando as diferenças de altura e normaliza para ter comprimento 1.
-            v.normal = QVector3D(hL - hR, 2.0f * offset_norm, hD - hU).normalized();
-
-            data.vertices.push_back(v); // Adiciona o vértice ao vetor de vértices da malha.
-        }
-    }
+            // As normais são usadas para iluminação. Por padrão, vêm das diferenças centrais
+            // entre os vizinhos na grade (esquerda/direita em X, baixo/cima em Z).
+            // No modo de alta precisão, usa as amostras deslocadas de 0.1 m de NoiseUtils::getNormal.
+            if (analyticNormals) {
+                v.normal = NoiseUtils::getNormal(baseX + localX, baseZ + localZ);
+            } else {
+                float hL = row[c];         // Altura à esquerda.
+                float hR = row[c + 2];     // Altura à direita.
+                float hD = rowUp[c + 1];   // Altura para baixo (Z-).
+                float hU = rowDown[c + 1]; // Altura para cima (Z+).
+                v.normal = QVector3D(hL - hR, 2.0f * step, hD - hU).normalized();
+            }
 
-    // Geração de Índices:
-    // Itera sobre cada "quadrado" formado por 4 vértices adjacentes na grade e o divide em dois triângulos.
-    // Cada quadrado [r][c] ... [r+1][c+1] forma dois triângulos.
-    for (int r = 0; r < resolution - 1; ++r) {
-        for (int c = 0; c < resolution - 1; ++c) {
-            // Calcula os índices dos 4 vértices que formam o quadrado atual.
-            GLuint topLeft = static_cast<GLuint>(r * resolution + c);
-            GLuint topRight = topLeft + 1;
-            GLuint bottomLeft = static_cast<GLuint>((r + 1) * resolution + c);
-            GLuint bottomRight = bottomLeft + 1;
-            // Adiciona os índices para o primeiro triângulo (superior esquerdo).
-            data.indices.push_back(topLeft);
-            data.indices.push_back(bottomLeft);
-            data.indices.push_back(topRight);
-            // Adiciona os índices para o segundo triângulo (inferior direito).
-            data.indices.push_back(topRight);
-            data.indices.push_back(bottomLeft);
-            data.indices.push_back(bottomRight);
+            if (compact) {
+                // Converte para o formato compacto: posição na grade, altura quantizada e normal em octaedro.
+                CompactVertex cv;
+                cv.column = static_cast<quint8>(c);
+                cv.row = static_cast<quint8>(r);
+                // Alturas relativas à base do chunk (ver MeshData::heightBase).
+                float quantizedHeight = std::clamp(std::round((v.position.y() - data.heightBase) * invHeightStep),
+                                                   -32767.0f, 32767.0f);
+                cv.height = static_cast<qint16>(quantizedHeight);
+                float quantizedMorph = std::clamp(std::round((v.morphHeight - data.heightBase) * invHeightStep),
+                                                  -32767.0f, 32767.0f);
+                cv.morphHeight = static_cast<qint16>(quantizedMorph);
+                encodeOctNormal(v.normal, cv.octNormal);
+                data.compactVertices.push_back(cv);
+            } else {
+                data.vertices.push_back(v); // Adiciona o vértice ao vetor de vértices da malha.
+            }
         }
     }
     return data; // Retorna a estrutura MeshData preenchida.
 }
 
 /**
- * @brief Faz o upload dos dados de malha (vértices e índices) para a GPU.
- * @param data A estrutura MeshData contendo os vértices e índices a serem enviados para a GPU.
+ * @brief Retorna a resolução do nível de LOD seguinte.
+ * @param resolution A resolução de um nível.
+ * @param config A configuração do mundo.
+ * @return A resolução do nível seguinte, ou 0 se não houver.
+ *
+ * O nível 1 é `lowRes` quando a grade de `highRes` se divide em uma grade de `lowRes`
+ * (o morphing exige que os vértices do nível grosso existam no fino); os demais têm metade
+ * da resolução do anterior, sem passar de `coarsestRes`.
+ */
+int chunk::nextLodResolution(int resolution, const WorldConfig& config)
+{
+    const int lowRes = config.lowRes;
+    if (resolution == config.highRes && lowRes >= 2 && lowRes < resolution && (resolution - 1) % (lowRes - 1) == 0) {
+        return lowRes;
+    }
+    const int half = (resolution - 1) / 2 + 1;
+    if ((resolution - 1) % 2 != 0 || half < std::max(3, config.coarsestRes)) {
+        return 0; // Sem potência de 2 + 1 não há como dividir a grade ao meio.
+    }
+    return half;
+}
+
+/**
+ * @brief Configura os ponteiros de atributo de vértice de um formato no VAO ligado.
  * @param glFuncs Ponteiro para as funções OpenGL.
+ * @param format O formato dos vértices do VBO ligado em GL_ARRAY_BUFFER (Full ou Compact).
+ *
+ * Usado pelo VAO de cada chunk e pelos VAOs das páginas do desenho em lote.
+ */
+void chunk::setupVertexAttributes(QOpenGLFunctions* glFuncs, TerrainVertexFormat format)
+{
+    if (format == TerrainVertexFormat::Compact) {
+        // Formato compacto: 8 bytes por vértice.
+        // Location 0: coluna/linha na grade (2 x uint8, lidos como float sem normalização).
+        glFuncs->glEnableVertexAttribArray(0);
+        glFuncs->glVertexAttribPointer(0, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, column));
+        // Location 1: normal em octaedro (2 x snorm8, normalizados para [-1, 1]).
+        glFuncs->glEnableVertexAttribArray(1);
+        glFuncs->glVertexAttribPointer(1, 2, GL_BYTE, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, octNormal));
+        // Location 2: altura quantizada (int16, sem normalização; o shader multiplica pelo passo de altura).
+        glFuncs->glEnableVertexAttribArray(2);
+        glFuncs->glVertexAttribPointer(2, 1, GL_SHORT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, height));
+        // Location 3: altura quantizada no próximo nível de LOD (alvo do morphing).
+        glFuncs->glEnableVertexAttribArray(3);
+        glFuncs->glVertexAttribPointer(3, 1, GL_SHORT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, morphHeight));
+    } else {
+        // Configura os ponteiros de atributo de vértice dentro do VAO:
+        // Ativa o atributo de posição (layout location 0 no shader).
+        glFuncs->glEnableVertexAttribArray(0);
+        // Define como os dados de posição são lidos do VBO: 3 floats, sem normalização, passo entre vértices, offset.
+        glFuncs->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+        // Ativa o atributo de normal (layout location 1 no shader).
+        glFuncs->glEnableVertexAttribArray(1);
+        // Define como os dados de normal são lidos do VBO.
+        glFuncs->glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+        // Ativa o atributo da altura de morphing (layout location 2 no shader).
+        glFuncs->glEnableVertexAttribArray(2);
+        glFuncs->glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, morphHeight));
+    }
+}
+
+/**
+ * @brief Faz o upload dos vértices da malha para a GPU.
+ * @param data A estrutura MeshData contendo os vértices a serem enviados para a GPU.
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ * @param indexBuffers Os buffers de índices compartilhados por resolução.
+ * @param bufferPool O pool de VBOs de terreno.
+ * @param batchBuffers As páginas do desenho em lote, ou nulo para o VBO próprio do chunk.
  *
  * Esta função DEVE ser chamada na thread que possui o contexto OpenGL ativo (geralmente a thread principal).
- * Ela cria e configura o VAO, VBO e EBO para o chunk, e copia os dados para a memória da GPU.
+ * Os objetos OpenGL do chunk não são recriados a cada upload: o VAO vive enquanto o chunk
+ * existir, e o VBO é reescrito no lugar (órfão + glBufferSubData) se o tamanho da malha não
+ * mudou, ou trocado por um VBO do pool com o tamanho da nova resolução. Os ponteiros de
+ * atributo e o vínculo com o EBO compartilhado só são refeitos quando o VBO ou a resolução mudam.
+ * No desenho em lote, os vértices vão para um slot novo de uma página de `batchBuffers`, e o
+ * slot anterior é aposentado (a GPU ainda pode estar desenhando o quadro anterior com ele).
  */
-void chunk::uploadMeshData(const chunk::MeshData& data, QOpenGLFunctions* glFuncs)
+void chunk::uploadMeshData(const chunk::MeshData& data, QOpenGLFunctions* glFuncs, TerrainIndexBuffers* indexBuffers,
+                           TerrainBufferPool* bufferPool, TerrainBatchBuffers* batchBuffers)
 {
-    // Retorna se o ponteiro para funções OpenGL é nulo ou se os dados de índice estão vazios.
-    if (!glFuncs || data.indices.empty()) {
+    // Retorna se o ponteiro para funções OpenGL é nulo ou se não há vértices.
+    if (!glFuncs || !indexBuffers || !bufferPool || data.vertexCount() == 0) {
+        return;
+    }
+
+    // Obtém (ou cria, na primeira vez) o buffer de índices compartilhado desta resolução.
+    QOpenGLBuffer* sharedEbo = indexBuffers->buffer(data.resolution);
+    if (!sharedEbo) {
+        return;
+    }
+
+    m_indexType = indexBuffers->indexType(); // Tipo dos índices compartilhados (16 ou 32 bits).
+    m_minHeight = data.minHeight; // Caixa envolvente da malha que vai para a GPU.
+    m_maxHeight = data.maxHeight;
+
+    if (data.format == TerrainVertexFormat::HeightTexture) {
+        uploadHeightTexture(data, sharedEbo);
         return;
     }
 
-    // Limpa os buffers antigos antes de criar os novos.
-    // std::unique_ptr::reset() libera o recurso apontado e define o ponteiro para nullptr.
-    m_vao.reset();
-    m_vbo.reset();
-    m_ebo.reset();
+    const bool compact = (data.format == TerrainVertexFormat::Compact);
+    const int vertexCount = data.vertexCount();
+    const int byteSize = vertexCount * static_cast<int>(compact ? sizeof(CompactVertex) : sizeof(Vertex));
+    const void* vertexData = compact ? static_cast<const void*>(data.compactVertices.data())
+                                     : static_cast<const void*>(data.vertices.data());
+    const bool resolutionChanged = (data.resolution != m_currentResolution);
+
+    if (batchBuffers) {
+        // Desenho em lote: o chunk não tem VAO nem VBO; o terrainmanager desenha a página.
+        TerrainBatchSlot slot = batchBuffers->write(data.resolution, vertexData, vertexCount, glFuncs);
+        if (!slot.isValid()) {
+            return;
+        }
+        batchBuffers->retire(m_batchSlot);
+        m_batchSlot = slot;
+    }
 
     m_currentResolution = data.resolution; // Atualiza a resolução atual do chunk.
-    m_indexCount = static_cast<int>(data.indices.size()); // Atualiza a contagem de índices.
-    m_vertexCount = static_cast<int>(data.vertices.size()); // Atualiza a contagem de vértices.
-
-    // Cria e configura os objetos OpenGL:
-    m_vao = std::make_unique<QOpenGLVertexArrayObject>(); // Cria um novo VAO.
-    m_vao->create(); // Aloca o VAO na GPU.
-    m_vao->bind();   // Ativa o VAO.
-
-    m_vbo = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer); // Cria um novo VBO (tipo VertexBuffer).
-    m_vbo->create(); // Aloca o VBO na GPU.
-    m_vbo->bind();   // Ativa o VBO.
-    // Aloca memória no VBO e copia os dados de vértice da CPU para a GPU.
-    m_vbo->allocate(data.vertices.data(), m_vertexCount * sizeof(Vertex));
-
-    // Configura os ponteiros de atributo de vértice dentro do VAO:
-    // Ativa o atributo de posição (layout location 0 no shader).
-    glFuncs->glEnableVertexAttribArray(0);
-    // Define como os dados de posição são lidos do VBO: 3 floats, sem normalização, passo entre vértices, offset.
-    glFuncs->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-    // Ativa o atributo de normal (layout location 1 no shader).
-    glFuncs->glEnableVertexAttribArray(1);
-    // Define como os dados de normal são lidos do VBO.
-    glFuncs->glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-    m_ebo = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::IndexBuffer); // Cria um novo EBO (tipo IndexBuffer).
-    m_ebo->create(); // Aloca o EBO na GPU.
-    m_ebo->bind();   // Ativa o EBO.
-    // Aloca memória no EBO e copia os dados de índice da CPU para a GPU.
-    m_ebo->allocate(data.indices.data(), m_indexCount * sizeof(GLuint));
-
-    m_vao->release(); // Libera o VAO (desvincula).
+    m_indexCount = TerrainIndexBuffers::indexCount(data.resolution); // Atualiza a contagem de índices.
+    m_vertexCount = vertexCount; // Atualiza a contagem de vértices.
+    m_format = data.format; // Atualiza o formato de vértice.
+    m_gridStep = data.gridStep; // Atualiza o passo da grade.
+    // A altura de referência da malha compacta entra no Y da matriz de modelo (no lote, na origem do slot).
+    m_heightBase = data.heightBase;
+    QVector4D translation = m_modelMatrix.column(3);
+    translation.setY(m_heightBase);
+    m_modelMatrix.setColumn(3, translation);
+    if (batchBuffers) {
+        return;
+    }
+
+    // O VAO é criado uma única vez e vive enquanto o chunk existir.
+    bool vaoNeedsSetup = resolutionChanged;
+    if (!m_vao) {
+        m_vao = std::make_unique<QOpenGLVertexArrayObject>(); // Cria o VAO persistente.
+        m_vao->create(); // Aloca o VAO na GPU.
+        vaoNeedsSetup = true;
+    }
+
+    if (m_vbo && m_vboSize == byteSize) {
+        // Mesmo tamanho (mesmo LOD): reaproveita o VBO. `allocate` sem dados órfã o armazenamento
+        // antigo (o driver não precisa esperar a GPU terminar de lê-lo) e `write` usa glBufferSubData.
+        m_vbo->bind();
+        m_vbo->allocate(byteSize);
+        m_vbo->write(0, vertexData, byteSize);
+    } else {
+        // Tamanho diferente (mudança de LOD): troca o VBO por um do pool com o tamanho certo.
+        bufferPool->release(std::move(m_vbo), m_vboSize);
+        m_vbo = bufferPool->acquire(byteSize);
+        m_vboSize = byteSize;
+        m_vbo->bind();
+        m_vbo->write(0, vertexData, byteSize);
+        vaoNeedsSetup = true; // Os ponteiros de atributo apontam para o VBO antigo.
+    }
+
+    if (vaoNeedsSetup) {
+        m_vao->bind(); // Ativa o VAO (o VBO continua ligado em GL_ARRAY_BUFFER).
+
+        setupVertexAttributes(glFuncs, data.format);
+
+        // Liga o EBO compartilhado ao VAO (o vínculo do GL_ELEMENT_ARRAY_BUFFER faz parte do estado do VAO).
+        sharedEbo->bind();
+
+        m_vao->release(); // Libera o VAO (desvincula).
+        sharedEbo->release(); // Desvincula o EBO depois do VAO, para não alterar o estado do VAO.
+    }
     m_vbo->release(); // Libera o VBO.
-    m_ebo->release(); // Libera o EBO.
+}
+
+/**
+ * @brief Faz o upload das alturas do formato HeightTexture.
+ * @param data A MeshData com as alturas ((resolution + 2)² valores).
+ * @param sharedEbo O buffer de índices compartilhado da resolução.
+ *
+ * Não há VBO: o VAO só guarda o vínculo com o EBO compartilhado, cujos índices são
+ * usados pelo shader como gl_VertexID. A textura só é recriada quando a resolução muda;
+ * caso contrário, apenas os dados são substituídos (glTexSubImage2D).
+ */
+void chunk::uploadHeightTexture(const MeshData& data, QOpenGLBuffer* sharedEbo)
+{
+    const int side = data.resolution + 2;
+    const bool resolutionChanged = (data.resolution != m_currentResolution) || !m_heightTexture;
+
+    m_vbo.reset(); // Nenhum VBO neste formato.
+    m_vboSize = 0;
+    m_currentResolution = data.resolution;
+    m_indexCount = TerrainIndexBuffers::indexCount(data.resolution);
+    m_vertexCount = data.vertexCount();
+    m_format = data.format;
+    m_gridStep = data.gridStep;
+
+    if (!m_vao) {
+        m_vao = std::make_unique<QOpenGLVertexArrayObject>();
+        m_vao->create();
+    }
+    if (resolutionChanged) {
+        // Religa o VAO ao EBO compartilhado da nova resolução.
+        m_vao->bind();
+        sharedEbo->bind();
+        m_vao->release();
+        sharedEbo->release();
+
+        // Recria a textura com o novo tamanho. R32F não é filtrável no GLES 3.0,
+        // mas o shader só usa texelFetch, então o filtro é irrelevante.
+        m_heightTexture = std::make_unique<QOpenGLTexture>(QOpenGLTexture::Target2D);
+        m_heightTexture->setFormat(QOpenGLTexture::R32F);
+        m_heightTexture->setSize(side, side);
+        m_heightTexture->setMipLevels(1);
+        m_heightTexture->setMinMagFilters(QOpenGLTexture::Nearest, QOpenGLTexture::Nearest);
+        m_heightTexture->setWrapMode(QOpenGLTexture::ClampToEdge);
+        m_heightTexture->allocateStorage(QOpenGLTexture::Red, QOpenGLTexture::Float32);
+    }
+    // Substitui as alturas (glTexSubImage2D).
+    m_heightTexture->setData(QOpenGLTexture::Red, QOpenGLTexture::Float32, data.heights.data());
 }
 
 /**
@@ -260,43 +590,96 @@ QVector3D chunk::getCenterPosition(int chunkSize) const {
 }
 
 /**
- * @brief Armazena os dados de malha recebidos de uma thread de worker.
+ * @brief Assume os dados de malha recebidos de uma thread de worker.
  * @param data A estrutura MeshData contendo os dados gerados pela thread de worker.
  *
- * Marca o chunk como tendo uma malha pendente, que será uploaded na GPU
- * na próxima chamada a `render` (quando o contexto OpenGL estiver ativo).
+ * Os vetores são movidos, não copiados: a thread principal nunca copia vértices.
+ * Marca o chunk como tendo uma malha pendente, que será enviada para a GPU
+ * pela fila de uploads do terrainmanager (com o contexto OpenGL ativo).
  */
-void chunk::setPendingMeshData(const MeshData& data) {
-    m_pendingMeshData = data; // Copia os dados da malha gerada para o membro m_pendingMeshData.
+void chunk::setPendingMeshData(MeshData&& data) {
+    m_pendingMeshData = std::move(data); // Move os dados da malha gerada para o membro m_pendingMeshData.
     m_hasPendingMesh = true; // Define a flag para indicar que há uma malha pendente para upload.
 }
 
+/**
+ * @brief Descarta a malha pendente sem enviá-la para a GPU.
+ *
+ * Usado para malhas obsoletas: o chunk continua desenhando a malha que já está na GPU até a
+ * malha do pedido mais recente chegar.
+ */
+void chunk::discardPendingMesh() {
+    m_pendingMeshData = {};
+    m_hasPendingMesh = false;
+}
+
+/**
+ * @brief Avança o token de geração do chunk.
+ * @return O novo valor do token.
+ *
+ * Qualquer worker que ainda carregue o valor anterior passa a ser obsoleto:
+ * ele abandona a geração na próxima verificação e seu resultado é descartado.
+ */
+quint32 chunk::advanceGeneration() {
+    return m_generation->fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+/**
+ * @brief Envia a malha pendente para a GPU.
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ * @param indexBuffers Os buffers de índices compartilhados por resolução.
+ * @param bufferPool O pool de VBOs de terreno.
+ * @param batchBuffers As páginas do desenho em lote, ou nulo para o VBO próprio do chunk.
+ * @param uploadedMesh Se não for nulo, recebe a malha enviada em vez de ela ser descartada.
+ * @return Quantos bytes foram enviados.
+ */
+int chunk::uploadPendingMesh(QOpenGLFunctions* glFuncs, TerrainIndexBuffers* indexBuffers, TerrainBufferPool* bufferPool,
+                             TerrainBatchBuffers* batchBuffers, MeshData* uploadedMesh) {
+    if (!m_hasPendingMesh) {
+        return 0;
+    }
+    int bytes = m_pendingMeshData.byteSize();
+    uploadMeshData(m_pendingMeshData, glFuncs, indexBuffers, bufferPool, batchBuffers); // Chama uploadMeshData para enviar os dados para a GPU.
+    if (uploadedMesh) {
+        *uploadedMesh = std::move(m_pendingMeshData); // Entrega a malha a quem chamou (cache de malhas).
+    }
+    m_pendingMeshData = {}; // Limpa os dados da CPU após o upload para economizar memória.
+    m_hasPendingMesh = false; // Reseta a flag de malha pendente.
+    return bytes;
+}
+
 /**
  * @brief Renderiza o chunk na tela.
  * @param terrainShaderProgram O programa de shader de terreno a ser usado.
  * @param glFuncs Ponteiro para as funções OpenGL.
  *
- * Se houver uma malha pendente (gerada em outra thread), esta função faz o upload
- * dos dados para a GPU. Em seguida, ativa o shader de terreno, define a matriz de modelo
- * do chunk e desenha a malha usando os índices.
+ * Ativa o VAO do chunk, define a matriz de modelo e desenha a malha usando os índices.
+ * Uma malha pendente não é enviada aqui: o chunk desenha a malha que já está na GPU
+ * até a fila de uploads do terrainmanager chegar nele.
  */
 void chunk::render(QOpenGLShaderProgram* terrainShaderProgram, QOpenGLFunctions *glFuncs) {
-    // Se há uma malha pendente, faça o upload agora, com o contexto ativo.
-    if (m_hasPendingMesh) {
-        uploadMeshData(m_pendingMeshData, glFuncs); // Chama uploadMeshData para enviar os dados para a GPU.
-        m_pendingMeshData = {}; // Limpa os dados da CPU após o upload para economizar memória.
-        m_hasPendingMesh = false; // Reseta a flag de malha pendente.
-    }
-
     // Retorna se não há índices para desenhar ou se o VAO não foi criado corretamente.
     if (m_indexCount == 0 || !m_vao || !m_vao->isCreated()) { return; }
 
     // Define a matriz de modelo do chunk no shader de terreno.
     terrainShaderProgram->setUniformValue("modelMatrix", m_modelMatrix);
+    if (m_format == TerrainVertexFormat::Compact) {
+        // O shader compacto reconstrói X/Z locais a partir da coluna/linha e do passo da grade.
+        terrainShaderProgram->setUniformValue("gridStep", m_gridStep);
+    } else if (m_format == TerrainVertexFormat::HeightTexture) {
+        // O shader de heightmap reconstrói a grade a partir de gl_VertexID e lê as alturas da textura.
+        if (!m_heightTexture) { return; }
+        terrainShaderProgram->setUniformValue("gridStep", m_gridStep);
+        terrainShaderProgram->setUniformValue("gridResolution", m_currentResolution);
+        m_heightTexture->bind(0); // Unidade de textura 0 (sampler "heightMap").
+    }
     m_vao->bind(); // Ativa o VAO do chunk.
-    // Desenha os triângulos usando os índices do EBO.
-    glFuncs->glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, nullptr);
+    // Desenha os triângulos usando os índices do EBO compartilhado da resolução.
+    glFuncs->glDrawElements(GL_TRIANGLES, m_indexCount, m_indexType, nullptr);
     m_vao->release(); // Libera o VAO.
+    if (m_format == TerrainVertexFormat::HeightTexture) {
+        m_heightTexture->release(0);
+    }
 }
 
 
@@ -305,11 +688,14 @@ void chunk::render(QOpenGLShaderProgram* terrainShaderProgram, QOpenGLFunctions
  * @param cX Nova coordenada X do chunk na grade.
  * @param cZ Nova coordenada Z do chunk na grade.
  * @param chunkSize O tamanho do chunk.
+ * @param batchBuffers Buffers do desenho em lote (nulo fora do modo em lote).
  *
  * Atualiza as coordenadas de grade do chunk e recalcula sua matriz de modelo
- * para refletir a nova posição no mundo.
+ * para refletir a nova posição no mundo. O estado de desenho da malha anterior é
+ * descartado: ela foi gerada para outra coordenada e não pode ser desenhada nem
+ * usada no culling (alturas) na nova posição.
  */
-void chunk::recycle(int cX,int cZ, int chunkSize) {
+void chunk::recycle(int cX,int cZ, int chunkSize, TerrainBatchBuffers* batchBuffers) {
     // Esta função reutiliza o chunk em uma nova posição.
     m_chunkGridX = cX; // Atualiza a coordenada X da grade.
     m_chunkGridZ = cZ; // Atualiza a coordenada Z da grade.
@@ -318,4 +704,18 @@ void chunk::recycle(int cX,int cZ, int chunkSize) {
     float worldZ = static_cast<float>(m_chunkGridZ * chunkSize);
     m_modelMatrix.setToIdentity(); // Reseta a matriz de modelo para identidade.
     m_modelMatrix.translate(worldX, 0.0f, worldZ); // Traduz a matriz de modelo para a nova posição no mundo.
+    // Uma malha pendente gerada para a coordenada anterior não vale mais nesta posição.
+    m_pendingMeshData = {};
+    m_hasPendingMesh = false;
+    // Sem malha até a nova subir: `render` ignora o chunk e o slot do lote é liberado.
+    // A resolução atual fica, pois descreve o VAO/VBO/textura que serão reaproveitados.
+    m_indexCount = 0;
+    m_vertexCount = 0;
+    m_minHeight = 0.0f;
+    m_maxHeight = 0.0f;
+    m_heightBase = 0.0f; // A matriz de modelo acima já está com Y = 0.
+    if (batchBuffers) {
+        batchBuffers->retire(m_batchSlot);
+    }
+    m_batchSlot = TerrainBatchSlot();
 }
@@ -4,15 +4,23 @@
 #include <QVector3D>          // Para representar vértices e normais 3D.
 #include <QOpenGLBuffer>      // Para gerenciar buffers de vértices e índices na GPU.
 #include <QOpenGLVertexArrayObject> // Para gerenciar Vertex Array Objects (VAOs).
+#include <QOpenGLTexture>     // Para a textura de alturas do modo de renderização por heightmap.
 #include <QOpenGLShaderProgram> // Para gerenciar programas de shader OpenGL.
 #include <QOpenGLExtraFunctions> // Para acesso a funções OpenGL que podem não estar no perfil principal (Ex: glDrawElementsBaseVertex).
 #include <QMatrix4x4>         // Para a matriz de modelo do chunk.
 #include <vector>             // Para armazenar os dados de vértices e índices.
 #include <utility>            // Para std::move (semântica de movimento).
 #include <memory>             // Para std::unique_ptr (gerenciamento de memória de objetos OpenGL).
+#include <atomic>             // Para std::atomic (token de geração compartilhado com as threads de worker).
+#include <functional>         // Para std::function (verificação de cancelamento durante a geração da malha).
+#include "terrainbatchbuffers.h" // Para TerrainBatchSlot (posição da malha no desenho em lote).
 #include <QTimer>             // Incluído mas não utilizado diretamente no chunk.h. Pode ser resquício ou para futura expansão.
 #include <QKeyEvent>          // Incluído mas não utilizado diretamente no chunk.h. Pode ser resquício ou para futura expansão.
 
+class TerrainIndexBuffers;    // Declaração antecipada: buffers de índices compartilhados por resolução.
+class TerrainBufferPool;      // Declaração antecipada: pool de VBOs reaproveitados entre chunks.
+struct WorldConfig;           // Declaração antecipada: parâmetros do mundo usados na geração da malha.
+
 // Estrutura: Vertex
 // Descrição: Define a estrutura de um único vértice para o terreno.
 //            Contém a posição 3D do vértice e seu vetor normal para iluminação.
@@ -27,18 +35,71 @@ struct Vertex {
     // Tipo: QVector3D
     // Descrição: O vetor normal da superfície neste vértice. Usado para cálculos de iluminação.
     QVector3D normal;
+
+    // Membro: morphHeight
+    // Tipo: float
+    // Descrição: Altura deste ponto na malha do próximo nível de LOD (metade da resolução):
+    //            a própria altura nos vértices que também existem no nível mais grosso, e a
+    //            interpolação ao longo da aresta (ou da diagonal) do nível mais grosso nos demais.
+    //            O shader desloca o vértice até ela conforme a distância à câmera (morphing).
+    float morphHeight;
+};
+
+// Estrutura: CompactVertex
+// Descrição: Formato compacto (8 bytes, contra 28 de `Vertex`) usado quando
+//            `WorldConfig::compactTerrainVertices` está ativo. As coordenadas X/Z locais
+//            não são armazenadas como float: vêm da posição do vértice na grade
+//            (coluna/linha) multiplicada pelo passo da grade, no shader.
+//            As alturas (no nível do chunk e no próximo, para o morphing) são quantizadas em
+//            int16 e a normal é codificada em octaedro com 8 bits por componente (erro máximo
+//            de ~1 grau, abaixo do que se percebe na iluminação difusa do terreno).
+struct CompactVertex {
+
+    // Membro: column / row
+    // Tipo: quint8
+    // Descrição: Coluna (X local) e linha (Z local) do vértice na grade do chunk (resolução máxima 256).
+    quint8 column;
+    quint8 row;
+
+    // Membro: height
+    // Tipo: qint16
+    // Descrição: Altura quantizada, relativa à altura de referência do chunk
+    //            (MeshData::heightBase): a altura em metros é heightBase + height * WorldConfig::compactHeightStep.
+    qint16 height;
+
+    // Membro: morphHeight
+    // Tipo: qint16
+    // Descrição: Altura quantizada no próximo nível de LOD (ver `Vertex::morphHeight`).
+    qint16 morphHeight;
+
+    // Membro: octNormal
+    // Tipo: qint8[2]
+    // Descrição: Normal codificada em octaedro, como snorm8 (lida normalizada em [-1, 1] no shader).
+    qint8 octNormal[2];
+};
+static_assert(sizeof(CompactVertex) == 8, "CompactVertex deve ocupar 8 bytes (stride do VBO).");
+
+// Enumeração: TerrainVertexFormat
+// Descrição: O formato de vértice da malha de um chunk.
+enum class TerrainVertexFormat {
+    Full,    // `Vertex`: posição, normal e altura de morphing em float (28 bytes), índices GLuint.
+    Compact, // `CompactVertex`: grade + alturas int16 + normal em octaedro (8 bytes), índices GLushort.
+    HeightTexture // Sem VBO: só uma textura de alturas; o shader reconstrói X/Z por gl_VertexID
+                  // e as normais por amostras vizinhas da textura.
 };
 
 // Classe: chunk
 // Descrição: Representa um pedaço (chunk) do terreno 3D. Cada chunk gerencia sua própria
-//            geometria (vértices e índices), Nível de Detalhe (LOD) e estado de renderização.
+//            geometria (vértices), Nível de Detalhe (LOD) e estado de renderização.
+//            Os índices não pertencem ao chunk: todos os chunks de uma mesma resolução
+//            compartilham um único buffer de índices (veja TerrainIndexBuffers).
 //            Ele é responsável por gerar seus próprios dados de malha na CPU e fazer o upload
 //            para a GPU quando necessário.
 class chunk {
 public:
     // Estrutura: MeshData
     // Descrição: Uma estrutura de dados para empacotar e transportar os dados de malha
-    //            (vértices e índices) entre threads, especificamente da thread de worker
+    //            (vértices) entre threads, especificamente da thread de worker
     //            para a thread principal para upload na GPU.
     struct MeshData {
 
@@ -54,21 +115,107 @@ public:
 
         // Membro: vertices
         // Tipo: std::vector<Vertex>
-        // Descrição: Um vetor contendo todos os vértices da malha para este chunk.
+        // Descrição: Um vetor contendo todos os vértices da malha para este chunk (formato Full).
         std::vector<Vertex> vertices;
 
-        // Membro: indices
-        // Tipo: std::vector<GLuint>
-        // Descrição: Um vetor contendo os índices que definem a ordem de desenho dos vértices
-        //            para formar triângulos.
-        std::vector<GLuint> indices;
+        // Membro: compactVertices
+        // Tipo: std::vector<CompactVertex>
+        // Descrição: Os vértices da malha no formato compacto (formato Compact).
+        std::vector<CompactVertex> compactVertices;
+
+        // Membro: heights
+        // Tipo: std::vector<float>
+        // Descrição: As alturas da malha (formato HeightTexture), linha por linha, com uma
+        //            amostra de borda de cada lado: (resolution + 2)² valores. A borda permite
+        //            calcular as normais dos vértices da beirada do chunk no shader.
+        std::vector<float> heights;
+
+        // Membro: format
+        // Tipo: TerrainVertexFormat
+        // Descrição: Qual dos vetores de vértices está preenchido.
+        TerrainVertexFormat format = TerrainVertexFormat::Full;
+
+        // Membro: gridStep
+        // Tipo: float
+        // Descrição: Distância entre vértices vizinhos da grade (chunkSize / (resolution - 1)).
+        //            Usada pelo shader do formato compacto para reconstruir X/Z locais.
+        float gridStep = 0.0f;
+
+        // Membro: minHeight / maxHeight
+        // Tipo: float
+        // Descrição: Menor e maior altura da malha (incluindo as alturas de morphing e a borda),
+        //            que definem a extensão em Y da caixa envolvente do chunk (culling por frustum).
+        float minHeight = 0.0f;
+        float maxHeight = 0.0f;
+
+        // Membro: heightBase
+        // Tipo: float
+        // Descrição: Altura de referência do formato compacto, múltipla de compactHeightStep: as
+        //            alturas quantizadas são relativas a ela, para que o int16 cubra o relevo do
+        //            chunk em qualquer altitude (o DEM guarda altitudes absolutas). 0 nos outros formatos.
+        float heightBase = 0.0f;
 
         // Membro: resolution
         // Tipo: int
         // Descrição: A resolução atual com a qual a malha foi gerada (número de vértices por lado).
         int resolution;
+
+        // Membro: generation
+        // Tipo: quint32
+        // Descrição: O token de geração do chunk no momento em que o trabalho foi pedido.
+        //            Resultados cujo token não é mais o atual do chunk são descartados.
+        quint32 generation = 0;
+
+        // Membro: requestedAtUs
+        // Tipo: qint64
+        // Descrição: Instante (TerrainCompletionQueue::timestampUs) em que a malha foi pedida.
+        qint64 requestedAtUs = 0;
+
+        // Membro: readyAtUs
+        // Tipo: qint64
+        // Descrição: Instante em que o worker terminou a malha e a colocou na fila de conclusão.
+        qint64 readyAtUs = 0;
+
+        // Método: vertexCount
+        // Descrição: Retorna o número de vértices da malha, em qualquer formato.
+        // Retorno: int - Quantidade de vértices.
+        int vertexCount() const {
+            switch (format) {
+            case TerrainVertexFormat::Compact:
+                return static_cast<int>(compactVertices.size());
+            case TerrainVertexFormat::HeightTexture:
+                return heights.empty() ? 0 : resolution * resolution;
+            default:
+                return static_cast<int>(vertices.size());
+            }
+        }
+
+        // Método: byteSize
+        // Descrição: Retorna o tamanho, em bytes, dos dados que serão enviados para a GPU.
+        // Retorno: int - Bytes de vértices (ou de alturas, no formato HeightTexture).
+        int byteSize() const {
+            switch (format) {
+            case TerrainVertexFormat::Compact:
+                return static_cast<int>(compactVertices.size() * sizeof(CompactVertex));
+            case TerrainVertexFormat::HeightTexture:
+                return static_cast<int>(heights.size() * sizeof(float));
+            default:
+                return static_cast<int>(vertices.size() * sizeof(Vertex));
+            }
+        }
     };
 
+    // Tipo: MeshDataPtr
+    // Descrição: Posse única de uma MeshData. A malha gerada por um worker é movida por este
+    //            ponteiro até o chunk, sem nenhuma cópia dos vetores de vértices.
+    using MeshDataPtr = std::unique_ptr<MeshData>;
+
+    // Tipo: GenerationToken
+    // Descrição: Contador de geração compartilhado entre o chunk e os workers que geram
+    //            sua malha. Cada novo pedido de malha avança o contador; um worker cujo
+    //            valor esperado não bate mais com o atual sabe que seu trabalho é obsoleto.
+    using GenerationToken = std::shared_ptr<std::atomic<quint32>>;
+
     // Construtor padrão: chunk
     // Descrição: Inicializa os membros do chunk com valores padrão.
     chunk();
@@ -81,7 +228,7 @@ public:
 
     // Construtor de Movimento: chunk(chunk&& other)
     // Descrição: Permite que objetos `chunk` sejam movidos de forma eficiente, transferindo
-    //            a propriedade dos recursos OpenGL (VAO, VBO, EBO) de um objeto temporário
+    //            a propriedade dos recursos OpenGL (VAO, VBO) de um objeto temporário
     //            ou expirado para um novo, evitando cópias desnecessárias e caras.
     // Parâmetros:
     //   - other: O objeto `chunk` do qual os recursos serão movidos.
@@ -109,36 +256,115 @@ public:
     // Descrição: Reutiliza um objeto chunk existente, redefinindo suas coordenadas de grade
     //            e matriz de modelo. Isso é usado para otimizar a criação de chunks,
     //            evitando alocações e liberações desnecessárias.
+    //            A malha da coordenada anterior deixa de ser desenhada (indexCount() passa a 0
+    //            e o slot do lote é aposentado) até a malha da nova coordenada subir; o VAO,
+    //            o VBO e a textura continuam alocados para serem reaproveitados.
     // Parâmetros:
     //   - cX: Nova coordenada X do chunk na grade.
     //   - cZ: Nova coordenada Z do chunk na grade.
     //   - chunkSize: O tamanho do chunk, usado para calcular a posição no mundo.
-    void recycle(int cX, int cZ, int chunkSize);
+    //   - batchBuffers: Buffers do desenho em lote, onde o slot é aposentado (nulo fora do modo em lote).
+    void recycle(int cX, int cZ, int chunkSize, TerrainBatchBuffers* batchBuffers);
 
     // Método Estático: generateMeshData
-    // Descrição: Uma função estática que gera os dados de vértices e índices para a malha de um chunk.
+    // Descrição: Uma função estática que gera os vértices da malha de um chunk (os índices
+    //            vêm do buffer compartilhado da resolução).
     //            Esta é uma operação que consome CPU e é projetada para ser executada em uma
     //            thread de worker para não bloquear a thread principal da UI/renderização.
     // Parâmetros:
     //   - cX: Coordenada X do chunk na grade.
     //   - cZ: Coordenada Z do chunk na grade.
     //   - resolution: A resolução da malha a ser gerada (número de vértices por lado).
-    //   - chunkSize: O tamanho do chunk, usado para calcular posições no mundo.
-    // Retorno: MeshData - Uma estrutura contendo os dados de vértices e índices gerados.
-    static MeshData generateMeshData(int cX, int cZ, int resolution, int chunkSize);
+    //   - config: A configuração do mundo (tamanho do chunk e formato de vértice).
+    //   - isCancelled: Função opcional consultada a cada linha da grade. Se retornar true,
+    //                  a geração é interrompida e a MeshData retornada fica vazia.
+    // Retorno: MeshData - Uma estrutura contendo os vértices gerados, no formato da configuração.
+    static MeshData generateMeshData(int cX, int cZ, int resolution, const WorldConfig& config,
+                                     const std::function<bool()>& isCancelled = {});
+
+    // Método Estático: nextLodResolution
+    // Descrição: Retorna a resolução do nível de LOD seguinte (mais grosso) a uma resolução:
+    //            de 'highRes' para 'lowRes' e, daí em diante, a metade até 'coarsestRes'. Define
+    //            os níveis montados pelo terrainmanager e o alvo do morphing de cada malha.
+    // Parâmetros:
+    //   - resolution: A resolução de um nível (vértices por lado).
+    //   - config: A configuração do mundo.
+    // Retorno: int - A resolução do nível seguinte, ou 0 se `resolution` for o nível mais grosso.
+    static int nextLodResolution(int resolution, const WorldConfig& config);
 
     // Método: uploadMeshData
-    // Descrição: Faz o upload dos dados de malha (vértices e índices) para a GPU,
-    //            criando e configurando os VAOs, VBOs e EBOs. Esta função DEVE
+    // Descrição: Faz o upload dos vértices para a GPU e liga ao VAO o buffer de índices
+    //            compartilhado da resolução. O VAO é persistente; o VBO é reescrito no lugar
+    //            quando o tamanho não muda, ou trocado por um do pool quando o LOD muda.
+    //            No formato HeightTexture, apenas a textura de alturas é atualizada (glTexSubImage2D). Esta função DEVE
     //            ser chamada na thread que possui o contexto OpenGL ativo (geralmente a thread principal).
     // Parâmetros:
-    //   - data: A estrutura MeshData contendo os vértices e índices a serem enviados para a GPU.
+    //   - data: A estrutura MeshData contendo os vértices a serem enviados para a GPU.
+    //   - glFuncs: Ponteiro para as funções OpenGL.
+    //   - indexBuffers: Os buffers de índices compartilhados por resolução.
+    //   - bufferPool: O pool de VBOs de terreno.
+    //   - batchBuffers: As páginas do desenho em lote (WorldConfig::batchedTerrainDraws). Se não
+    //                   for nulo, os vértices vão para um slot de página em vez do VBO do chunk.
+    void uploadMeshData(const MeshData& data, QOpenGLFunctions* glFuncs, TerrainIndexBuffers* indexBuffers,
+                        TerrainBufferPool* bufferPool, TerrainBatchBuffers* batchBuffers = nullptr);
+
+    // Método: uploadPendingMesh
+    // Descrição: Envia para a GPU a malha pendente (se houver) e descarta a cópia da CPU,
+    //            ou a entrega a quem chamou (para o cache de malhas).
+    //            Chamado pela fila de uploads do `terrainmanager`, dentro do orçamento do quadro.
+    // Parâmetros:
     //   - glFuncs: Ponteiro para as funções OpenGL.
-    void uploadMeshData(const MeshData& data, QOpenGLFunctions* glFuncs);
+    //   - indexBuffers: Os buffers de índices compartilhados por resolução.
+    //   - bufferPool: O pool de VBOs de terreno.
+    //   - batchBuffers: As páginas do desenho em lote, ou nulo (ver `uploadMeshData`).
+    //   - uploadedMesh: Se não for nulo, recebe (por movimento) a malha enviada.
+    // Retorno: int - Quantos bytes foram enviados (0 se não havia malha pendente).
+    int uploadPendingMesh(QOpenGLFunctions* glFuncs, TerrainIndexBuffers* indexBuffers, TerrainBufferPool* bufferPool,
+                          TerrainBatchBuffers* batchBuffers, MeshData* uploadedMesh = nullptr);
+
+    // Método: hasPendingMesh
+    // Descrição: Indica se há uma malha gerada esperando o upload para a GPU.
+    // Retorno: bool - true se há malha pendente.
+    bool hasPendingMesh() const { return m_hasPendingMesh; }
+
+    // Método: pendingMeshBytes
+    // Descrição: Retorna o tamanho, em bytes, do upload da malha pendente.
+    // Retorno: int - Bytes a enviar (0 se não há malha pendente).
+    int pendingMeshBytes() const { return m_hasPendingMesh ? m_pendingMeshData.byteSize() : 0; }
+
+    // Método: pendingMeshReadyAtUs
+    // Descrição: Retorna o instante em que a malha pendente ficou pronta no worker (métrica de latência).
+    // Retorno: qint64 - Microssegundos, ou 0 se não há malha pendente.
+    qint64 pendingMeshReadyAtUs() const { return m_hasPendingMesh ? m_pendingMeshData.readyAtUs : 0; }
+
+    // Método: isPendingMeshStale
+    // Descrição: Indica se a malha pendente foi pedida antes do último avanço do token de geração
+    //            (outro pedido de malha a substituiu, por exemplo após uma mudança de altura).
+    // Retorno: bool - true se há malha pendente e ela não é a do pedido mais recente.
+    bool isPendingMeshStale() const { return m_hasPendingMesh && m_pendingMeshData.generation != generation(); }
+
+    // Método: discardPendingMesh
+    // Descrição: Descarta a malha pendente sem enviá-la para a GPU.
+    void discardPendingMesh();
+
+    // Método Estático: setupVertexAttributes
+    // Descrição: Configura, no VAO ligado, os ponteiros de atributo do formato de vértice
+    //            (Full ou Compact) para o VBO ligado em GL_ARRAY_BUFFER.
+    // Parâmetros:
+    //   - glFuncs: Ponteiro para as funções OpenGL.
+    //   - format: O formato dos vértices.
+    static void setupVertexAttributes(QOpenGLFunctions* glFuncs, TerrainVertexFormat format);
+
+    // Método: batchSlot
+    // Descrição: Retorna onde está a malha do chunk no desenho em lote.
+    // Retorno: const TerrainBatchSlot& - O slot (inválido fora do desenho em lote ou sem malha).
+    const TerrainBatchSlot& batchSlot() const { return m_batchSlot; }
 
     // Método: render
     // Descrição: Desenha o chunk na tela usando o shader de terreno fornecido.
-    //            Antes de desenhar, verifica se há dados de malha pendentes para upload.
+    //            No desenho em lote, o chunk não é desenhado aqui, e sim pela página do seu slot.
+    //            O upload de malhas novas é feito antes, pela fila de uploads do `terrainmanager`;
+    //            enquanto a nova malha não sobe, o chunk continua desenhando a anterior.
     // Parâmetros:
     //   - terrainShaderProgram: O programa de shader OpenGL a ser usado para renderizar o terreno.
     //   - glFuncs: Ponteiro para as funções OpenGL.
@@ -146,9 +372,9 @@ public:
 
     // Método: setLOD
     // Descrição: Define o Nível de Detalhe (LOD) atual para o chunk.
-    //            Um LOD menor geralmente significa maior resolução.
+    //            O nível 0 é o de maior resolução; cada nível seguinte tem metade da resolução.
     // Parâmetros:
-    //   - lodLevel: O nível de LOD a ser definido (e.g., 0 para alta resolução, 1 para baixa).
+    //   - lodLevel: O nível de LOD a ser definido (0 a terrainmanager::lodLevelCount() - 1).
     void setLOD(int lodLevel);
 
     // Método: getLOD
@@ -179,14 +405,61 @@ public:
     // Retorno: int - Coordenada Z.
     int chunkGridZ() const { return m_chunkGridZ; }
 
+    // Método: currentResolution
+    // Descrição: Retorna a resolução da malha que está na GPU (pode diferir do LOD atual
+    //            enquanto a malha do novo nível não chega).
+    // Retorno: int - Vértices por lado, ou 0 se ainda não há malha.
+    int currentResolution() const { return m_currentResolution; }
+
+    // Método: minHeight / maxHeight
+    // Descrição: Extensão em Y da malha que está na GPU (caixa envolvente para o culling).
+    //            Só é válida se `currentResolution()` for maior que zero.
+    // Retorno: float - Menor / maior altura da malha, em metros.
+    float minHeight() const { return m_minHeight; }
+    float maxHeight() const { return m_maxHeight; }
+
+    // Método: heightBase
+    // Descrição: Retorna a altura de referência da malha atual (0 fora do formato compacto).
+    float heightBase() const { return m_heightBase; }
+
+    // Método: indexCount
+    // Descrição: Retorna quantos índices são desenhados por `render` (3 por triângulo).
+    // Retorno: int - O número de índices da malha na GPU.
+    int indexCount() const { return m_indexCount; }
+
     // Método: setPendingMeshData
-    // Descrição: Armazena os dados de malha recebidos de uma thread de worker.
-    //            Esses dados serão enviados para a GPU na próxima chamada a `render`.
+    // Descrição: Assume os dados de malha recebidos de uma thread de worker (por movimento,
+    //            sem copiar os vértices). Esses dados serão enviados para a GPU por `uploadPendingMesh`.
     // Parâmetros:
     //   - data: A estrutura MeshData contendo os dados gerados pela thread de worker.
-    void setPendingMeshData(const MeshData& data);
+    void setPendingMeshData(MeshData&& data);
+
+    // Método: advanceGeneration
+    // Descrição: Avança o token de geração do chunk, tornando obsoletos todos os trabalhos
+    //            de malha em andamento ou na fila para ele. Chamado a cada novo pedido de malha
+    //            (reciclagem ou mudança de LOD).
+    // Retorno: quint32 - O novo valor do token, que deve acompanhar o novo trabalho.
+    quint32 advanceGeneration();
+
+    // Método: generation
+    // Descrição: Retorna o valor atual do token de geração do chunk.
+    // Retorno: quint32 - O token atual.
+    quint32 generation() const { return m_generation->load(std::memory_order_acquire); }
+
+    // Método: generationToken
+    // Descrição: Retorna o contador de geração compartilhado, para que um worker possa
+    //            verificar, de outra thread, se o seu trabalho ainda é o mais recente.
+    // Retorno: GenerationToken - Ponteiro compartilhado para o contador.
+    GenerationToken generationToken() const { return m_generation; }
 
 private:
+    // Método Privado: uploadHeightTexture
+    // Descrição: Upload do formato HeightTexture: atualiza a textura de alturas e liga o VAO
+    //            (sem atributos) ao buffer de índices compartilhado.
+    // Parâmetros:
+    //   - data: A MeshData com as alturas.
+    //   - sharedEbo: O buffer de índices compartilhado da resolução.
+    void uploadHeightTexture(const MeshData& data, QOpenGLBuffer* sharedEbo);
 
     // Membro: m_chunkGridX
     // Tipo: int
@@ -200,7 +473,8 @@ private:
 
     // Membro: m_indexCount
     // Tipo: int
-    // Descrição: O número total de índices usados para desenhar a malha do chunk.
+    // Descrição: O número total de índices usados para desenhar a malha do chunk
+    //            (lidos do buffer compartilhado da resolução atual).
     int m_indexCount;
 
     // Membro: m_vertexCount
@@ -208,6 +482,26 @@ private:
     // Descrição: O número total de vértices na malha do chunk.
     int m_vertexCount;
 
+    // Membro: m_format
+    // Tipo: TerrainVertexFormat
+    // Descrição: O formato de vértice da malha atualmente na GPU (define os atributos do VAO).
+    TerrainVertexFormat m_format;
+
+    // Membro: m_gridStep
+    // Tipo: float
+    // Descrição: Passo da grade da malha atual, enviado ao shader no formato compacto.
+    float m_gridStep;
+
+    // Membro: m_indexType
+    // Tipo: GLenum
+    // Descrição: Tipo dos índices do buffer compartilhado (GL_UNSIGNED_INT ou GL_UNSIGNED_SHORT).
+    GLenum m_indexType;
+
+    // Membro: m_vboSize
+    // Tipo: int
+    // Descrição: Tamanho em bytes do VBO atual (para reaproveitá-lo ou devolvê-lo ao pool).
+    int m_vboSize;
+
     // Membro: m_currentResolution
     // Tipo: int
     // Descrição: A resolução (número de vértices por lado) com a qual a malha atual foi gerada.
@@ -215,26 +509,45 @@ private:
 
     // Membro: m_currentLOD
     // Tipo: int
-    // Descrição: O Nível de Detalhe (LOD) atual do chunk (e.g., 0 para alta, 1 para baixa).
+    // Descrição: O Nível de Detalhe (LOD) atual do chunk (0 = maior resolução; -1 = não inicializado).
     int m_currentLOD;
 
+    // Membro: m_minHeight / m_maxHeight
+    // Tipo: float
+    // Descrição: Extensão em Y da malha atual, copiada da MeshData no upload.
+    float m_minHeight;
+    float m_maxHeight;
+
+    // Membro: m_heightBase
+    // Tipo: float
+    // Descrição: Altura de referência da malha compacta atual (MeshData::heightBase). Entra no Y
+    //            da matriz de modelo ou, no desenho em lote, da origem do slot.
+    float m_heightBase;
+
+    // Membro: m_batchSlot
+    // Tipo: TerrainBatchSlot
+    // Descrição: Slot da malha atual nas páginas do desenho em lote (inválido fora dele).
+    TerrainBatchSlot m_batchSlot;
+
     // Membro: m_vao
     // Tipo: std::unique_ptr<QOpenGLVertexArrayObject>
     // Descrição: Um ponteiro único para o Vertex Array Object (VAO) deste chunk.
     //            VAOs encapsulam a configuração de atributos de vértice para simplificar o desenho.
+    //            Criado no primeiro upload e mantido por toda a vida do chunk.
     std::unique_ptr<QOpenGLVertexArrayObject> m_vao;
 
     // Membro: m_vbo
     // Tipo: std::unique_ptr<QOpenGLBuffer>
     // Descrição: Um ponteiro único para o Vertex Buffer Object (VBO) deste chunk.
     //            VBOs armazenam os dados de vértice (posições, normais, etc.) na GPU.
+    //            Vem do TerrainBufferPool e volta para ele quando a resolução da malha muda.
     std::unique_ptr<QOpenGLBuffer> m_vbo;
 
-    // Membro: m_ebo
-    // Tipo: std::unique_ptr<QOpenGLBuffer>
-    // Descrição: Um ponteiro único para o Element Buffer Object (EBO) ou Index Buffer Object (IBO) deste chunk.
-    //            EBOs armazenam os índices de vértice na GPU, permitindo reutilizar vértices.
-    std::unique_ptr<QOpenGLBuffer> m_ebo;
+    // Membro: m_heightTexture
+    // Tipo: std::unique_ptr<QOpenGLTexture>
+    // Descrição: A textura de alturas (R32F, (resolution + 2)² texels) do formato HeightTexture.
+    //            Recriada só quando a resolução muda; nos demais uploads, só os dados são trocados.
+    std::unique_ptr<QOpenGLTexture> m_heightTexture;
 
     // Membro: m_modelMatrix
     // Tipo: QMatrix4x4
@@ -252,6 +565,13 @@ private:
     // Descrição: Armazena temporariamente os dados de malha gerados por uma thread de worker
     //            antes que possam ser enviados para a GPU na thread principal.
     MeshData m_pendingMeshData;
+
+    // Membro: m_generation
+    // Tipo: GenerationToken
+    // Descrição: Contador de geração deste chunk, compartilhado com os workers em andamento.
+    //            É um ponteiro compartilhado para continuar válido enquanto algum worker
+    //            ainda o referenciar, mesmo que o chunk seja destruído.
+    GenerationToken m_generation;
 };
 
 #endif // CHUNK_H
@@ -1,53 +1,86 @@
 #include "chunkworker.h" // Inclui o cabeçalho da classe ChunkWorker.
 #include <QDebug>          // Para mensagens de depuração.
-#include "terrainmanager.h" // Inclui o cabeçalho da classe terrainmanager.
+#include "terraincompletionqueue.h" // Fila onde a malha pronta é entregue à thread principal.
 
 /**
  * @brief Construtor da classe ChunkWorker.
  * @param chunkX Coordenada X do chunk a ser gerado.
  * @param chunkZ Coordenada Z do chunk a ser gerado.
  * @param resolution Resolução da malha a ser gerada.
+ * @param generation Token de geração do chunk no momento do pedido.
+ * @param generationToken Contador de geração compartilhado do chunk.
  * @param config Ponteiro para a configuração do mundo.
- * @param manager Ponteiro para o terrainmanager que solicitou o trabalho.
+ * @param completions Fila de conclusão do terrainmanager que solicitou o trabalho.
  *
  * Inicializa os membros da classe com os parâmetros fornecidos e define
- * `setAutoDelete(true)` para que o objeto seja automaticamente liberado
- * pelo QThreadPool após a execução de `run()`.
+ * `setAutoDelete(false)`, pois quem libera o worker é o TerrainJobScheduler.
  */
-ChunkWorker::ChunkWorker(int chunkX, int chunkZ, int resolution, const WorldConfig* config, terrainmanager* manager):
+ChunkWorker::ChunkWorker(int chunkX, int chunkZ, int resolution, quint32 generation, chunk::GenerationToken generationToken,
+                         const WorldConfig* config, TerrainCompletionQueue* completions):
     m_chunkX(chunkX), // Inicializa a coordenada X do chunk.
     m_chunkZ(chunkZ), // Inicializa a coordenada Z do chunk.
     m_resolution(resolution), // Inicializa a resolução da malha.
+    m_generation(generation), // Guarda o token de geração esperado.
+    m_generationToken(std::move(generationToken)), // Guarda o contador compartilhado do chunk.
     m_config(config), // Inicializa o ponteiro para a configuração do mundo.
-    m_manager(manager) // Inicializa o ponteiro para o terrainmanager.
+    m_completions(completions), // Fila onde a malha pronta será entregue.
+    m_requestedAtUs(TerrainCompletionQueue::timestampUs()) // Marca o instante do pedido.
 {
-    // A auto-destruição garante que o QRunnable seja deletado após a execução pelo QThreadPool.
-    setAutoDelete(true);
+    // O TerrainJobScheduler executa e destrói o worker; ele nunca é entregue diretamente a um QThreadPool.
+    setAutoDelete(false);
 }
 
 /**
  * @brief O método principal de execução do ChunkWorker.
  *
- * Este método é executado em uma thread separada pelo QThreadPool.
+ * Este método é executado em uma thread separada pelo TerrainJobScheduler.
  * Ele realiza o cálculo pesado de geração dos dados da malha do chunk
- * e, em seguida, envia esses dados de volta para a thread principal (via terrainmanager)
- * para que possam ser uploaded na GPU de forma segura.
+ * e, em seguida, coloca a malha na fila de conclusão, de onde a thread principal
+ * a retira para o upload na GPU.
  */
 void ChunkWorker::run()
 {
+    // Um trabalho que ficou obsoleto enquanto esperava na fila termina sem gerar nada.
+    if (isStale()) {
+        return;
+    }
+
     // Realiza o cálculo pesado da malha do chunk.
     // A função `chunk::generateMeshData` é estática e não depende do estado de um objeto `chunk` específico,
     // o que a torna segura para ser chamada de uma thread de worker.
-    chunk::MeshData generateData = chunk::generateMeshData(m_chunkX, m_chunkZ, m_resolution, m_config->chunkSize);
+    // O token é verificado a cada linha para abandonar cedo um trabalho que se tornou obsoleto.
+    // A malha é alocada uma vez aqui e sua posse é movida até o chunk, sem cópias dos vértices.
+    chunk::MeshDataPtr generateData = std::make_unique<chunk::MeshData>(
+        chunk::generateMeshData(m_chunkX, m_chunkZ, m_resolution, *m_config, [this]() { return isStale(); }));
+
+    // Se o chunk foi reciclado ou mudou de LOD durante a geração, o resultado é descartado aqui
+    // mesmo, sem custo de enfileiramento na thread principal.
+    if (isStale()) {
+        return;
+    }
+    generateData->generation = m_generation;
+    generateData->requestedAtUs = m_requestedAtUs;
+    generateData->readyAtUs = TerrainCompletionQueue::timestampUs();
+
+    // Entrega o resultado à thread principal pela fila sem travas: nenhum evento Qt, alocação
+    // ou cópia por chunk. A thread principal a esvazia em `terrainmanager::update`.
+    // Se a fila estiver cheia, o worker dorme até a thread principal retirar uma malha (sem
+    // ocupar um núcleo enquanto ela é o gargalo); a cada FULL_QUEUE_WAIT_MS confere se o
+    // resultado ficou obsoleto e, nesse caso, o descarta (isso também libera os workers no
+    // desligamento do gerenciador, quando ninguém mais esvazia a fila).
+    while (!m_completions->tryPush(generateData)) {
+        if (isStale()) {
+            return;
+        }
+        m_completions->waitForSpace(FULL_QUEUE_WAIT_MS);
+    }
+}
 
-    // Devolve o resultado para a thread principal de forma segura.
-    // Usamos `QMetaObject::invokeMethod` para chamar o slot `onMeshReady` do `m_manager`
-    // a partir desta thread de worker.
-    // `Qt::QueuedConnection` garante que a chamada do slot será enfileirada e executada
-    // na thread onde `m_manager` vive (a thread principal), o que é essencial para
-    // operações OpenGL (que precisam ser no contexto da thread principal).
-    QMetaObject::invokeMethod(m_manager, "onMeshReady", Qt::QueuedConnection,
-                              Q_ARG(int, m_chunkX),
-                              Q_ARG(int, m_chunkZ),
-                              Q_ARG(chunk::MeshData, generateData));
+/**
+ * @brief Verifica se este trabalho se tornou obsoleto.
+ * @return true se o token de geração do chunk avançou desde o pedido.
+ */
+bool ChunkWorker::isStale() const
+{
+    return m_generationToken->load(std::memory_order_acquire) != m_generation;
 }
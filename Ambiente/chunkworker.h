@@ -6,40 +6,50 @@
 #include <QRunnable>    // Classe base para objetos que podem ser executados por um QThreadPool em uma thread separada.
 #include "worldconfig.h"// Inclui a estrutura WorldConfig para acessar parâmetros do mundo.
 
-// Declaração antecipada da classe terrainmanager
-// Descrição: Usada para evitar inclusões circulares e para declarar que ChunkWorker
-//            terá um ponteiro para terrainmanager, sem precisar de sua definição completa aqui.
-class terrainmanager;
+// Declaração antecipada da classe TerrainCompletionQueue
+// Descrição: ChunkWorker só guarda um ponteiro para a fila onde entrega a malha pronta.
+class TerrainCompletionQueue;
 
 // Classe: ChunkWorker
 // Descrição: Esta classe é um "trabalhador" (worker) que herda de QRunnable,
 //            projetada para executar o cálculo pesado de geração de malha de chunk
-//            em uma thread separada (gerenciada por QThreadPool).
-//            Após a geração, ela envia os dados da malha de volta para a thread principal
-//            (via um slot no `terrainmanager`) para o upload na GPU.
+//            em uma thread separada (gerenciada pelo TerrainJobScheduler).
+//            Após a geração, ela coloca a malha na fila de conclusão sem travas, que a
+//            thread principal (`terrainmanager`) esvazia a cada quadro para o upload na GPU.
+//            Cada worker carrega o token de geração do chunk no momento do pedido; se o
+//            chunk for reciclado ou mudar de LOD, o worker abandona o trabalho e não envia nada.
 class ChunkWorker : public QRunnable
 {
 public:
 
     // Construtor: ChunkWorker
     // Descrição: Inicializa o worker com os dados necessários para gerar um chunk específico.
-    //            Define `setAutoDelete(true)` para que o objeto seja automaticamente deletado
-    //            pelo QThreadPool após a execução do método `run()`.
+    //            Define `setAutoDelete(false)`: o TerrainJobScheduler é dono do worker e o
+    //            destrói após a execução ou o cancelamento.
     // Parâmetros:
     //   - chunkX: Coordenada X do chunk na grade.
     //   - chunkZ: Coordenada Z do chunk na grade.
     //   - resolution: A resolução da malha a ser gerada para este chunk.
+    //   - generation: O valor do token de geração do chunk quando o trabalho foi pedido.
+    //   - generationToken: O contador de geração compartilhado do chunk.
     //   - config: Ponteiro constante para a configuração do mundo (WorldConfig).
-    //   - manager: Ponteiro para o `terrainmanager` que solicitou a geração da malha.
-    ChunkWorker(int chunkX,int chunkZ, int resolution, const WorldConfig* config, terrainmanager* manager);
+    //   - completions: Fila de conclusão onde a malha pronta é entregue à thread principal.
+    ChunkWorker(int chunkX,int chunkZ, int resolution, quint32 generation, chunk::GenerationToken generationToken,
+                const WorldConfig* config, TerrainCompletionQueue* completions);
 
     // Método: run
-    // Descrição: O método principal que é executado quando o QRunnable é iniciado por um QThreadPool.
+    // Descrição: O método principal, executado por uma thread do TerrainJobScheduler.
     //            Contém a lógica para gerar os dados da malha do chunk na CPU
-    //            e enviá-los de volta para a thread principal.
+    //            e enviá-los de volta para a thread principal, a menos que o trabalho
+    //            tenha se tornado obsoleto antes ou durante a geração.
     void run() override;
 
 private:
+    // Método Privado: isStale
+    // Descrição: Verifica se o token de geração do chunk avançou desde o pedido deste trabalho.
+    // Retorno: bool - true se o resultado deste worker não é mais desejado.
+    bool isStale() const;
+
     // Membro: m_chunkX
     // Tipo: int
     // Descrição: A coordenada X do chunk que este worker é responsável por gerar.
@@ -55,16 +65,36 @@ private:
     // Descrição: A resolução da malha que será gerada para este chunk.
     int m_resolution;
 
+    // Membro: m_generation
+    // Tipo: quint32
+    // Descrição: O valor do token de geração do chunk no momento do pedido.
+    quint32 m_generation;
+
+    // Membro: m_generationToken
+    // Tipo: chunk::GenerationToken
+    // Descrição: O contador de geração compartilhado do chunk, lido para detectar obsolescência.
+    chunk::GenerationToken m_generationToken;
+
     // Membro: m_config
     // Tipo: const WorldConfig*
     // Descrição: Ponteiro constante para a configuração global do mundo, contendo parâmetros como o tamanho do chunk.
     const WorldConfig* m_config;
 
-    // Membro: m_manager
-    // Tipo: terrainmanager*
-    // Descrição: Ponteiro para o `terrainmanager` que iniciou este worker.
-    //            Usado para chamar um slot na thread principal e enviar os dados da malha gerada.
-    terrainmanager* m_manager;
+    // Membro: m_completions
+    // Tipo: TerrainCompletionQueue*
+    // Descrição: Fila de conclusão do `terrainmanager` que iniciou este worker.
+    //            A malha gerada é entregue à thread principal por ela.
+    TerrainCompletionQueue* m_completions;
+
+    // Membro: m_requestedAtUs
+    // Tipo: qint64
+    // Descrição: Instante do pedido (construção do worker, na thread principal), para a métrica de latência.
+    qint64 m_requestedAtUs;
+
+    // Constante: FULL_QUEUE_WAIT_MS
+    // Descrição: Espera máxima por espaço na fila de conclusão cheia antes de conferir de novo
+    //            se o trabalho ficou obsoleto.
+    static constexpr unsigned long FULL_QUEUE_WAIT_MS = 5;
 };
 
 #endif // CHUNKWORKER_H
@@ -0,0 +1,537 @@
+#include "demheightsource.h" // Inclui o cabeçalho da classe DemHeightSource.
+#include <QDebug>            // Para mensagens de depuração (qInfo, qWarning).
+#include <QTextStream>       // Para ler o grid ESRI ASCII na conversão.
+#include <algorithm>         // Para std::clamp, std::nth_element.
+#include <cmath>             // Para std::floor, std::ceil.
+#include <cstring>           // Para std::memcpy, std::memcmp.
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>        // Para madvise (leitura aleatória e devolução de páginas).
+#endif
+
+namespace {
+
+// Layout do arquivo DEM (little-endian, como o i.MX8 e as máquinas de desenvolvimento):
+//   [cabeçalho DemFileHeader, completado com zeros até FILE_ALIGNMENT]
+//   [nível 0: tilesX * tilesZ tiles de tileSize² floats, linha por linha, cada tile linha por linha]
+//   [nível 1 ...] (cada nível começa em um múltiplo de FILE_ALIGNMENT)
+// O alinhamento a páginas permite devolver tiles inteiros ao sistema com madvise.
+
+constexpr char DEM_MAGIC[4] = {'A', 'D', 'E', 'M'};
+constexpr quint32 DEM_VERSION = 2; // 2: linhas de norte a sul (o norte é -Z no mundo).
+constexpr int MAX_LEVELS = 16;
+constexpr qint64 FILE_ALIGNMENT = 4096;
+
+struct DemFileLevel {
+    quint32 width;   // Amostras em X.
+    quint32 height;  // Amostras em Z.
+    quint32 tilesX;  // Tiles em X.
+    quint32 tilesZ;  // Tiles em Z.
+    quint64 offset;  // Posição do primeiro tile no arquivo.
+};
+
+struct DemFileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 tileSize;
+    quint32 levelCount;
+    double originX;   // Coordenada projetada leste (easting) da amostra (0, 0), só informativa.
+    double originZ;   // Coordenada projetada norte (northing) da amostra (0, 0), só informativa.
+    double cellSize;  // Espaçamento das amostras do nível 0, em metros.
+    DemFileLevel levels[MAX_LEVELS];
+};
+
+qint64 alignUp(qint64 value)
+{
+    return (value + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+}
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Construtor da classe DemHeightSource (sem arquivo aberto).
+ */
+DemHeightSource::DemHeightSource() :
+    m_data(nullptr),
+    m_mappedSize(0),
+    m_tileSize(0),
+    m_originX(0.0),
+    m_originZ(0.0),
+    m_tileCount(0),
+    m_epoch(1), // A época 0 é reservada para "tile não residente".
+    m_evictedTiles(0)
+{
+}
+
+/**
+ * @brief Destrutor: desfaz o mapeamento e fecha o arquivo.
+ */
+DemHeightSource::~DemHeightSource()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+/**
+ * @brief Mapeia um arquivo DEM e valida o cabeçalho.
+ * @param path Caminho do arquivo.
+ * @param errorMessage Recebe a descrição do erro, se não for nulo.
+ * @return true se o arquivo é válido.
+ *
+ * Só o cabeçalho é lido; as páginas dos tiles entram na memória quando consultadas.
+ * O mapeamento é marcado como de acesso aleatório, para que o sistema não leia
+ * adiante páginas que não foram pedidas.
+ */
+bool DemHeightSource::open(const QString& path, QString* errorMessage)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, QString("Nao foi possivel abrir %1: %2").arg(path, m_file.errorString()));
+        return false;
+    }
+    const qint64 fileSize = m_file.size();
+    if (fileSize < static_cast<qint64>(sizeof(DemFileHeader))) {
+        setError(errorMessage, QString("%1 e pequeno demais para ser um DEM").arg(path));
+        m_file.close();
+        return false;
+    }
+    uchar* mapped = m_file.map(0, fileSize);
+    if (!mapped) {
+        setError(errorMessage, QString("Falha ao mapear %1: %2").arg(path, m_file.errorString()));
+        m_file.close();
+        return false;
+    }
+
+    DemFileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    const bool headerValid = std::memcmp(header.magic, DEM_MAGIC, sizeof(DEM_MAGIC)) == 0
+        && header.version == DEM_VERSION && header.tileSize > 0 && header.levelCount > 0
+        && header.levelCount <= MAX_LEVELS && header.cellSize > 0.0;
+    if (!headerValid) {
+        setError(errorMessage, QString("%1 nao e um DEM valido (versao %2)").arg(path).arg(DEM_VERSION));
+        m_file.unmap(mapped);
+        m_file.close();
+        return false;
+    }
+
+    const qint64 tileBytes = static_cast<qint64>(header.tileSize) * header.tileSize * sizeof(float);
+    std::vector<Level> levels;
+    int tileCount = 0;
+    for (quint32 i = 0; i < header.levelCount; ++i) {
+        const DemFileLevel& fileLevel = header.levels[i];
+        Level level;
+        level.width = static_cast<int>(fileLevel.width);
+        level.height = static_cast<int>(fileLevel.height);
+        level.tilesX = static_cast<int>(fileLevel.tilesX);
+        level.tilesZ = static_cast<int>(fileLevel.tilesZ);
+        level.offset = static_cast<qint64>(fileLevel.offset);
+        level.firstTile = tileCount;
+        level.cellSize = static_cast<float>(header.cellSize * static_cast<double>(1u << i));
+        level.originShift = 0.5 * (static_cast<double>(1u << i) - 1.0) * header.cellSize;
+        const qint64 levelEnd = level.offset + static_cast<qint64>(level.tilesX) * level.tilesZ * tileBytes;
+        const int tileSize = static_cast<int>(header.tileSize);
+        const bool tilesValid = level.width > 0 && level.height > 0
+            && level.tilesX == (level.width + tileSize - 1) / tileSize
+            && level.tilesZ == (level.height + tileSize - 1) / tileSize;
+        if (!tilesValid) {
+            setError(errorMessage, QString("%1 tem tiles inconsistentes com as dimensoes (nivel %2)").arg(path).arg(i));
+            m_file.unmap(mapped);
+            m_file.close();
+            return false;
+        }
+        if (levelEnd > fileSize) {
+            setError(errorMessage, QString("%1 esta truncado (nivel %2)").arg(path).arg(i));
+            m_file.unmap(mapped);
+            m_file.close();
+            return false;
+        }
+        tileCount += level.tilesX * level.tilesZ;
+        levels.push_back(level);
+    }
+
+#ifdef Q_OS_LINUX
+    madvise(mapped, static_cast<size_t>(fileSize), MADV_RANDOM);
+#endif
+
+    m_data = mapped;
+    m_mappedSize = fileSize;
+    m_tileSize = static_cast<int>(header.tileSize);
+    m_levels = std::move(levels);
+    // Sem georreferência, o DEM fica centrado na origem do mundo.
+    setWorldOrigin(-0.5 * (m_levels[0].width - 1) * header.cellSize, -0.5 * (m_levels[0].height - 1) * header.cellSize);
+    m_tileCount = tileCount;
+    m_tileStamps.reset(new std::atomic<quint32>[static_cast<size_t>(tileCount)]);
+    for (int i = 0; i < tileCount; ++i) {
+        m_tileStamps[i].store(0, std::memory_order_relaxed);
+    }
+
+    qInfo() << "DEM mapeado:" << path << "-" << m_levels[0].width << "x" << m_levels[0].height
+            << "amostras de" << m_levels[0].cellSize << "m -" << m_levels.size() << "niveis -" << tileCount << "tiles";
+    return true;
+}
+
+/**
+ * @brief Posiciona o DEM no mundo.
+ * @param worldX Coordenada X do mundo do centro da célula noroeste.
+ * @param worldZ Coordenada Z do mundo do centro da célula noroeste.
+ *
+ * Um worker que amostre durante a troca pode ler uma origem misturada, mas a sua
+ * malha é descartada: quem chama avança a geração de todos os chunks.
+ */
+void DemHeightSource::setWorldOrigin(double worldX, double worldZ)
+{
+    m_originX.store(worldX, std::memory_order_relaxed);
+    m_originZ.store(worldZ, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Altura no nível mais fino.
+ */
+float DemHeightSource::height(float worldX, float worldZ) const
+{
+    return bilinear(m_levels[0], worldX, worldZ, nullptr, nullptr);
+}
+
+/**
+ * @brief Altura e derivadas exatas da interpolação bilinear, no nível mais fino.
+ */
+float DemHeightSource::heightAndDerivatives(float worldX, float worldZ, float& dHeightDx, float& dHeightDz) const
+{
+    return bilinear(m_levels[0], worldX, worldZ, &dHeightDx, &dHeightDz);
+}
+
+/**
+ * @brief Avalia uma linha de pontos no nível de mipmap adequado ao espaçamento.
+ */
+void DemHeightSource::heightRow(float startX, float stepX, float worldZ, int count, float* outHeights) const
+{
+    const Level& level = m_levels[levelForStep(std::abs(stepX))];
+    for (int i = 0; i < count; ++i) {
+        outHeights[i] = bilinear(level, startX + static_cast<float>(i) * stepX, worldZ, nullptr, nullptr);
+    }
+}
+
+/**
+ * @brief Devolve ao sistema as páginas dos tiles menos recentemente usados.
+ * @param maxResidentTiles Número máximo de tiles residentes.
+ *
+ * Cada chamada abre uma nova época. Os tiles são ordenados pela época da última
+ * consulta e os mais antigos, além do limite, são descartados com MADV_DONTNEED
+ * (o mapeamento é somente leitura, então as páginas são apenas liberadas).
+ */
+void DemHeightSource::trim(int maxResidentTiles)
+{
+    if (!m_data) {
+        return;
+    }
+    m_epoch.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<std::pair<quint32, int>> resident;
+    for (int i = 0; i < m_tileCount; ++i) {
+        quint32 stamp = m_tileStamps[i].load(std::memory_order_relaxed);
+        if (stamp != 0) {
+            resident.emplace_back(stamp, i);
+        }
+    }
+    const int excess = static_cast<int>(resident.size()) - std::max(0, maxResidentTiles);
+    if (excess <= 0) {
+        return;
+    }
+    std::nth_element(resident.begin(), resident.begin() + excess, resident.end());
+
+    const qint64 bytesPerTile = tileBytes();
+    for (int k = 0; k < excess; ++k) {
+        const int tileIndex = resident[k].second;
+        // Localiza o nível do tile para obter sua posição no arquivo.
+        auto level = std::upper_bound(m_levels.begin(), m_levels.end(), tileIndex,
+                                      [](int index, const Level& l) { return index < l.firstTile; }) - 1;
+        const qint64 offset = level->offset + static_cast<qint64>(tileIndex - level->firstTile) * bytesPerTile;
+#ifdef Q_OS_LINUX
+        madvise(const_cast<uchar*>(m_data) + offset, static_cast<size_t>(bytesPerTile), MADV_DONTNEED);
+#else
+        Q_UNUSED(offset);
+#endif
+        m_tileStamps[tileIndex].store(0, std::memory_order_relaxed);
+        ++m_evictedTiles;
+    }
+}
+
+/**
+ * @brief Retorna quantos tiles estão marcados como residentes.
+ */
+int DemHeightSource::residentTiles() const
+{
+    int count = 0;
+    for (int i = 0; i < m_tileCount; ++i) {
+        if (m_tileStamps[i].load(std::memory_order_relaxed) != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Escolhe o nível mais grosso cujo espaçamento não passa de `step`.
+ */
+int DemHeightSource::levelForStep(float step) const
+{
+    int chosen = 0;
+    for (int i = 1; i < static_cast<int>(m_levels.size()); ++i) {
+        if (m_levels[i].cellSize > step) {
+            break;
+        }
+        chosen = i;
+    }
+    return chosen;
+}
+
+/**
+ * @brief Lê uma amostra de um nível e marca o tile como usado.
+ */
+float DemHeightSource::sample(const Level& level, int ix, int iz) const
+{
+    ix = std::clamp(ix, 0, level.width - 1);
+    iz = std::clamp(iz, 0, level.height - 1);
+    const int tileX = ix / m_tileSize;
+    const int tileZ = iz / m_tileSize;
+    const int tileInLevel = tileZ * level.tilesX + tileX;
+    touchTile(level.firstTile + tileInLevel);
+
+    const float* tile = reinterpret_cast<const float*>(
+        m_data + level.offset + static_cast<qint64>(tileInLevel) * tileBytes());
+    return tile[(iz % m_tileSize) * m_tileSize + (ix % m_tileSize)];
+}
+
+/**
+ * @brief Interpolação bilinear em um nível, com as derivadas opcionais.
+ */
+float DemHeightSource::bilinear(const Level& level, float worldX, float worldZ, float* dHeightDx, float* dHeightDz) const
+{
+    const double originX = m_originX.load(std::memory_order_relaxed);
+    const double originZ = m_originZ.load(std::memory_order_relaxed);
+    const float gx = static_cast<float>((worldX - originX - level.originShift) / level.cellSize);
+    const float gz = static_cast<float>((worldZ - originZ - level.originShift) / level.cellSize);
+    const float fx0 = std::floor(gx);
+    const float fz0 = std::floor(gz);
+    const int ix = static_cast<int>(fx0);
+    const int iz = static_cast<int>(fz0);
+    const float tx = gx - fx0;
+    const float tz = gz - fz0;
+
+    const float h00 = sample(level, ix, iz);
+    const float h10 = sample(level, ix + 1, iz);
+    const float h01 = sample(level, ix, iz + 1);
+    const float h11 = sample(level, ix + 1, iz + 1);
+
+    if (dHeightDx && dHeightDz) {
+        *dHeightDx = ((h10 - h00) * (1.0f - tz) + (h11 - h01) * tz) / level.cellSize;
+        *dHeightDz = ((h01 - h00) * (1.0f - tx) + (h11 - h10) * tx) / level.cellSize;
+    }
+    const float top = h00 + (h10 - h00) * tx;
+    const float bottom = h01 + (h11 - h01) * tx;
+    return top + (bottom - top) * tz;
+}
+
+/**
+ * @brief Marca um tile com a época atual.
+ */
+void DemHeightSource::touchTile(int tileIndex) const
+{
+    const quint32 epoch = m_epoch.load(std::memory_order_relaxed);
+    std::atomic<quint32>& stamp = m_tileStamps[tileIndex];
+    if (stamp.load(std::memory_order_relaxed) != epoch) {
+        stamp.store(epoch, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Converte um grid ESRI ASCII para o formato DEM em tiles com mipmaps.
+ * @param inputPath Caminho do grid ESRI ASCII.
+ * @param outputPath Caminho do arquivo DEM.
+ * @param tileSize Lado de cada tile, em amostras.
+ * @param errorMessage Recebe a descrição do erro, se não for nulo.
+ * @return true se a conversão terminou com sucesso.
+ *
+ * Ferramenta de preparação (fora do laço de renderização): o grid inteiro é lido
+ * na memória, os níveis são reduzidos por média 2x2 até caberem em um único tile,
+ * e cada nível é gravado em tiles completados com a amostra da borda.
+ */
+bool DemHeightSource::convertAsciiGrid(const QString& inputPath, const QString& outputPath, int tileSize,
+                                       QString* errorMessage)
+{
+    if (tileSize < 16 || (tileSize & (tileSize - 1)) != 0) {
+        setError(errorMessage, QString("Tamanho de tile invalido: %1 (use uma potencia de 2 >= 16)").arg(tileSize));
+        return false;
+    }
+
+    QFile input(inputPath);
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        setError(errorMessage, QString("Nao foi possivel abrir %1: %2").arg(inputPath, input.errorString()));
+        return false;
+    }
+    QTextStream in(&input);
+
+    // Cabeçalho: pares "chave valor" até a primeira linha numérica.
+    int columns = 0;
+    int rows = 0;
+    double xll = 0.0;
+    double yll = 0.0;
+    double cellSize = 0.0;
+    double noData = -9999.0;
+    bool xllIsCenter = false;
+    bool yllIsCenter = false;
+    for (int i = 0; i < 6; ++i) {
+        const qint64 position = in.pos();
+        QString key;
+        in >> key;
+        const QString lower = key.toLower();
+        if (lower == "ncols") {
+            in >> columns;
+        } else if (lower == "nrows") {
+            in >> rows;
+        } else if (lower == "xllcorner" || lower == "xllcenter") {
+            in >> xll;
+            xllIsCenter = (lower == "xllcenter");
+        } else if (lower == "yllcorner" || lower == "yllcenter") {
+            in >> yll;
+            yllIsCenter = (lower == "yllcenter");
+        } else if (lower == "cellsize") {
+            in >> cellSize;
+        } else if (lower == "nodata_value") {
+            in >> noData;
+        } else {
+            in.seek(position); // Primeira amostra: o cabeçalho acabou (NODATA_value é opcional).
+            break;
+        }
+    }
+    if (columns <= 0 || rows <= 0 || cellSize <= 0.0) {
+        setError(errorMessage, QString("%1 nao tem um cabecalho ESRI ASCII valido").arg(inputPath));
+        return false;
+    }
+
+    // Amostras: as linhas do arquivo vão de norte a sul e são guardadas nessa ordem (Z crescente
+    // para o sul, como no mundo, onde o norte é -Z).
+    std::vector<float> level(static_cast<size_t>(columns) * static_cast<size_t>(rows));
+    std::vector<bool> valid(level.size());
+    double validSum = 0.0;
+    qint64 validCount = 0;
+    for (int r = 0; r < rows; ++r) {
+        const int z = r;
+        for (int c = 0; c < columns; ++c) {
+            double value = noData;
+            in >> value;
+            if (in.status() != QTextStream::Ok) {
+                setError(errorMessage, QString("%1 terminou antes de %2 x %3 amostras").arg(inputPath).arg(columns).arg(rows));
+                return false;
+            }
+            const size_t index = static_cast<size_t>(z) * columns + c;
+            valid[index] = (value != noData);
+            level[index] = static_cast<float>(value);
+            if (valid[index]) {
+                validSum += value;
+                ++validCount;
+            }
+        }
+    }
+    const float fillValue = validCount > 0 ? static_cast<float>(validSum / validCount) : 0.0f;
+    for (size_t i = 0; i < level.size(); ++i) {
+        if (!valid[i]) {
+            level[i] = fillValue;
+        }
+    }
+
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        setError(errorMessage, QString("Nao foi possivel criar %1: %2").arg(outputPath, output.errorString()));
+        return false;
+    }
+
+    DemFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, DEM_MAGIC, sizeof(DEM_MAGIC));
+    header.version = DEM_VERSION;
+    header.tileSize = static_cast<quint32>(tileSize);
+    // Coordenada projetada do centro da célula noroeste (a primeira amostra do arquivo).
+    header.originX = xll + (xllIsCenter ? 0.0 : cellSize * 0.5);
+    header.originZ = yll + (yllIsCenter ? 0.0 : cellSize * 0.5) + (rows - 1) * cellSize;
+    header.cellSize = cellSize;
+
+    // Grava os níveis, do mais fino ao mais grosso; o cabeçalho é gravado por último.
+    qint64 offset = alignUp(static_cast<qint64>(sizeof(DemFileHeader)));
+    int width = columns;
+    int height = rows;
+    std::vector<float> tile(static_cast<size_t>(tileSize) * tileSize);
+    quint32 levelCount = 0;
+    for (;;) {
+        DemFileLevel& fileLevel = header.levels[levelCount];
+        fileLevel.width = static_cast<quint32>(width);
+        fileLevel.height = static_cast<quint32>(height);
+        fileLevel.tilesX = static_cast<quint32>((width + tileSize - 1) / tileSize);
+        fileLevel.tilesZ = static_cast<quint32>((height + tileSize - 1) / tileSize);
+        fileLevel.offset = static_cast<quint64>(offset);
+
+        if (!output.seek(offset)) {
+            setError(errorMessage, output.errorString());
+            return false;
+        }
+        for (quint32 tz = 0; tz < fileLevel.tilesZ; ++tz) {
+            for (quint32 tx = 0; tx < fileLevel.tilesX; ++tx) {
+                for (int z = 0; z < tileSize; ++z) {
+                    const int sz = std::min(static_cast<int>(tz) * tileSize + z, height - 1);
+                    for (int x = 0; x < tileSize; ++x) {
+                        const int sx = std::min(static_cast<int>(tx) * tileSize + x, width - 1);
+                        tile[static_cast<size_t>(z) * tileSize + x] = level[static_cast<size_t>(sz) * width + sx];
+                    }
+                }
+                const qint64 bytes = static_cast<qint64>(tile.size() * sizeof(float));
+                if (output.write(reinterpret_cast<const char*>(tile.data()), bytes) != bytes) {
+                    setError(errorMessage, output.errorString());
+                    return false;
+                }
+            }
+        }
+        offset = alignUp(offset + static_cast<qint64>(fileLevel.tilesX) * fileLevel.tilesZ * tile.size() * sizeof(float));
+        ++levelCount;
+
+        if ((width <= tileSize && height <= tileSize) || levelCount == MAX_LEVELS) {
+            break;
+        }
+
+        // Próximo nível: média 2x2 (a última linha/coluna ímpar repete a borda).
+        const int nextWidth = (width + 1) / 2;
+        const int nextHeight = (height + 1) / 2;
+        std::vector<float> next(static_cast<size_t>(nextWidth) * nextHeight);
+        for (int z = 0; z < nextHeight; ++z) {
+            const int z0 = 2 * z;
+            const int z1 = std::min(z0 + 1, height - 1);
+            for (int x = 0; x < nextWidth; ++x) {
+                const int x0 = 2 * x;
+                const int x1 = std::min(x0 + 1, width - 1);
+                next[static_cast<size_t>(z) * nextWidth + x] = 0.25f
+                    * (level[static_cast<size_t>(z0) * width + x0] + level[static_cast<size_t>(z0) * width + x1]
+                       + level[static_cast<size_t>(z1) * width + x0] + level[static_cast<size_t>(z1) * width + x1]);
+            }
+        }
+        level.swap(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+    header.levelCount = levelCount;
+
+    // Completa o arquivo até o fim alinhado do último nível e grava o cabeçalho.
+    if (!output.resize(offset) || !output.seek(0)
+        || output.write(reinterpret_cast<const char*>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header))) {
+        setError(errorMessage, output.errorString());
+        return false;
+    }
+    qInfo() << "DEM convertido:" << outputPath << "-" << columns << "x" << rows << "amostras -" << levelCount << "niveis";
+    return true;
+}
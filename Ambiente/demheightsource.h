@@ -0,0 +1,183 @@
+#ifndef DEMHEIGHTSOURCE_H
+#define DEMHEIGHTSOURCE_H
+
+#include "heightsource.h" // Interface implementada por esta classe.
+#include <QFile>          // Para abrir e mapear (mmap) o arquivo do modelo de elevação.
+#include <QString>        // Para os caminhos de arquivo e as mensagens de erro.
+#include <atomic>         // Para as marcas de uso de cada tile e a origem no mundo, lidas pelos workers.
+#include <memory>         // Para std::unique_ptr (vetor de marcas).
+#include <vector>         // Para a descrição dos níveis de mipmap.
+
+// Classe: DemHeightSource
+// Descrição: Fonte de alturas lida de um modelo digital de elevação (DEM) em tiles com mipmaps,
+//            gerado por `convertAsciiGrid` a partir de um grid ESRI ASCII (LiDAR/RTK).
+//            O arquivo é mapeado em memória (mmap) sem ser lido na abertura: cada tile entra
+//            na memória sob demanda, quando um `ChunkWorker` o consulta. Os tiles que deixam
+//            de ser usados são devolvidos ao sistema operacional por `trim` (madvise), o que
+//            mantém a memória residente limitada mesmo em talhões grandes.
+//            Amostragem bilinear, com o nível de mipmap escolhido pelo espaçamento pedido
+//            (os chunks de baixa resolução leem os níveis mais grossos, com menos páginas).
+//            Fora da área coberta, a altura é a da borda mais próxima.
+//            A posição do DEM no mundo é dada por `setWorldOrigin`; até lá, o DEM fica
+//            centrado na origem do mundo.
+class DemHeightSource : public HeightSource {
+public:
+    DemHeightSource();
+    ~DemHeightSource() override;
+
+    // Impedir Cópias (Deletadas): a classe possui o mapeamento do arquivo.
+    DemHeightSource(const DemHeightSource&) = delete;
+    DemHeightSource& operator=(const DemHeightSource&) = delete;
+
+    // Método: open
+    // Descrição: Mapeia um arquivo DEM e valida o cabeçalho. Nenhum tile é lido aqui.
+    // Parâmetros:
+    //   - path: Caminho do arquivo gerado por `convertAsciiGrid`.
+    //   - errorMessage: Se não for nulo, recebe a descrição do erro.
+    // Retorno: bool - true se o arquivo foi aberto e é válido.
+    bool open(const QString& path, QString* errorMessage = nullptr);
+
+    // Método: isOpen
+    // Descrição: Indica se há um arquivo DEM mapeado.
+    bool isOpen() const { return m_data != nullptr; }
+
+    // Método: setWorldOrigin
+    // Descrição: Posiciona o DEM no mundo: coordenada do mundo do centro da célula noroeste
+    //            (amostra (0, 0)). Pode ser chamado com os workers rodando; os chunks gerados
+    //            com a posição anterior devem ser regenerados por quem chama.
+    // Parâmetros:
+    //   - worldX: Coordenada X (leste) do mundo da amostra (0, 0).
+    //   - worldZ: Coordenada Z (sul) do mundo da amostra (0, 0).
+    void setWorldOrigin(double worldX, double worldZ);
+
+    // Métodos da interface HeightSource (ver heightsource.h).
+    float height(float worldX, float worldZ) const override;
+    float heightAndDerivatives(float worldX, float worldZ, float& dHeightDx, float& dHeightDz) const override;
+    void heightRow(float startX, float stepX, float worldZ, int count, float* outHeights) const override;
+
+    // Método: trim
+    // Descrição: Devolve ao sistema operacional (madvise MADV_DONTNEED) as páginas dos tiles
+    //            menos recentemente usados, mantendo no máximo `maxResidentTiles` tiles marcados
+    //            como residentes. Chamado periodicamente pela thread principal. Um tile devolvido
+    //            que volte a ser consultado é relido do arquivo pelo sistema, sem erro.
+    // Parâmetros:
+    //   - maxResidentTiles: Número máximo de tiles residentes.
+    void trim(int maxResidentTiles);
+
+    // Método: residentTiles
+    // Descrição: Retorna quantos tiles foram consultados desde que entraram ou voltaram à memória.
+    // Retorno: int - Tiles residentes (estimativa da memória usada: tiles x bytes por tile).
+    int residentTiles() const;
+
+    // Método: evictedTiles
+    // Descrição: Retorna quantos tiles já foram devolvidos ao sistema por `trim` (diagnóstico).
+    int evictedTiles() const { return m_evictedTiles; }
+
+    // Método: tileBytes
+    // Descrição: Retorna o tamanho, em bytes, de um tile no arquivo.
+    int tileBytes() const { return m_tileSize * m_tileSize * static_cast<int>(sizeof(float)); }
+
+    // Método Estático: convertAsciiGrid
+    // Descrição: Converte um grid ESRI ASCII (.asc: ncols, nrows, xllcorner/xllcenter,
+    //            yllcorner/yllcenter, cellsize, NODATA_value opcional e as linhas de norte a sul)
+    //            para o formato DEM em tiles com mipmaps lido por esta classe.
+    //            As linhas são gravadas na ordem do arquivo, de norte a sul: X cresce para o leste
+    //            e Z para o sul, como no mundo (o norte é -Z). O cabeçalho guarda a coordenada
+    //            projetada do centro da célula noroeste, só como referência: a posição no mundo
+    //            vem de `setWorldOrigin`. Células sem dado recebem a média das válidas.
+    // Parâmetros:
+    //   - inputPath: Caminho do grid ESRI ASCII.
+    //   - outputPath: Caminho do arquivo DEM a gerar.
+    //   - tileSize: Lado de cada tile, em amostras (potência de 2; 256 = 256 KB por tile).
+    //   - errorMessage: Se não for nulo, recebe a descrição do erro.
+    // Retorno: bool - true se a conversão terminou com sucesso.
+    static bool convertAsciiGrid(const QString& inputPath, const QString& outputPath, int tileSize = 256,
+                                 QString* errorMessage = nullptr);
+
+private:
+    // Estrutura: Level
+    // Descrição: Um nível de mipmap: dimensões em amostras e em tiles, posição no arquivo,
+    //            índice do seu primeiro tile na lista de marcas de uso e deslocamento da sua
+    //            amostra (0, 0) em relação à do nível 0 (a média 2x2 fica no centro do bloco).
+    struct Level {
+        int width;
+        int height;
+        int tilesX;
+        int tilesZ;
+        qint64 offset;
+        int firstTile;
+        float cellSize;
+        double originShift;
+    };
+
+    // Método Privado: levelForStep
+    // Descrição: Escolhe o nível mais grosso cujo espaçamento não passa de `step`.
+    int levelForStep(float step) const;
+
+    // Método Privado: sample
+    // Descrição: Lê uma amostra de um nível (índices limitados à área coberta) e marca o tile como usado.
+    float sample(const Level& level, int ix, int iz) const;
+
+    // Método Privado: bilinear
+    // Descrição: Interpolação bilinear em um nível, com as derivadas da interpolação.
+    float bilinear(const Level& level, float worldX, float worldZ, float* dHeightDx, float* dHeightDz) const;
+
+    // Método Privado: touchTile
+    // Descrição: Marca um tile com a época atual (só escreve se a marca mudou, para não
+    //            disputar a linha de cache entre os workers).
+    void touchTile(int tileIndex) const;
+
+    // Membro: m_file
+    // Tipo: QFile
+    // Descrição: O arquivo DEM, aberto somente para leitura enquanto estiver mapeado.
+    QFile m_file;
+
+    // Membro: m_data
+    // Tipo: const uchar*
+    // Descrição: Início do mapeamento do arquivo inteiro (nulo se não houver arquivo aberto).
+    const uchar* m_data;
+
+    // Membro: m_mappedSize
+    // Tipo: qint64
+    // Descrição: Tamanho do mapeamento, em bytes.
+    qint64 m_mappedSize;
+
+    // Membro: m_tileSize
+    // Tipo: int
+    // Descrição: Lado de cada tile, em amostras.
+    int m_tileSize;
+
+    // Membro: m_originX / m_originZ
+    // Tipo: std::atomic<double>
+    // Descrição: Coordenada do mundo da amostra (0, 0) do nível 0. Atômicas porque
+    //            `setWorldOrigin` roda na thread principal enquanto os workers amostram.
+    std::atomic<double> m_originX;
+    std::atomic<double> m_originZ;
+
+    // Membro: m_levels
+    // Tipo: std::vector<Level>
+    // Descrição: Os níveis de mipmap, do mais fino (0) ao mais grosso.
+    std::vector<Level> m_levels;
+
+    // Membro: m_tileStamps
+    // Tipo: std::unique_ptr<std::atomic<quint32>[]>
+    // Descrição: Época da última consulta de cada tile (0 = não residente).
+    std::unique_ptr<std::atomic<quint32>[]> m_tileStamps;
+
+    // Membro: m_tileCount
+    // Tipo: int
+    // Descrição: Total de tiles em todos os níveis.
+    int m_tileCount;
+
+    // Membro: m_epoch
+    // Tipo: std::atomic<quint32>
+    // Descrição: Época atual, avançada a cada `trim`.
+    std::atomic<quint32> m_epoch;
+
+    // Membro: m_evictedTiles
+    // Tipo: int
+    // Descrição: Total de tiles devolvidos ao sistema por `trim`.
+    int m_evictedTiles;
+};
+
+#endif // DEMHEIGHTSOURCE_H
@@ -0,0 +1,314 @@
+#include "gnssheightsource.h" // Inclui o cabeçalho da classe GnssHeightSource.
+#include <QReadLocker>         // Trava de leitura com RAII.
+#include <QWriteLocker>        // Trava de escrita com RAII.
+#include <algorithm>           // Para std::max.
+#include <cmath>               // Para std::floor, std::abs, std::isfinite.
+
+namespace {
+
+// Peso do valor vizinho (média do bloco para uma célula, zero para um bloco), em
+// unidades de 1/σ²: equivale a uma amostra com desvio de 0.5 m. Uma única amostra RTK
+// (σ de poucos centímetros) domina a célula; amostras fracas ou distantes no espalhamento
+// ficam perto da média da região.
+constexpr float PRIOR_WEIGHT = 4.0f;
+
+} // namespace
+
+/**
+ * @brief Construtor da classe GnssHeightSource.
+ * @param cellSize Lado de cada célula, em metros.
+ * @param splatRadius Raio de espalhamento de cada amostra, em células.
+ * @param chunkSize Lado de um chunk do terreno, em metros.
+ * @param dirtyThreshold Mudança mínima de altura para regenerar um chunk, em metros.
+ */
+GnssHeightSource::GnssHeightSource(float cellSize, int splatRadius, float chunkSize, float dirtyThreshold) :
+    m_cellSize(std::max(0.1f, cellSize)),
+    m_splatRadius(std::max(0, splatRadius)),
+    m_chunkSize(chunkSize),
+    m_dirtyThreshold(dirtyThreshold),
+    m_referenceAltitude(0.0),
+    m_hasReference(false),
+    m_samples(0),
+    m_rejectedSamples(0)
+{
+}
+
+/**
+ * @brief Altura interpolada entre os centros das células.
+ */
+float GnssHeightSource::height(float worldX, float worldZ) const
+{
+    QReadLocker locker(&m_lock);
+    BlockCursor cursor;
+    return bilinear(worldX, worldZ, cursor, nullptr, nullptr);
+}
+
+/**
+ * @brief Altura e derivadas exatas da interpolação bilinear.
+ */
+float GnssHeightSource::heightAndDerivatives(float worldX, float worldZ, float& dHeightDx, float& dHeightDz) const
+{
+    QReadLocker locker(&m_lock);
+    BlockCursor cursor;
+    return bilinear(worldX, worldZ, cursor, &dHeightDx, &dHeightDz);
+}
+
+/**
+ * @brief Avalia uma linha de pontos com uma única aquisição da trava.
+ */
+void GnssHeightSource::heightRow(float startX, float stepX, float worldZ, int count, float* outHeights) const
+{
+    QReadLocker locker(&m_lock);
+    BlockCursor cursor;
+    for (int i = 0; i < count; ++i) {
+        outHeights[i] = bilinear(startX + static_cast<float>(i) * stepX, worldZ, cursor, nullptr, nullptr);
+    }
+}
+
+/**
+ * @brief Funde uma altitude do GNSS na grade.
+ * @param worldX Coordenada X do mundo da antena.
+ * @param worldZ Coordenada Z do mundo da antena.
+ * @param altitude Altitude medida, em metros.
+ * @param verticalSigma Desvio padrão vertical, em metros.
+ * @return false se a amostra foi rejeitada.
+ *
+ * A amostra é espalhada nas células a até `splatRadius` células da posição, com um núcleo
+ * que cai suavemente com a distância: o custo é fixo ((2R+1)² células). A altura no ponto
+ * e a média do bloco são comparadas antes e depois; só uma mudança acima do limiar marca
+ * os chunks da área afetada para regeneração.
+ */
+bool GnssHeightSource::addSample(float worldX, float worldZ, double altitude, float verticalSigma)
+{
+    if (!(verticalSigma > 0.0f) || !std::isfinite(altitude) || !std::isfinite(worldX) || !std::isfinite(worldZ)) {
+        ++m_rejectedSamples;
+        return false;
+    }
+    const float weight = 1.0f / (verticalSigma * verticalSigma);
+
+    float pointBefore, pointAfter, blockBefore, blockAfter;
+    {
+        QWriteLocker locker(&m_lock);
+        if (!m_hasReference) {
+            m_referenceAltitude = altitude;
+            m_hasReference = true;
+        }
+        const float sampleHeight = static_cast<float>(altitude - m_referenceAltitude);
+
+        const int centerX = static_cast<int>(std::floor(worldX / m_cellSize));
+        const int centerZ = static_cast<int>(std::floor(worldZ / m_cellSize));
+        std::unique_ptr<Block>& home = m_blocks[blockKey(blockIndex(centerX), blockIndex(centerZ))];
+        if (!home) {
+            home = std::make_unique<Block>();
+        }
+        Block* homeBlock = home.get();
+
+        BlockCursor cursor;
+        pointBefore = bilinear(worldX, worldZ, cursor, nullptr, nullptr);
+        blockBefore = blockEstimate(homeBlock);
+
+        homeBlock->sumWeight += weight;
+        homeBlock->sumWeightedHeight += static_cast<double>(weight) * sampleHeight;
+
+        // Espalhamento: núcleo (1 - (d / (R + 1))²)², em unidades de célula.
+        const float cellX = worldX / m_cellSize;
+        const float cellZ = worldZ / m_cellSize;
+        const float reach = static_cast<float>(m_splatRadius + 1);
+        quint64 lastKey = 0;
+        Block* block = nullptr;
+        for (int dz = -m_splatRadius; dz <= m_splatRadius; ++dz) {
+            for (int dx = -m_splatRadius; dx <= m_splatRadius; ++dx) {
+                const int cx = centerX + dx;
+                const int cz = centerZ + dz;
+                const float ox = (static_cast<float>(cx) + 0.5f) - cellX;
+                const float oz = (static_cast<float>(cz) + 0.5f) - cellZ;
+                float kernel = 1.0f - (ox * ox + oz * oz) / (reach * reach);
+                if (kernel <= 0.0f) {
+                    continue;
+                }
+                kernel *= kernel;
+
+                const quint64 key = blockKey(blockIndex(cx), blockIndex(cz));
+                if (!block || key != lastKey) {
+                    std::unique_ptr<Block>& slot = m_blocks[key];
+                    if (!slot) {
+                        slot = std::make_unique<Block>();
+                    }
+                    block = slot.get();
+                    lastKey = key;
+                }
+                const int index = (cz - blockIndex(cz) * BLOCK_CELLS) * BLOCK_CELLS + (cx - blockIndex(cx) * BLOCK_CELLS);
+                block->weight[index] += weight * kernel;
+                block->weightedHeight[index] += weight * kernel * sampleHeight;
+            }
+        }
+
+        cursor = BlockCursor();
+        pointAfter = bilinear(worldX, worldZ, cursor, nullptr, nullptr);
+        blockAfter = blockEstimate(homeBlock);
+    }
+    ++m_samples;
+
+    // As células alteradas influenciam a interpolação até uma célula além do raio.
+    if (std::abs(pointAfter - pointBefore) > m_dirtyThreshold) {
+        const float margin = static_cast<float>(m_splatRadius + 2) * m_cellSize;
+        markDirty(worldX - margin, worldZ - margin, worldX + margin, worldZ + margin);
+    }
+    // A média do bloco é a altura das suas células ainda não visitadas. Ela só muda com as
+    // amostras do próprio bloco (fora dos blocos visitados a altura é fixa), então esta
+    // verificação cobre todo o terreno cuja altura pode ter mudado.
+    if (std::abs(blockAfter - blockBefore) > m_dirtyThreshold) {
+        const int centerX = static_cast<int>(std::floor(worldX / m_cellSize));
+        const int centerZ = static_cast<int>(std::floor(worldZ / m_cellSize));
+        const float minX = static_cast<float>(blockIndex(centerX) * BLOCK_CELLS - 1) * m_cellSize;
+        const float minZ = static_cast<float>(blockIndex(centerZ) * BLOCK_CELLS - 1) * m_cellSize;
+        const float extent = static_cast<float>(BLOCK_CELLS + 2) * m_cellSize;
+        markDirty(minX, minZ, minX + extent, minZ + extent);
+    }
+    return true;
+}
+
+/**
+ * @brief Entrega e limpa a lista de chunks a regenerar.
+ * @param outChunks Recebe os chunks (chunkX, chunkZ).
+ */
+void GnssHeightSource::takeDirtyChunks(std::vector<std::pair<int, int>>& outChunks)
+{
+    outChunks.clear();
+    outChunks.reserve(m_dirtyChunks.size());
+    for (quint64 key : m_dirtyChunks) {
+        outChunks.emplace_back(static_cast<qint32>(key >> 32), static_cast<qint32>(key & 0xffffffffu));
+    }
+    m_dirtyChunks.clear();
+}
+
+/**
+ * @brief Estima o desvio padrão vertical de uma posição.
+ * @param fixQuality Qualidade do fix (GGA).
+ * @param hdop Diluição horizontal da precisão.
+ * @return O desvio, em metros, ou 0 se a posição não deve ser usada.
+ *
+ * Valores típicos de erro vertical por tipo de solução, escalados pelo HDOP quando ele
+ * passa de 1 (a geometria ruim dos satélites piora também a altitude).
+ */
+float GnssHeightSource::verticalSigma(int fixQuality, float hdop)
+{
+    float sigma;
+    switch (fixQuality) {
+    case 4: sigma = 0.03f; break; // RTK fixo.
+    case 5: sigma = 0.30f; break; // RTK flutuante.
+    case 2: sigma = 1.0f; break;  // DGPS.
+    case 1: sigma = 3.0f; break;  // GPS autônomo.
+    default: return 0.0f;         // Sem fix (ou estimado): não usar.
+    }
+    if (hdop > 1.0f && hdop < 99.0f) {
+        sigma *= hdop;
+    }
+    return sigma;
+}
+
+/**
+ * @brief Retorna quantos blocos da grade já foram alocados.
+ */
+int GnssHeightSource::blocks() const
+{
+    QReadLocker locker(&m_lock);
+    return static_cast<int>(m_blocks.size());
+}
+
+/**
+ * @brief Chave de um bloco no mapa.
+ */
+quint64 GnssHeightSource::blockKey(int blockX, int blockZ)
+{
+    return (static_cast<quint64>(static_cast<quint32>(blockX)) << 32) | static_cast<quint32>(blockZ);
+}
+
+/**
+ * @brief Índice do bloco de uma célula (divisão arredondada para baixo, também nos negativos).
+ */
+int GnssHeightSource::blockIndex(int cell)
+{
+    return (cell >= 0 ? cell : cell - (BLOCK_CELLS - 1)) / BLOCK_CELLS;
+}
+
+/**
+ * @brief Retorna o bloco de uma célula, reaproveitando o último encontrado.
+ */
+const GnssHeightSource::Block* GnssHeightSource::findBlock(int cellX, int cellZ, BlockCursor& cursor) const
+{
+    const quint64 key = blockKey(blockIndex(cellX), blockIndex(cellZ));
+    if (!cursor.valid || key != cursor.key) {
+        auto found = m_blocks.find(key);
+        cursor.valid = true;
+        cursor.key = key;
+        cursor.block = (found != m_blocks.end()) ? found->second.get() : nullptr;
+    }
+    return cursor.block;
+}
+
+/**
+ * @brief Altura média de um bloco, puxada para zero (a altitude de referência).
+ */
+float GnssHeightSource::blockEstimate(const Block* block) const
+{
+    return static_cast<float>(block->sumWeightedHeight / (block->sumWeight + PRIOR_WEIGHT));
+}
+
+/**
+ * @brief Altura de uma célula: sem bloco, zero; com pouco peso, perto da média do bloco.
+ */
+float GnssHeightSource::cellEstimate(int cellX, int cellZ, BlockCursor& cursor) const
+{
+    const Block* block = findBlock(cellX, cellZ, cursor);
+    if (!block) {
+        return 0.0f; // Área não visitada: a altitude de referência, que nunca muda.
+    }
+    const int index = (cellZ - blockIndex(cellZ) * BLOCK_CELLS) * BLOCK_CELLS + (cellX - blockIndex(cellX) * BLOCK_CELLS);
+    const float prior = blockEstimate(block);
+    return (block->weightedHeight[index] + PRIOR_WEIGHT * prior) / (block->weight[index] + PRIOR_WEIGHT);
+}
+
+/**
+ * @brief Interpolação bilinear entre os centros das células.
+ */
+float GnssHeightSource::bilinear(float worldX, float worldZ, BlockCursor& cursor, float* dHeightDx, float* dHeightDz) const
+{
+    const float gx = worldX / m_cellSize - 0.5f;
+    const float gz = worldZ / m_cellSize - 0.5f;
+    const float fx0 = std::floor(gx);
+    const float fz0 = std::floor(gz);
+    const int ix = static_cast<int>(fx0);
+    const int iz = static_cast<int>(fz0);
+    const float tx = gx - fx0;
+    const float tz = gz - fz0;
+
+    const float h00 = cellEstimate(ix, iz, cursor);
+    const float h10 = cellEstimate(ix + 1, iz, cursor);
+    const float h01 = cellEstimate(ix, iz + 1, cursor);
+    const float h11 = cellEstimate(ix + 1, iz + 1, cursor);
+
+    if (dHeightDx && dHeightDz) {
+        *dHeightDx = ((h10 - h00) * (1.0f - tz) + (h11 - h01) * tz) / m_cellSize;
+        *dHeightDz = ((h01 - h00) * (1.0f - tx) + (h11 - h10) * tx) / m_cellSize;
+    }
+    const float top = h00 + (h10 - h00) * tx;
+    const float bottom = h01 + (h11 - h01) * tx;
+    return top + (bottom - top) * tz;
+}
+
+/**
+ * @brief Marca os chunks que cruzam um retângulo do mundo.
+ */
+void GnssHeightSource::markDirty(float minX, float minZ, float maxX, float maxZ)
+{
+    const int firstX = static_cast<int>(std::floor(minX / m_chunkSize));
+    const int firstZ = static_cast<int>(std::floor(minZ / m_chunkSize));
+    const int lastX = static_cast<int>(std::floor(maxX / m_chunkSize));
+    const int lastZ = static_cast<int>(std::floor(maxZ / m_chunkSize));
+    for (int z = firstZ; z <= lastZ; ++z) {
+        for (int x = firstX; x <= lastX; ++x) {
+            m_dirtyChunks.insert(blockKey(x, z)); // Mesma chave de 64 bits dos blocos: (x, z).
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#ifndef GNSSHEIGHTSOURCE_H
+#define GNSSHEIGHTSOURCE_H
+
+#include "heightsource.h"     // Interface implementada por esta classe.
+#include <QReadWriteLock>     // Leitura concorrente pelos workers, escrita pela thread principal.
+#include <QtGlobal>           // Para quint64.
+#include <memory>             // Para std::unique_ptr (blocos de células).
+#include <unordered_map>      // Grade esparsa: só os blocos já visitados existem.
+#include <unordered_set>      // Conjunto de chunks a regenerar, sem repetições.
+#include <utility>            // Para std::pair (coordenadas de chunk).
+#include <vector>             // Para a lista de chunks entregue ao gerenciador.
+
+// Classe: GnssHeightSource
+// Descrição: Modelo de elevação construído durante o trabalho a partir das altitudes do GNSS
+//            (GGA) ao longo das passadas do trator. Cada amostra é espalhada nas células de uma
+//            grade esparsa ao redor da posição, com peso pelo inverso da variância vertical
+//            (uma amostra RTK fixo vale muito mais que uma DGPS). Em cada célula a altura é a
+//            média ponderada das amostras, puxada para a média do seu bloco (e esta para zero)
+//            onde há pouco dado: entre passadas próximas a altura é interpolada, e dentro de um
+//            bloco visitado ela é extrapolada pela média do bloco.
+//            As alturas são relativas à altitude da primeira amostra, que é também a altura fixa
+//            das áreas ainda não visitadas: uma referência que mudasse a cada amostra moveria
+//            todo o terreno já gerado (e as malhas do cache), deixando costuras entre os chunks.
+//            `addSample` custa O(1) (um número fixo de células por amostra) e registra os chunks
+//            cuja altura mudou, para que só eles sejam regenerados (`takeDirtyChunks`).
+//            `addSample` e `takeDirtyChunks` são chamados na thread principal; a consulta das
+//            alturas é segura nas threads de worker.
+class GnssHeightSource : public HeightSource {
+public:
+    // Construtor: GnssHeightSource
+    // Parâmetros:
+    //   - cellSize: Lado de cada célula da grade, em metros.
+    //   - splatRadius: Raio, em células, em que cada amostra é espalhada (define até onde a
+    //                  altura é interpolada entre passadas vizinhas).
+    //   - chunkSize: Lado de um chunk do terreno, em metros (para os chunks a regenerar).
+    //   - dirtyThreshold: Mudança mínima de altura, em metros, para um chunk ser regenerado.
+    GnssHeightSource(float cellSize, int splatRadius, float chunkSize, float dirtyThreshold);
+
+    // Impedir Cópias (Deletadas): a grade pode ser grande.
+    GnssHeightSource(const GnssHeightSource&) = delete;
+    GnssHeightSource& operator=(const GnssHeightSource&) = delete;
+
+    // Métodos da interface HeightSource (ver heightsource.h).
+    float height(float worldX, float worldZ) const override;
+    float heightAndDerivatives(float worldX, float worldZ, float& dHeightDx, float& dHeightDz) const override;
+    void heightRow(float startX, float stepX, float worldZ, int count, float* outHeights) const override;
+
+    // Método: addSample
+    // Descrição: Funde uma altitude do GNSS na grade e marca os chunks afetados.
+    // Parâmetros:
+    //   - worldX: Coordenada X do mundo da antena.
+    //   - worldZ: Coordenada Z do mundo da antena.
+    //   - altitude: Altitude medida, em metros.
+    //   - verticalSigma: Desvio padrão vertical da medida, em metros (ver `verticalSigma`).
+    // Retorno: bool - false se a amostra foi rejeitada (sem fix ou desvio inválido).
+    bool addSample(float worldX, float worldZ, double altitude, float verticalSigma);
+
+    // Método: takeDirtyChunks
+    // Descrição: Entrega os chunks (chunkX, chunkZ) cuja altura mudou desde a última chamada.
+    // Parâmetros:
+    //   - outChunks: Recebe os chunks (o conteúdo anterior é substituído).
+    void takeDirtyChunks(std::vector<std::pair<int, int>>& outChunks);
+
+    // Método Estático: verticalSigma
+    // Descrição: Estima o desvio padrão vertical de uma posição a partir da qualidade do fix
+    //            (GGA) e do HDOP. O erro vertical do GNSS é maior que o horizontal.
+    // Parâmetros:
+    //   - fixQuality: Qualidade do fix (1 = GPS, 2 = DGPS, 4 = RTK fixo, 5 = RTK flutuante).
+    //   - hdop: Diluição horizontal da precisão.
+    // Retorno: float - O desvio em metros, ou 0 se a posição não deve ser usada.
+    static float verticalSigma(int fixQuality, float hdop);
+
+    // Métodos de diagnóstico.
+    int samples() const { return m_samples; }
+    int rejectedSamples() const { return m_rejectedSamples; }
+    int blocks() const;
+
+private:
+    // Constante: BLOCK_CELLS
+    // Descrição: Lado de um bloco da grade esparsa, em células.
+    static constexpr int BLOCK_CELLS = 16;
+
+    // Estrutura: Block
+    // Descrição: Um bloco de BLOCK_CELLS x BLOCK_CELLS células, alocado na primeira amostra
+    //            que o atinge. Cada célula guarda a soma dos pesos e a soma ponderada das
+    //            alturas; o bloco guarda as mesmas somas das amostras que caíram nele.
+    struct Block {
+        float weight[BLOCK_CELLS * BLOCK_CELLS] = {};
+        float weightedHeight[BLOCK_CELLS * BLOCK_CELLS] = {};
+        double sumWeight = 0.0;
+        double sumWeightedHeight = 0.0;
+    };
+
+    // Estrutura: BlockCursor
+    // Descrição: Último bloco consultado, para que pontos vizinhos não repitam a busca no mapa.
+    struct BlockCursor {
+        bool valid = false;
+        quint64 key = 0;
+        const Block* block = nullptr;
+    };
+
+    static quint64 blockKey(int blockX, int blockZ);
+    static int blockIndex(int cell);
+
+    // Método Privado: findBlock
+    // Descrição: Retorna o bloco que contém uma célula, ou nulo se ele não existe.
+    const Block* findBlock(int cellX, int cellZ, BlockCursor& cursor) const;
+
+    // Método Privado: blockEstimate
+    // Descrição: Altura média de um bloco, puxada para zero (a altitude de referência) conforme o seu peso.
+    float blockEstimate(const Block* block) const;
+
+    // Método Privado: cellEstimate
+    // Descrição: Altura de uma célula, puxada para a média do seu bloco conforme o seu peso.
+    float cellEstimate(int cellX, int cellZ, BlockCursor& cursor) const;
+
+    // Método Privado: bilinear
+    // Descrição: Interpolação bilinear entre os centros das células, com as derivadas opcionais.
+    //            Deve ser chamada com a trava de leitura (ou de escrita) adquirida.
+    float bilinear(float worldX, float worldZ, BlockCursor& cursor, float* dHeightDx, float* dHeightDz) const;
+
+    // Método Privado: markDirty
+    // Descrição: Marca os chunks que cruzam um retângulo do mundo.
+    void markDirty(float minX, float minZ, float maxX, float maxZ);
+
+    // Membros de configuração (constantes após a construção).
+    float m_cellSize;
+    int m_splatRadius;
+    float m_chunkSize;
+    float m_dirtyThreshold;
+
+    // Membro: m_lock
+    // Tipo: mutable QReadWriteLock
+    // Descrição: Protege a grade: escrita em `addSample`, leitura nas consultas dos workers.
+    mutable QReadWriteLock m_lock;
+
+    // Membro: m_blocks
+    // Tipo: std::unordered_map<quint64, std::unique_ptr<Block>>
+    // Descrição: Os blocos já visitados, pela chave (blockX, blockZ).
+    std::unordered_map<quint64, std::unique_ptr<Block>> m_blocks;
+
+    // Membro: m_referenceAltitude
+    // Tipo: double
+    // Descrição: Altitude da primeira amostra, que define a altura zero do terreno.
+    double m_referenceAltitude;
+    bool m_hasReference;
+
+    // Membro: m_dirtyChunks
+    // Tipo: std::unordered_set<quint64>
+    // Descrição: Chunks a regenerar (só acessado na thread principal).
+    std::unordered_set<quint64> m_dirtyChunks;
+
+    // Membros de diagnóstico (thread principal).
+    int m_samples;
+    int m_rejectedSamples;
+};
+
+#endif // GNSSHEIGHTSOURCE_H
@@ -0,0 +1,56 @@
+#ifndef HEIGHTSOURCE_H
+#define HEIGHTSOURCE_H
+
+// Classe: HeightSource
+// Descrição: Interface de uma fonte de alturas do terreno, consultada por NoiseUtils::getHeight
+//            (e pelas funções em lote) no lugar do ruído procedural quando registrada com
+//            NoiseUtils::setHeightSource. Permite usar o relevo real da fazenda (um modelo
+//            digital de elevação, por exemplo) sem mudar a geração de malha dos chunks.
+//            As implementações devem ser seguras para leitura concorrente: as threads de
+//            worker consultam a fonte ao mesmo tempo.
+class HeightSource {
+public:
+    virtual ~HeightSource() = default;
+
+    // Método: height
+    // Descrição: Retorna a altura do terreno em uma coordenada do mundo.
+    // Parâmetros:
+    //   - worldX: Coordenada X no espaço do mundo.
+    //   - worldZ: Coordenada Z no espaço do mundo.
+    // Retorno: float - A altura, em metros.
+    virtual float height(float worldX, float worldZ) const = 0;
+
+    // Método: heightAndDerivatives
+    // Descrição: Retorna a altura e suas derivadas parciais em X e em Z. A implementação padrão
+    //            usa diferenças centrais de 0.1 m; as fontes que têm derivadas exatas a sobrescrevem.
+    // Parâmetros:
+    //   - worldX: Coordenada X no espaço do mundo.
+    //   - worldZ: Coordenada Z no espaço do mundo.
+    //   - dHeightDx: Recebe a inclinação da altura em X.
+    //   - dHeightDz: Recebe a inclinação da altura em Z.
+    // Retorno: float - A altura, em metros.
+    virtual float heightAndDerivatives(float worldX, float worldZ, float& dHeightDx, float& dHeightDz) const {
+        const float offset = 0.1f;
+        dHeightDx = (height(worldX + offset, worldZ) - height(worldX - offset, worldZ)) / (2.0f * offset);
+        dHeightDz = (height(worldX, worldZ + offset) - height(worldX, worldZ - offset)) / (2.0f * offset);
+        return height(worldX, worldZ);
+    }
+
+    // Método: heightRow
+    // Descrição: Avalia uma linha de pontos igualmente espaçados em X (uma linha da grade de um
+    //            chunk). O espaçamento permite à fonte escolher a resolução adequada dos dados.
+    //            A implementação padrão chama `height` ponto a ponto.
+    // Parâmetros:
+    //   - startX: Coordenada X do primeiro ponto.
+    //   - stepX: Distância em X entre pontos vizinhos.
+    //   - worldZ: Coordenada Z de toda a linha.
+    //   - count: Número de pontos.
+    //   - outHeights: Destino das alturas (count valores).
+    virtual void heightRow(float startX, float stepX, float worldZ, int count, float* outHeights) const {
+        for (int i = 0; i < count; ++i) {
+            outHeights[i] = height(startX + static_cast<float>(i) * stepX, worldZ);
+        }
+    }
+};
+
+#endif // HEIGHTSOURCE_H
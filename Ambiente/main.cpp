@@ -2,9 +2,9 @@
 #include <QSurfaceFormat> // Inclui QSurfaceFormat para configurar o formato da superfície de renderização OpenGL.
 #include <QApplication> // Inclui QApplication, a classe que gerencia o loop de eventos da aplicação Qt.
 #include <QDebug> // Inclui QDebug para mensagens de depuração (qInfo, qWarning, etc.).
-#include "chunk.h" // Inclui o cabeçalho da classe chunk, necessário para registrar o tipo MeshData.
 #include "speedcontroller.h"
 #include "logger.h"
+#include "demheightsource.h" // Para o modo de conversão de DEM (--convert-dem).
 #include <QApplication>
 #include <QDebug>
 
@@ -20,6 +20,21 @@
  */
 int main(int argc, char *argv[])
 {
+    // Modo de conversão (sem interface): Ambiente --convert-dem <entrada.asc> <saida.dem>
+    // Prepara, fora do equipamento, o DEM em tiles lido por DemHeightSource.
+    if (argc >= 2 && qstrcmp(argv[1], "--convert-dem") == 0) {
+        if (argc < 4) {
+            qWarning() << "Uso:" << argv[0] << "--convert-dem <entrada.asc> <saida.dem>";
+            return 1;
+        }
+        QString error;
+        if (!DemHeightSource::convertAsciiGrid(QString::fromLocal8Bit(argv[2]), QString::fromLocal8Bit(argv[3]), 256, &error)) {
+            qWarning() << "Falha na conversao do DEM:" << error;
+            return 1;
+        }
+        return 0;
+    }
+
     // Cria uma instância da QApplication.
     // Esta linha é essencial para qualquer aplicação Qt, pois ela inicializa o sistema de eventos
     // e gerencia os recursos da aplicação.
@@ -43,10 +58,6 @@ int main(int argc, char *argv[])
     Logger::getInstance().setLogToFile(true, "gps_monitor_log.txt"); //Salve em um arquivo especifico no diretorio de aplicação
 
 
-    // Registra o tipo customizado 'chunk::MeshData' no sistema de metadados do Qt.
-    // Isso é crucial para que o Qt possa passar objetos desse tipo através de conexões de sinais e slots
-    // que cruzam limites de thread (Qt::QueuedConnection), como é o caso entre ChunkWorker e TerrainManager.
-    qRegisterMetaType<chunk::MeshData>("chunk::MeshData");
     qRegisterMetaType<GpsData>("GpsData"); // registrar o noovo metatype
 
     // Cria e configura um objeto QSurfaceFormat.
@@ -9,6 +9,7 @@
 #include <QTime> // Inclui QTime, embora QElapsedTimer seja preferido para medição de tempo.
 #include <QElapsedTimer> // Inclui QElapsedTimer para medições de tempo precisas (FPS, temp).
 #include <cmath> // Inclui cmath para funções matemáticas como sin, cos, etc.
+#include <algorithm> // Para std::max e std::copy.
 #include "logger.h"
 #include "terraingrid.h"
 #include <QPainter>
@@ -18,59 +19,219 @@
 // Estes blocos de string R"(...)" contêm o código-fonte GLSL para os shaders.
 // Eles são compilados e linkados em tempo de execução.
 
+// Bloco de uniformes da cena (std140), comum a todos os shaders. O conteúdo é gravado uma vez por
+// quadro no UBO ligado ao ponto SCENE_UNIFORM_BINDING (ver SceneMatrices em myglwidget.h, que
+// espelha este layout). As precisões são explícitas porque um bloco usado no vertex e no
+// fragment shader precisa ser declarado igual nos dois.
+#define SCENE_UNIFORM_BLOCK \
+    "layout(std140) uniform SceneBlock {\n" \
+    "    highp mat4 viewMatrix;           // Matriz de visão da câmera.\n" \
+    "    highp mat4 projectionMatrix;     // Matriz de projeção da câmera.\n" \
+    "    highp mat4 viewProjectionMatrix; // projectionMatrix * viewMatrix.\n" \
+    "    highp vec4 cameraPosition;       // Posição da câmera no mundo (xyz).\n" \
+    "    highp vec4 lightDirection;       // Direção da luz do sol (xyz).\n" \
+    "    highp vec4 lightColor;           // Cor da luz (rgb).\n" \
+    "};\n"
+
 // Shader de Vértices para o Terreno
-const char* terrainVertexShaderSource = R"(#version 300 es
+const char* terrainVertexShaderSource = "#version 300 es\n" SCENE_UNIFORM_BLOCK R"(
 // Terrain Vertex Shader - TESTE_VERSAO_NOVA_SHADER_04_06_2025
 
 layout (location = 0) in vec3 a_position; // Atributo de entrada: posição do vértice (location 0).
 layout (location = 1) in vec3 a_normal;   // Atributo de entrada: normal do vértice (location 1).
+layout (location = 2) in float a_morphHeight; // Altura do vértice na malha do próximo nível de LOD.
 
-uniform mat4 projectionMatrix; // Matriz de projeção da câmera.
-uniform mat4 viewMatrix;       // Matriz de visão da câmera.
 uniform mat4 modelMatrix;      // Matriz de modelo do objeto (chunk).
+uniform int batchVertexCount;  // Desenho em lote: vértices por chunk (0 = um chunk por desenho, com modelMatrix).
+uniform vec4 chunkOrigins[128]; // Desenho em lote: canto (x, z) e altura de referência (z) do chunk
+                                // de cada slot da página (TerrainBatchBuffers::MAX_SLOTS_PER_PAGE).
+uniform vec2 morphRange;       // Faixa de morphing do nível do chunk: (início, 1 / (fim - início)).
 
 out vec3 v_worldPos; // Saída para o fragment shader: posição do vértice no espaço do mundo.
 out vec3 v_normal;   // Saída para o fragment shader: normal do vértice no espaço do mundo.
 
+// Posição no mundo de um ponto do chunk. No desenho em lote, o slot do chunk na página sai do
+// índice do vértice (o EBO da página desloca cada slot de batchVertexCount vértices).
+vec4 chunkToWorld(vec3 localPos) {
+    if (batchVertexCount > 0) {
+        vec4 origin = chunkOrigins[gl_VertexID / batchVertexCount];
+        return vec4(localPos.x + origin.x, localPos.y + origin.z, localPos.z + origin.y, 1.0);
+    }
+    return modelMatrix * vec4(localPos, 1.0);
+}
+
 void main() {
     // Calcula a posição do vértice no espaço do mundo.
-    // Multiplica a posição do vértice pela matriz de modelo para transformar do espaço do modelo para o espaço do mundo.
-    vec4 worldPos4 = modelMatrix * vec4(a_position, 1.0);
+    // Soma a origem do chunk (matriz de modelo ou, no desenho em lote, a origem do slot).
+    vec4 worldPos4 = chunkToWorld(a_position);
+    // Morphing (CDLOD): dentro da faixa, o vértice desce/sobe até a superfície do próximo nível,
+    // de modo que a troca de nível acontece sem salto visível.
+    float morph = clamp((distance(worldPos4.xyz, cameraPosition.xyz) - morphRange.x) * morphRange.y, 0.0, 1.0);
+    worldPos4.y += (a_morphHeight - a_position.y) * morph;
     // Calcula a posição final do vértice no espaço de corte (clip space).
-    // Multiplica pela matriz de projeção e visão para transformar do espaço do mundo para o espaço da tela.
-    gl_Position = projectionMatrix * viewMatrix * worldPos4;
+    // A matriz projeção * visão (calculada uma vez por quadro) leva do espaço do mundo para o espaço da tela.
+    gl_Position = viewProjectionMatrix * worldPos4;
     v_worldPos = worldPos4.xyz; // Passa a posição do mundo para o fragment shader.
-    // Calcula a normal no espaço do mundo, aplicando a parte de rotação da matriz de modelo
-    // e normalizando o resultado para garantir que o vetor mantenha seu comprimento unitário.
-    v_normal = normalize(mat3(modelMatrix) * a_normal);
+    // A matriz de modelo dos chunks é só uma translação: a normal local já é a do mundo.
+    v_normal = normalize(a_normal);
+}
+)";
+
+// Shader de Vértices para o Terreno no formato compacto (WorldConfig::compactTerrainVertices)
+// Reconstrói a posição local a partir da coluna/linha na grade e da altura quantizada,
+// e decodifica a normal em octaedro. A saída é a mesma do shader de vértices padrão.
+const char* terrainCompactVertexShaderSource = "#version 300 es\n" SCENE_UNIFORM_BLOCK R"(
+
+layout (location = 0) in vec2 a_grid;       // Coluna/linha do vértice na grade do chunk.
+layout (location = 1) in vec2 a_octNormal;  // Normal codificada em octaedro, em [-1, 1].
+layout (location = 2) in float a_height;    // Altura quantizada (inteiro em float).
+layout (location = 3) in float a_morphHeight; // Altura quantizada no próximo nível de LOD.
+
+uniform mat4 modelMatrix;      // Matriz de modelo do objeto (chunk).
+uniform int batchVertexCount;  // Desenho em lote: vértices por chunk (0 = um chunk por desenho, com modelMatrix).
+uniform vec4 chunkOrigins[128]; // Desenho em lote: canto (x, z) e altura de referência (z) do chunk
+                                // de cada slot da página (TerrainBatchBuffers::MAX_SLOTS_PER_PAGE).
+uniform float gridStep;        // Distância entre vértices vizinhos da grade (por chunk).
+uniform float heightStep;      // Metros por unidade da altura quantizada.
+uniform vec2 morphRange;       // Faixa de morphing do nível do chunk: (início, 1 / (fim - início)).
+
+out vec3 v_worldPos; // Saída para o fragment shader: posição do vértice no espaço do mundo.
+out vec3 v_normal;   // Saída para o fragment shader: normal do vértice no espaço do mundo.
+
+// Decodifica uma normal codificada em octaedro (o eixo Y é o do hemisfério dobrado).
+vec3 decodeOctNormal(vec2 e) {
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0) {
+        vec2 signs = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.z >= 0.0 ? 1.0 : -1.0);
+        n.xz = (1.0 - abs(n.zx)) * signs;
+    }
+    return normalize(n);
+}
+
+// Posição no mundo de um ponto do chunk. No desenho em lote, o slot do chunk na página sai do
+// índice do vértice (o EBO da página desloca cada slot de batchVertexCount vértices).
+vec4 chunkToWorld(vec3 localPos) {
+    if (batchVertexCount > 0) {
+        vec4 origin = chunkOrigins[gl_VertexID / batchVertexCount];
+        return vec4(localPos.x + origin.x, localPos.y + origin.z, localPos.z + origin.y, 1.0);
+    }
+    return modelMatrix * vec4(localPos, 1.0);
+}
+
+void main() {
+    vec3 localPos = vec3(a_grid.x * gridStep, a_height * heightStep, a_grid.y * gridStep);
+    vec4 worldPos4 = chunkToWorld(localPos);
+    float morph = clamp((distance(worldPos4.xyz, cameraPosition.xyz) - morphRange.x) * morphRange.y, 0.0, 1.0);
+    worldPos4.y += (a_morphHeight - a_height) * heightStep * morph;
+    gl_Position = viewProjectionMatrix * worldPos4;
+    v_worldPos = worldPos4.xyz;
+    v_normal = decodeOctNormal(a_octNormal); // Chunks só são transladados.
+}
+)";
+
+// Shader de Vértices para o Terreno no modo heightmap (WorldConfig::heightTextureTerrain)
+// Não há atributos de vértice: gl_VertexID (vindo do buffer de índices compartilhado) dá a
+// coluna/linha na grade, a altura vem da textura e a normal de diferenças centrais entre os
+// texels vizinhos (a textura tem uma amostra de borda de cada lado).
+const char* terrainHeightmapVertexShaderSource = "#version 300 es\n" SCENE_UNIFORM_BLOCK R"(
+
+uniform mat4 modelMatrix;      // Matriz de modelo do objeto (chunk).
+uniform float gridStep;        // Distância entre vértices vizinhos da grade (por chunk).
+uniform int gridResolution;    // Vértices por lado da malha do chunk.
+uniform highp sampler2D heightMap; // Alturas do chunk, (gridResolution + 2)² texels.
+uniform vec2 morphRange;       // Faixa de morphing do nível do chunk: (início, 1 / (fim - início)).
+uniform int morphRatio;        // Quantas vezes o próximo nível de LOD é mais grosso (1 no último).
+
+out vec3 v_worldPos; // Saída para o fragment shader: posição do vértice no espaço do mundo.
+out vec3 v_normal;   // Saída para o fragment shader: normal do vértice no espaço do mundo.
+
+float heightAt(ivec2 texel) {
+    return texelFetch(heightMap, texel, 0).r;
+}
+
+void main() {
+    ivec2 cell = ivec2(gl_VertexID % gridResolution, gl_VertexID / gridResolution);
+    ivec2 texel = cell + ivec2(1, 1); // Pula a borda.
+
+    float h = heightAt(texel);
+    float hL = heightAt(texel - ivec2(1, 0));
+    float hR = heightAt(texel + ivec2(1, 0));
+    float hD = heightAt(texel - ivec2(0, 1));
+    float hU = heightAt(texel + ivec2(0, 1));
+    vec3 normal = normalize(vec3(hL - hR, 2.0 * gridStep, hD - hU));
+
+    // Altura no próximo nível de LOD: sobre um dos triângulos (divididos pela diagonal
+    // topRight-bottomLeft) do quadrado do nível mais grosso em que o vértice cai.
+    int coarseCells = (gridResolution - 1) / morphRatio;
+    ivec2 coarse = min(cell / morphRatio, ivec2(coarseCells - 1)) * morphRatio + ivec2(1, 1);
+    vec2 f = vec2(texel - coarse) / float(morphRatio);
+    float hTR = heightAt(coarse + ivec2(morphRatio, 0));
+    float hBL = heightAt(coarse + ivec2(0, morphRatio));
+    float morphHeight;
+    if (f.x + f.y <= 1.0) {
+        float hTL = heightAt(coarse);
+        morphHeight = hTL + (hTR - hTL) * f.x + (hBL - hTL) * f.y;
+    } else {
+        float hBR = heightAt(coarse + ivec2(morphRatio, morphRatio));
+        morphHeight = hBR + (hBL - hBR) * (1.0 - f.x) + (hTR - hBR) * (1.0 - f.y);
+    }
+
+    vec3 localPos = vec3(float(cell.x) * gridStep, h, float(cell.y) * gridStep);
+    vec4 worldPos4 = modelMatrix * vec4(localPos, 1.0);
+    float morph = clamp((distance(worldPos4.xyz, cameraPosition.xyz) - morphRange.x) * morphRange.y, 0.0, 1.0);
+    worldPos4.y += (morphHeight - h) * morph;
+    gl_Position = viewProjectionMatrix * worldPos4;
+    v_worldPos = worldPos4.xyz;
+    v_normal = normalize(mat3(modelMatrix) * normal);
 }
 )";
 
 // Shader de Fragmentos para o Terreno
-const char* terrainFragmentShaderSource = R"(#version 300 es
+const char* terrainFragmentShaderSource = "#version 300 es\n" SCENE_UNIFORM_BLOCK R"(
 // Terrain Fragment Shader - TESTE_VERSAO_NOVA_SHADER_04_06_2025
 
 precision mediump float; // Define a precisão padrão para floats.
 
-in vec3 v_worldPos; // Entrada do vertex shader: posição do fragmento no espaço do mundo.
+in highp vec3 v_worldPos; // Entrada do vertex shader: posição do fragmento no espaço do mundo (highp: a grade usa fract()).
 in vec3 v_normal;   // Entrada do vertex shader: normal do fragmento no espaço do mundo.
 
 out vec4 FragColor; // Saída: cor final do fragmento.
 
-uniform vec3 lightDirection; // Direção da luz (geralmente do sol).
-uniform vec3 lightColor;     // Cor da luz.
 uniform vec3 objectBaseColor; // Cor base do objeto (terreno).
 
+// Grade no shader (WorldConfig::shaderTerrainGrid).
+uniform bool gridEnabled;            // Desenha a grade sobre o terreno.
+uniform highp float gridSquareSize;  // Lado de cada quadrado da grade, em metros.
+uniform highp float gridLineWidth;   // Espessura da linha em relação ao quadrado (gridLineThickness / gridSquareSize).
+uniform vec3 gridColor;              // Cor das linhas.
+uniform vec2 gridFade;               // Fade da grade: (início, 1 / (fim - início)).
+
+// Cobertura da grade no fragmento, de 0 a 1. A largura desenhada nunca fica abaixo de um pixel
+// (fwidth) para não cintilar; quando a linha real é mais fina, a intensidade cai na mesma
+// proporção, e onde um pixel cobre vários quadrados vira a média (a largura relativa).
+float gridCoverage(highp vec2 worldXZ) {
+    highp vec2 coord = worldXZ / gridSquareSize;
+    vec2 derivative = fwidth(coord);
+    vec2 lineWidth = vec2(gridLineWidth);
+    vec2 drawWidth = clamp(lineWidth, derivative, vec2(0.5));
+    vec2 lineAA = derivative * 1.5;
+    vec2 distanceToLine = 1.0 - abs(fract(coord) * 2.0 - 1.0); // 0 sobre a linha, 1 no meio do quadrado.
+    vec2 lines = smoothstep(drawWidth + lineAA, drawWidth - lineAA, distanceToLine);
+    lines *= clamp(lineWidth / drawWidth, 0.0, 1.0);
+    lines = mix(lines, lineWidth, clamp(derivative * 2.0 - 1.0, 0.0, 1.0));
+    return mix(lines.x, 1.0, lines.y);
+}
+
 void main() {
     vec3 norm = normalize(v_normal); // Garante que a normal esteja normalizada.
-    vec3 lightDir = normalize(-lightDirection); // A direção da luz é invertida para apontar *para* a luz.
+    vec3 lightDir = normalize(-lightDirection.xyz); // A direção da luz é invertida para apontar *para* a luz.
     // Calcula a componente difusa da iluminação (Lambertian reflection).
     // `max` garante que a luz não seja subtraída quando a normal aponta para longe da luz.
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor; // Cor difusa resultante.
+    vec3 diffuse = diff * lightColor.rgb; // Cor difusa resultante.
 
     float ambientStrength = 0.2; // Intensidade da luz ambiente.
-    vec3 ambient = ambientStrength * lightColor; // Cor ambiente resultante.
+    vec3 ambient = ambientStrength * lightColor.rgb; // Cor ambiente resultante.
 
     // Combina a luz ambiente e difusa e multiplica pela cor base do objeto.
     vec3 resultColor = (ambient + diffuse) * objectBaseColor;
@@ -81,25 +242,29 @@ void main() {
     // Mistura a cor resultante com uma cor marrom/areia, tornando o terreno mais marrom em altitudes mais altas.
     resultColor = mix(resultColor, vec3(0.6, 0.5, 0.3), heightFactor * 0.5);
 
+    // Grade de orientação de 1 m calculada aqui, sem geometria: segue o relevo de todo o terreno visível.
+    if (gridEnabled) {
+        float fade = 1.0 - clamp((distance(v_worldPos, cameraPosition.xyz) - gridFade.x) * gridFade.y, 0.0, 1.0);
+        resultColor = mix(resultColor, gridColor, gridCoverage(v_worldPos.xz) * fade);
+    }
+
     FragColor = vec4(resultColor, 1.0); // Define a cor final do fragmento.
 }
 )";
 
 // Shader de Vértices para Linhas (Bordas de Chunks)
-const char* lineVertexShaderSource = R"(#version 300 es
+const char* lineVertexShaderSource = "#version 300 es\n" SCENE_UNIFORM_BLOCK R"(
 // Line Vertex Shader - TESTE_VERSAO_NOVA_SHADER_04_06_2025
 
 layout (location = 0) in vec3 a_position; // Atributo de entrada: posição do vértice.
 
-uniform mat4 projectionMatrix; // Matriz de projeção da câmera.
-uniform mat4 viewMatrix;       // Matriz de visão da câmera.
 uniform mat4 modelMatrix;      // Matriz de modelo do objeto (chunk).
 
 void main() {
     // Eleva um pouco a posição do vértice para evitar z-fighting com o terreno.
     vec3 elevated_position = a_position + vec3(0.0, 0.2, 0.0);
     // Calcula a posição final do vértice no espaço de corte.
-    gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(elevated_position, 1.0);
+    gl_Position = viewProjectionMatrix * modelMatrix * vec4(elevated_position, 1.0);
 }
 )";
 
@@ -119,16 +284,14 @@ void main() {
 )";
 
 // Shader de Vértices para o Trator
-const char* tractorVertexShaderSource = R"(#version 300 es
+const char* tractorVertexShaderSource = "#version 300 es\n" SCENE_UNIFORM_BLOCK R"(
 layout (location = 0) in vec3 a_position; // Atributo de entrada: posição do vértice do trator.
 
-uniform mat4 projectionMatrix; // Matriz de projeção da câmera.
-uniform mat4 viewMatrix;       // Matriz de visão da câmera.
 uniform mat4 modelMatrix;      // Matriz de modelo do trator.
 
 void main() {
     // Calcula a posição final do vértice do trator no espaço de corte.
-    gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(a_position, 1.0);
+    gl_Position = viewProjectionMatrix * modelMatrix * vec4(a_position, 1.0);
 }
 )";
 
@@ -163,10 +326,9 @@ MyGLWidget::MyGLWidget(const WorldConfig& config, QWidget *parent)
     m_steeringValue(50), // Inicializa o valor de direção (centro).
     m_hasReferenceCoordinate(false), // inicializa como falso
     m_currentHeading(0.0f), // rumo inicial
-    m_immFilter(nullptr)
+    m_simulation(config.simulationRateHz)
 
 {
-    m_immFilter = new immfilter();
     // Conecta o sinal `timeout` do `m_timer` ao slot `gameTick` deste objeto.
     // Isso garante que `gameTick` seja chamado periodicamente para atualizar a lógica do jogo.
     connect(&m_timer, &QTimer::timeout, this, &MyGLWidget::gameTick);
@@ -204,7 +366,13 @@ MyGLWidget::MyGLWidget(const WorldConfig& config, QWidget *parent)
     MY_LOG_INFO("GPS_Input", "Usando reprodução de arquivo GPS (GpsFilePlayer).");
 #endif
 
-    m_gameTickTimer.start();
+    // Governador de qualidade: lê a temperatura do arquivo configurado (sysfs ou um arquivo de teste).
+    m_qualityGovernor = std::make_unique<QualityGovernor>(
+        m_worldConfig, std::make_unique<SysfsThermalSource>(QString::fromUtf8(m_worldConfig.thermalZonePath)));
+    m_governorClock.start();
+
+    // A simulação do trator roda em passo fixo na sua própria thread, independente deste timer.
+    m_simulation.start();
 }
 
 /**
@@ -216,8 +384,11 @@ MyGLWidget::MyGLWidget(const WorldConfig& config, QWidget *parent)
 MyGLWidget::~MyGLWidget() {
     makeCurrent(); // Garante que o contexto OpenGL está ativo para limpeza.
     // Objetos QOpenGL* (shaders, buffers, vao) são limpos por seus destrutores.
-    delete m_immFilter;
-    m_immFilter = nullptr;
+    m_simulation.stop(); // Encerra a thread da simulação antes de destruir o widget.
+    if (m_sceneUniformBuffer != 0) {
+        glDeleteBuffers(1, &m_sceneUniformBuffer); // O UBO da cena é um buffer GL puro (QOpenGLBuffer não tem o tipo UBO).
+        m_sceneUniformBuffer = 0;
+    }
     doneCurrent(); // Libera o contexto OpenGL.
 }
 
@@ -240,8 +411,20 @@ void MyGLWidget::initializeGL() {
     glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade para que objetos mais próximos cubram os mais distantes.
     glClearColor(0.53f, 0.81f, 0.92f, 1.0f); // Define a cor de fundo (céu) como azul claro.
 
+    // O formato compacto de vértice guarda a coluna/linha em 8 bits e usa índices de 16 bits.
+    if (m_worldConfig.compactTerrainVertices && (m_worldConfig.highRes > 256 || m_worldConfig.lowRes > 256)) {
+        MY_LOG_WARNING("Render", "Formato compacto de vértice exige resoluções <= 256. Usando o formato padrão.");
+        m_worldConfig.compactTerrainVertices = false;
+    }
+
     MY_LOG_INFO("Render", "Compilando Terrain Shaders (Versão de Teste 30/06/2025)...");
-    if (!m_terrainShaderProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, terrainVertexShaderSource)) {
+    const char* terrainVertexSource = terrainVertexShaderSource;
+    if (m_worldConfig.heightTextureTerrain) {
+        terrainVertexSource = terrainHeightmapVertexShaderSource;
+    } else if (m_worldConfig.compactTerrainVertices) {
+        terrainVertexSource = terrainCompactVertexShaderSource;
+    }
+    if (!m_terrainShaderProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, terrainVertexSource)) {
         MY_LOG_ERROR("Render", QString("Terrain Vertex Shader Compilation Error: %1").arg(m_terrainShaderProgram.log()));
     }
     if (!m_terrainShaderProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, terrainFragmentShaderSource)) {
@@ -266,8 +449,11 @@ void MyGLWidget::initializeGL() {
         MY_LOG_INFO("Render", "Line Shaders linked successfully.");
     }
 
-    m_terrainGrid.init(&m_worldConfig, this);
+    if (!m_worldConfig.shaderTerrainGrid) {
+        m_terrainGrid.init(&m_worldConfig, this); // Com a grade no shader, nenhum buffer de linhas é criado.
+    }
     setupTractorGL(); // Configura os shaders, VAO e VBO para o trator.
+    setupSceneUniformBuffer(); // Liga os três programas ao UBO da cena.
     // Inicializa o TerrainManager, passando a configuração do mundo, programas de shader e referências para objetos GL.
     m_terrainManager.init(&m_worldConfig, &m_terrainShaderProgram, this);
 
@@ -277,6 +463,8 @@ void MyGLWidget::initializeGL() {
 
     m_frameCount = 0; // Zera o contador de quadros para cálculo de FPS.
     m_fpsTime.start(); // Inicia o timer para medição de FPS.
+    m_lastPaintTimer.start(); // Tempo desde o último quadro (redesenho sob demanda).
+    m_frameStatsTimer.start(); // Janela do relatório de quadros.
     m_tempReadTimer.start(); // Inicia o timer para leitura de temperatura.
 }
 
@@ -291,6 +479,22 @@ void MyGLWidget::initializeGL() {
  * Também calcula e emite o FPS.
  */
 void MyGLWidget::paintGL() {
+    QElapsedTimer paintTimer; // Tempo gasto neste quadro (relatório de tempo ocioso).
+    paintTimer.start();
+    m_lastPaintTimer.restart();
+
+    // Estado do trator no instante do quadro, interpolado entre os dois últimos passos da simulação.
+    const TractorState tractorState = m_simulation.interpolatedState();
+    if (tractorState.valid) {
+        const float TRACTOR_Y_OFFSET = 0.02f;
+        m_tractorPosition.setX(tractorState.x);
+        m_tractorPosition.setZ(tractorState.z);
+        m_tractorPosition.setY(NoiseUtils::getHeight(m_tractorPosition.x(), m_tractorPosition.z()) + TRACTOR_Y_OFFSET);
+        m_tractorRotation = tractorState.rotation;
+    }
+    m_lastPaintedPosition = m_tractorPosition;
+    m_lastPaintedRotation = m_tractorRotation;
+
     // Lógica da câmera inteligente (segue o trator):
     float distancia = m_worldConfig.cameraFollowDistance; // Distância da câmera em relação ao trator.
     float altura = m_worldConfig.cameraFollowHeight; // Altura da câmera em relação ao trator.
@@ -326,22 +530,38 @@ void MyGLWidget::paintGL() {
     bool terrainShaderOk = m_terrainShaderProgram.isLinked();
     bool lineShaderOk = m_lineShaderProgram.isLinked();
 
+    // Informa a posição e a direção do trator para priorizar a geração dos chunks à frente.
+    m_terrainManager.setFocus(m_tractorPosition, tractorForward);
     // Atualiza o TerrainManager com a posição atual da câmera para gerenciar LOD e recentragem de chunks.
-    m_terrainManager.update(m_camera.position());
+    // A matriz projeção * visão define o volume de visão usado no culling dos chunks.
+    const QMatrix4x4 viewProjection = m_camera.projectionMatrix() * m_camera.viewMatrix();
+    m_terrainManager.update(m_camera.position(), viewProjection);
+
+    // Matrizes, posição da câmera e luz vão uma única vez para o UBO, lido por todos os shaders.
+    updateSceneUniformBuffer(viewProjection);
 
     // Renderiza o terreno
     if (terrainShaderOk) {
         m_terrainShaderProgram.bind(); // Ativa o programa de shader do terreno.
-        // Define os uniformes da matriz de projeção e visão para o shader do terreno.
-        m_terrainShaderProgram.setUniformValue("projectionMatrix", m_camera.projectionMatrix());
-        m_terrainShaderProgram.setUniformValue("viewMatrix", m_camera.viewMatrix());
-        // Define a direção da luz (simulando o sol) e normaliza.
-        QVector3D sunDirection = QVector3D(-0.5f, -1.0f, -0.5f).normalized();
-        // Define a cor da luz (branco).
-        m_terrainShaderProgram.setUniformValue("lightDirection", sunDirection);
-        m_terrainShaderProgram.setUniformValue("lightColor", QVector3D(1.0f, 1.0f, 1.0f));
+        // Matrizes, posição da câmera (morphing entre níveis de LOD) e luz vêm do UBO da cena.
+        if (m_worldConfig.heightTextureTerrain) {
+            // A textura de alturas de cada chunk é ligada na unidade 0.
+            m_terrainShaderProgram.setUniformValue("heightMap", 0);
+        } else if (m_worldConfig.compactTerrainVertices) {
+            // Escala da altura quantizada do formato compacto.
+            m_terrainShaderProgram.setUniformValue("heightStep", m_worldConfig.compactHeightStep);
+        }
         // Define a cor base do terreno (verde).
         m_terrainShaderProgram.setUniformValue("objectBaseColor", QVector3D(m_worldConfig.terrainColorR, m_worldConfig.terrainColorG, m_worldConfig.terrainColorB));
+        // Grade no fragment shader do terreno (substitui a passada de linhas do TerrainGrid).
+        m_terrainShaderProgram.setUniformValue("gridEnabled", m_worldConfig.shaderTerrainGrid);
+        if (m_worldConfig.shaderTerrainGrid) {
+            const float fadeWidth = std::max(m_worldConfig.gridFadeEnd - m_worldConfig.gridFadeStart, 0.001f);
+            m_terrainShaderProgram.setUniformValue("gridSquareSize", m_worldConfig.gridSquareSize);
+            m_terrainShaderProgram.setUniformValue("gridLineWidth", m_worldConfig.gridLineThickness / m_worldConfig.gridSquareSize);
+            m_terrainShaderProgram.setUniformValue("gridColor", QVector3D(m_worldConfig.gridColorR, m_worldConfig.gridColorG, m_worldConfig.gridColorB));
+            m_terrainShaderProgram.setUniformValue("gridFade", QVector2D(m_worldConfig.gridFadeStart, 1.0f / fadeWidth));
+        }
 
         // Pede para o TerrainManager renderizar apenas o terreno.
         m_terrainManager.render(&m_terrainShaderProgram, this);
@@ -350,12 +570,13 @@ void MyGLWidget::paintGL() {
     }
 
     // Renderiza o Grid (Nova Lógica)
-    if (lineShaderOk) {
+    // Com a grade no shader do terreno, não há passada de linhas.
+    if (lineShaderOk && !m_worldConfig.shaderTerrainGrid) {
         // Atualiza a geometria do grid com a posição atual da câmera.
         // O grid se estende pela área de renderização do TerrainManager (gridRenderSize chunks).
         m_terrainGrid.updateGridGeometry(m_camera.position().x(), m_camera.position().z(), m_worldConfig.gridRenderSize);
         // Renderiza o grid usando o shader de linha.
-        m_terrainGrid.render(&m_lineShaderProgram, m_camera.viewMatrix(), m_camera.projectionMatrix());
+        m_terrainGrid.render(&m_lineShaderProgram, m_camera.position());
     }
 
     // Renderiza o trator
@@ -366,9 +587,7 @@ void MyGLWidget::paintGL() {
         tractorModelMatrix.translate(m_tractorPosition);
         tractorModelMatrix.rotate(m_tractorRotation, 0.0f, 1.0f, 0.0f);
 
-        // Define os uniformes da matriz de projeção, visão e modelo para o shader do trator.
-        m_tractorShaderProgram.setUniformValue("projectionMatrix", m_camera.projectionMatrix());
-        m_tractorShaderProgram.setUniformValue("viewMatrix", m_camera.viewMatrix());
+        // A matriz de modelo é a única por programa; projeção e visão vêm do UBO da cena.
         m_tractorShaderProgram.setUniformValue("modelMatrix", tractorModelMatrix);
 
         m_tractorVao.bind(); // Ativa o VAO do trator.
@@ -378,6 +597,7 @@ void MyGLWidget::paintGL() {
 
     // Lógica de cálculo de FPS:
     m_frameCount++; // Incrementa o contador de quadros.
+    m_frameStatsFrames++;
     if (m_fpsTime.elapsed() >= 1000) { // Verifica se um segundo se passou.
         // Calcula o FPS: número de quadros dividido pelo tempo decorrido em segundos.
         float fps = m_frameCount / (m_fpsTime.elapsed() / 1000.0f);
@@ -394,6 +614,10 @@ void MyGLWidget::paintGL() {
     while((err = glGetError()) != GL_NO_ERROR) {
         qWarning() << "Erro no OpenGl em tempo de execução" << err;
     }
+
+    m_frameStatsPaintNs += paintTimer.nsecsElapsed();
+    m_governorPaintNs += paintTimer.nsecsElapsed();
+    m_governorFrames++;
 }
 
 /**
@@ -413,7 +637,8 @@ void MyGLWidget::resizeGL(int w, int h) {
 /**
  * @brief O slot gameTick é acionado periodicamente pelo QTimer.
  *
- * Contém a lógica de atualização da simulação, incluindo:
+ * A predição do filtro e a cinemática do trator rodam em TractorSimulation; aqui ficam:
+ * - Leitura do último estado publicado (velocidade e probabilidades do IMM).
  * - Leitura da temperatura da CPU (em Linux).
  * - Lógica de direção do trator baseada no `m_steeringValue`.
  * - Lógica de movimento automático do trator baseada no `m_tractorSpeed`.
@@ -421,63 +646,37 @@ void MyGLWidget::resizeGL(int w, int h) {
  * - Reagendamento da função paintGL() para redesenhar a cena.
  */
 void MyGLWidget::gameTick() {
-    double dt = m_gameTickTimer.restart() / 1000.0;
-
-    if (m_immFilter && m_immFilter->isInitialized()) {
-        QVector2D predicted_pos = m_immFilter->predictSmoothPosition(dt);
-
-        // Usa o estado combinado mais recente para velocidade e rotação
-        QVector2D filtered_vel = m_immFilter->getStateVelocity();
-
-        const float TRACTOR_Y_OFFSET = 0.02f;
-        m_tractorPosition.setX(predicted_pos.x());
-        m_tractorPosition.setZ(predicted_pos.y());
-        m_tractorPosition.setY(NoiseUtils::getHeight(m_tractorPosition.x(), m_tractorPosition.z()) + TRACTOR_Y_OFFSET);
-
-        m_tractorCurrentSpeed = filtered_vel.length();
-
-        if (m_tractorCurrentSpeed > 0.1) {
-            m_tractorRotation = -qRadiansToDegrees(qAtan2(filtered_vel.x(), -filtered_vel.y()));
-        }
+    // O estado mais recente da simulação (a posição desenhada é interpolada no paintGL).
+    const TractorState tractorState = m_simulation.latestState();
+    if (tractorState.valid) {
+        m_tractorCurrentSpeed = tractorState.speed;
 
         // A cada quadro, buscamos as probabilidades atuais do MMI e emitimos o sinal.
-        const Eigen::VectorXd& probs = m_immFilter->getModeProbabilities();
-        QString status = (probs(0) > probs(1)) ? "Reta (FKL)" : "Curva (UKF)";
-        emit immStatusUpdated(status, probs(0) * 100.0, probs(1) * 100.0);
+        QString status = (tractorState.straightProbability > tractorState.turnProbability) ? "Reta (FKL)" : "Curva (UKF)";
+        emit immStatusUpdated(status, tractorState.straightProbability * 100.0, tractorState.turnProbability * 100.0);
     }
 
-    // Lógica de leitura de temperatura da CPU (a cada 2 segundos):
+    // Leitura da temperatura da CPU e governador de qualidade (a cada 2 segundos):
     if (m_tempReadTimer.elapsed() >= 2000) { // Verifica se 2 segundos se passaram desde a última leitura.
-        //qInfo() << "Timer de 2s atingido. tentando ler a temperatura..";
-#ifdef Q_OS_LINUX // Esta seção de código só é compilada se o sistema operacional for Linux.
-        QString tempFilePath = "/sys/class/thermal/thermal_zone0/temp"; // Caminho do arquivo para ler a temperatura da CPU no Linux.
-        QFile tempFile(tempFilePath); // Cria um objeto QFile para interagir com o arquivo.
-
-        if (tempFile.open(QIODevice::ReadOnly)) { // Tenta abrir o arquivo em modo somente leitura.
-            QTextStream in(&tempFile); // Cria um QTextStream para ler texto do arquivo.
-            QString line = in.readLine(); // Lê a primeira linha do arquivo.
-
-            // Verifica se a linha lida não está vazia.
-            if (line.trimmed().isEmpty()) {
-                MY_LOG_WARNING("CPU_Temp", "Arquivo de temperatura esta vazio");
-            } else {
-                bool ok; // Variável para verificar se a conversão foi bem-sucedida.
-                // Converte a string lida para float e divide por 1000 (o valor do arquivo é em miliCelsius).
-                float temperature = line.toFloat(&ok) / 1000.0;
-                if (ok) { // Se a conversão foi bem-sucedida.
-                    MY_LOG_INFO("CPU_Temp", QString("Leitura da temperatura: %1 °C").arg(temperature, 0, 'f', 1));
-                    emit tempUpdated(temperature); // Emite o sinal `tempUpdated` com a temperatura.
-                } else {
-                    MY_LOG_ERROR("CPU_Temp", QString("Não foi possível converter o conteúdo '%1' para número").arg(line));
-                }
-            }
-            tempFile.close(); // Fecha o arquivo.
+        // Tempo médio de quadro (paintGL) desde a amostra anterior; 0 se nada foi desenhado.
+        const float frameTimeMs = m_governorFrames > 0 ? m_governorPaintNs / 1.0e6f / m_governorFrames : 0.0f;
+        m_governorFrames = 0;
+        m_governorPaintNs = 0;
+
+        const bool levelChanged = m_qualityGovernor->sample(frameTimeMs, m_governorClock.elapsed());
+        if (m_qualityGovernor->hasTemperature()) {
+            const float temperature = m_qualityGovernor->temperature();
+            MY_LOG_INFO("CPU_Temp", QString("Leitura da temperatura: %1 °C").arg(temperature, 0, 'f', 1));
+            emit tempUpdated(temperature); // Emite o sinal `tempUpdated` com a temperatura.
         } else {
-            // Se não foi possível abrir o arquivo, registra um aviso.
-            MY_LOG_ERROR("CPU_Temp", QString("Não foi possível abrir o arquivo de temperatura em: %1").arg(tempFilePath));
+#ifdef Q_OS_LINUX // Fora do Linux não há sysfs: a falha é esperada e não é registrada.
+            MY_LOG_ERROR("CPU_Temp", m_qualityGovernor->lastError());
             MY_LOG_ERROR("CPU_Temp", "Verifique se o caminho esta correto para a sua placa");
-        }
 #endif
+        }
+        if (levelChanged) {
+            applyQualityLevel();
+        }
         m_tempReadTimer.restart(); // Reinicia o timer de leitura de temperatura.
     }
 
@@ -486,7 +685,85 @@ void MyGLWidget::gameTick() {
     emit kmUpdated(speedkm); // Emite o sinal `kmUpdated` com a velocidade em Km/h.
     emit coordinatesUpdate(m_tractorPosition.x(), m_tractorPosition.z());
 
-    update();
+    // Redesenho contínuo, ou só quando a imagem mudaria (WorldConfig::renderOnDemand).
+    if (!m_worldConfig.renderOnDemand || needsRedraw(tractorState)) {
+        update();
+    } else {
+        m_frameStatsSkippedTicks++;
+    }
+    reportFrameStats();
+}
+
+/**
+ * @brief Decide se o tick atual precisa de um novo quadro (redesenho sob demanda).
+ * @param state O estado mais recente da simulação.
+ * @return true para agendar o redesenho.
+ *
+ * A câmera segue o trator, então o deslocamento da imagem é estimado pelo do trator desde o
+ * último quadro, visto à distância da câmera: a translação mais o arco que a câmera descreve
+ * ao girar com ele, convertidos em pixels pela altura da viewport e pelo campo de visão.
+ */
+bool MyGLWidget::needsRedraw(const TractorState& state) const {
+    if (m_terrainManager.hasPendingWork()) {
+        return true; // Malhas chegando: o terreno na tela ainda vai mudar.
+    }
+    if (m_lastPaintTimer.elapsed() >= m_worldConfig.idleFrameIntervalMs) {
+        return true; // Taxa mínima, mesmo parado.
+    }
+    if (!state.valid) {
+        return false;
+    }
+
+    const float cameraDistance = std::sqrt(m_worldConfig.cameraFollowDistance * m_worldConfig.cameraFollowDistance +
+                                           m_worldConfig.cameraFollowHeight * m_worldConfig.cameraFollowHeight);
+    const float pixelsPerMeter = height() / (2.0f * cameraDistance * std::tan(qDegreesToRadians(m_worldConfig.cameraFov) * 0.5f));
+
+    const float moved = QVector2D(state.x - m_lastPaintedPosition.x(), state.z - m_lastPaintedPosition.z()).length();
+    float rotationDelta = std::fabs(state.rotation - m_lastPaintedRotation);
+    if (rotationDelta > 180.0f) rotationDelta = 360.0f - rotationDelta;
+    const float arc = qDegreesToRadians(rotationDelta) * cameraDistance;
+
+    return (moved + arc) * pixelsPerMeter >= m_worldConfig.redrawPixelThreshold;
+}
+
+/**
+ * @brief Aplica o nível atual do governador de qualidade.
+ *
+ * A área ativa, as faixas de LOD e as threads mudam no terreno sem realocar a grade; a taxa de
+ * quadros muda o intervalo do timer do loop (que agenda os redesenhos).
+ */
+void MyGLWidget::applyQualityLevel() {
+    const QualityLevel& quality = m_qualityGovernor->settings();
+    m_terrainManager.setActiveGridSize(quality.gridRenderSize);
+    m_terrainManager.setLodDistanceScale(quality.lodDistanceScale);
+    m_terrainManager.setWorkerThreads(quality.workerThreads);
+    m_timer.setInterval(std::max(1, 1000 / quality.targetFps));
+}
+
+/**
+ * @brief Registra a cada 5 segundos a taxa de quadros, os ticks sem redesenho e o tempo ocioso.
+ *
+ * O tempo ocioso é a fração da janela fora do paintGL (tempo de CPU da thread principal gasto
+ * para desenhar; o trabalho da GPU não entra).
+ */
+void MyGLWidget::reportFrameStats() {
+    const qint64 windowMs = m_frameStatsTimer.elapsed();
+    if (windowMs < 5000) {
+        return;
+    }
+
+    const float fps = m_frameStatsFrames * 1000.0f / windowMs;
+    const float idlePercent = 100.0f * (1.0f - std::min(1.0f, m_frameStatsPaintNs / (windowMs * 1.0e6f)));
+    MY_LOG_INFO("Render", QString("Quadros: %1/s (%2), ticks sem redesenho: %3, ocioso: %4% do tempo")
+                              .arg(fps, 0, 'f', 1)
+                              .arg(m_worldConfig.renderOnDemand ? "sob demanda" : "contínuo")
+                              .arg(m_frameStatsSkippedTicks)
+                              .arg(idlePercent, 0, 'f', 1));
+
+    m_frameStatsFrames = 0;
+    m_frameStatsSkippedTicks = 0;
+    m_frameStatsPaintNs = 0;
+    m_frameStatsTimer.restart();
 }
 
 /**
@@ -572,6 +849,9 @@ void MyGLWidget::onGpsDataUpdate(const GpsData& data) {
         }
     }
 
+    if (m_isRtkSignalLost) {
+        update(); // Remove o aviso de perda de sinal mesmo que o trator esteja parado.
+    }
     m_isRtkSignalLost = false;
 
     if (!m_currentGpsData.isValid) {
@@ -583,29 +863,50 @@ void MyGLWidget::onGpsDataUpdate(const GpsData& data) {
     if (!m_hasReferenceCoordinate) {
         m_referenceCoordinate = QGeoCoordinate(data.latitude, data.longitude);
         m_hasReferenceCoordinate = true;
+
+        // Com a origem do mundo conhecida, o DEM georreferenciado vai para a sua posição.
+        if (m_worldConfig.terrainDemGeoreferenced) {
+            double demX = 0.0;
+            double demZ = 0.0;
+            geoToWorld(QGeoCoordinate(m_worldConfig.terrainDemOriginLatitude, m_worldConfig.terrainDemOriginLongitude),
+                       demX, demZ);
+            m_terrainManager.setDemWorldOrigin(demX, demZ);
+        }
     }
 
     // 2. Calcule as coordenadas do mundo a partir do Lat/Lon (sem duplicação).
-    QGeoCoordinate currentCoord(data.latitude, data.longitude);
-    double distance = m_referenceCoordinate.distanceTo(currentCoord);
-    double azimuth = m_referenceCoordinate.azimuthTo(currentCoord);
-    double radAzimuth = qDegreesToRadians(azimuth);
-    double deltaX_world = distance * qSin(radAzimuth);
-    double deltaZ_world = -distance * qCos(radAzimuth);
+    double deltaX_world = 0.0;
+    double deltaZ_world = 0.0;
+    geoToWorld(QGeoCoordinate(data.latitude, data.longitude), deltaX_world, deltaZ_world);
+
+    // Funde a altitude (GGA) no modelo de elevação do terreno, com o peso da qualidade do fix.
+    m_terrainManager.addElevationSample(static_cast<float>(deltaX_world), static_cast<float>(deltaZ_world), data.altitude,
+                                        GnssHeightSource::verticalSigma(data.fixQuality, data.hdop));
 
     // 3. Atualize o perfil adaptativo ANTES de rodar o filtro.
     updateFilterParameters(data);
 
-    // 4. Chame o filtro para processar a medição.
-    if (m_immFilter) {
-        m_immFilter->updateWithMeasurement(deltaX_world, deltaZ_world);
-    }
+    // 4. Chame o filtro para processar a medição (na simulação, que o prediz a cada passo).
+    m_simulation.addMeasurement(deltaX_world, deltaZ_world);
 
     // 5. Atualize o estado visual do trator.
     m_lastGpsData = m_currentGpsData;
     checkMovementStatus();
 }
 
+/**
+ * @brief Converte uma coordenada geográfica para o mundo.
+ * @param coordinate A coordenada a converter.
+ * @param worldX Recebe a coordenada X do mundo (leste).
+ * @param worldZ Recebe a coordenada Z do mundo (o norte é -Z).
+ */
+void MyGLWidget::geoToWorld(const QGeoCoordinate& coordinate, double& worldX, double& worldZ) const {
+    double distance = m_referenceCoordinate.distanceTo(coordinate);
+    double radAzimuth = qDegreesToRadians(m_referenceCoordinate.azimuthTo(coordinate));
+    worldX = distance * qSin(radAzimuth);
+    worldZ = -distance * qCos(radAzimuth);
+}
+
 //Verifica se o trator esta em linha reta ou fazendo curva
 void MyGLWidget::checkMovementStatus() {
     // Requer pelo menos dois pontos de dados GPS para comparar
@@ -642,10 +943,6 @@ void MyGLWidget::checkMovementStatus() {
 }
 
 void MyGLWidget::updateFilterParameters(const GpsData& data) {
-    if (!m_immFilter) {
-        return;
-    }
-
     FilterProfile dynamicProfile;
     bool profileSet = false;
 
@@ -690,14 +987,15 @@ void MyGLWidget::updateFilterParameters(const GpsData& data) {
                                       .arg(data.hdop, 0, 'f', 2)
                                       .arg(m_movimentStatus));
 
-    m_immFilter->setProfile(dynamicProfile);
+    m_simulation.setFilterProfile(dynamicProfile);
 }
 
 void MyGLWidget::onRtkModeChanged(const QString& newMode) {
     m_requiredRtkMode = newMode;
     MY_LOG_INFO("RTK_Mode", QString("Modo de operação alterado para: %1").arg(newMode));
     m_isRtkSignalLost = false;
-    m_immFilter->reset(m_tractorPosition.x(), m_tractorPosition.z());
+    update();
+    m_simulation.resetFilter(m_tractorPosition.x(), m_tractorPosition.z());
 }
 
 float MyGLWidget::calculateSignalConfidence(const GpsData& data) {
@@ -736,3 +1034,72 @@ float MyGLWidget::calculateSignalConfidence(const GpsData& data) {
     }
     return confidence;
 }
+
+/**
+ * @brief Cria o UBO da cena e liga o bloco SceneBlock de cada programa de shader a ele.
+ *
+ * O GLES 3.0 tem UBOs, mas o QOpenGLBuffer não tem esse tipo: o buffer é criado com as funções
+ * GL. Os programas que não linkaram (ou não têm o bloco) são ignorados.
+ */
+void MyGLWidget::setupSceneUniformBuffer() {
+    if (!m_extraFunction) {
+        MY_LOG_ERROR("Render", "UBO da cena indisponível: sem QOpenGLExtraFunctions. Os shaders não recebem as matrizes.");
+        return;
+    }
+
+    glGenBuffers(1, &m_sceneUniformBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_sceneUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(SceneMatrices), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_extraFunction->glBindBufferBase(GL_UNIFORM_BUFFER, SCENE_UNIFORM_BINDING, m_sceneUniformBuffer);
+
+    QOpenGLShaderProgram* programs[] = {&m_terrainShaderProgram, &m_lineShaderProgram, &m_tractorShaderProgram};
+    for (QOpenGLShaderProgram* program : programs) {
+        if (!program->isLinked()) {
+            continue;
+        }
+        const GLuint blockIndex = m_extraFunction->glGetUniformBlockIndex(program->programId(), "SceneBlock");
+        if (blockIndex == GL_INVALID_INDEX) {
+            MY_LOG_WARNING("Render", "Programa de shader sem o bloco SceneBlock.");
+            continue;
+        }
+        m_extraFunction->glUniformBlockBinding(program->programId(), blockIndex, SCENE_UNIFORM_BINDING);
+    }
+    MY_LOG_INFO("Render", QString("UBO da cena criado (%1 bytes, ponto de ligação %2).").arg(sizeof(SceneMatrices)).arg(SCENE_UNIFORM_BINDING));
+}
+
+/**
+ * @brief Grava as matrizes e a luz do quadro no UBO da cena.
+ * @param viewProjection A matriz projeção * visão do quadro.
+ *
+ * Substitui os setUniformValue de projeção, visão, posição da câmera e luz que cada programa
+ * recebia separadamente. O buffer inteiro é reenviado com glBufferData, o que deixa o driver
+ * trocar a memória em vez de esperar a GPU terminar de ler o conteúdo do quadro anterior.
+ */
+void MyGLWidget::updateSceneUniformBuffer(const QMatrix4x4& viewProjection) {
+    if (m_sceneUniformBuffer == 0) {
+        return;
+    }
+
+    SceneMatrices scene;
+    std::copy(m_camera.viewMatrix().constData(), m_camera.viewMatrix().constData() + 16, scene.viewMatrix);
+    const QMatrix4x4 projection = m_camera.projectionMatrix();
+    std::copy(projection.constData(), projection.constData() + 16, scene.projectionMatrix);
+    std::copy(viewProjection.constData(), viewProjection.constData() + 16, scene.viewProjectionMatrix);
+
+    const QVector3D cameraPos = m_camera.position();
+    // Direção da luz (simulando o sol), normalizada, e cor da luz (branco).
+    const QVector3D sunDirection = QVector3D(-0.5f, -1.0f, -0.5f).normalized();
+    const float cameraPosition[4] = {cameraPos.x(), cameraPos.y(), cameraPos.z(), 1.0f};
+    const float lightDirection[4] = {sunDirection.x(), sunDirection.y(), sunDirection.z(), 0.0f};
+    const float lightColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    std::copy(cameraPosition, cameraPosition + 4, scene.cameraPosition);
+    std::copy(lightDirection, lightDirection + 4, scene.lightDirection);
+    std::copy(lightColor, lightColor + 4, scene.lightColor);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_sceneUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(SceneMatrices), &scene, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    // O QPainter (aviso de sinal RTK) pode alterar o estado GL entre quadros; religa o ponto.
+    m_extraFunction->glBindBufferBase(GL_UNIFORM_BUFFER, SCENE_UNIFORM_BINDING, m_sceneUniformBuffer);
+}
@@ -15,26 +15,46 @@
 #include "worldconfig.h"        // Inclui a estrutura WorldConfig.
 #include <QGeoCoordinate>
 #include "immfilter.h"
+#include "tractorsimulation.h" // Simulação do trator (filtro IMM e cinemática) em passo fixo, em thread própria.
+#include "qualitygovernor.h"   // Governador de qualidade por temperatura e tempo de quadro.
+#include <memory>               // Para std::unique_ptr (governador de qualidade).
 #include "gpsfileplayer.h"
 #include "terraingrid.h"
 
 
 // Estrutura: SceneMatrices
-// Descrição: Uma estrutura para agrupar as matrizes de projeção e visão da cena.
-//            Pode ser útil para passar essas matrizes juntas para funções ou shaders.
+// Descrição: Cópia na CPU do bloco de uniformes da cena (`SceneBlock` nos shaders), no layout
+//            std140: as matrizes em ordem de colunas (QMatrix4x4::constData) e os vetores em vec4.
+//            É gravada uma vez por quadro no UBO compartilhado por todos os programas de shader,
+//            em vez de cada programa receber as mesmas matrizes por setUniformValue.
 struct SceneMatrices {
 
-    // Membro: projectionMatrix
-    // Tipo: QMatrix4x4
-    // Descrição: A matriz de projeção da câmera, responsável por transformar coordenadas 3D em 2D.
-    QMatrix4x4 projectionMatrix;
-
     // Membro: viewMatrix
-    // Tipo: QMatrix4x4
+    // Tipo: float[16]
     // Descrição: A matriz de visão da câmera, responsável por posicionar e orientar a câmera no mundo.
-    QMatrix4x4 viewMatrix;
+    float viewMatrix[16];
+
+    // Membro: projectionMatrix
+    // Tipo: float[16]
+    // Descrição: A matriz de projeção da câmera, responsável por transformar coordenadas 3D em 2D.
+    float projectionMatrix[16];
+
+    // Membro: viewProjectionMatrix
+    // Tipo: float[16]
+    // Descrição: projectionMatrix * viewMatrix, já multiplicada (um produto por quadro, não por vértice).
+    float viewProjectionMatrix[16];
+
+    // Membros: cameraPosition / lightDirection / lightColor
+    // Tipo: float[4]
+    // Descrição: Posição da câmera no mundo, direção da luz do sol e cor da luz (o 4º componente não é usado).
+    float cameraPosition[4];
+    float lightDirection[4];
+    float lightColor[4];
 };
 
+// O layout std140 não tem preenchimento entre estes membros; o tamanho precisa bater com o do shader.
+static_assert(sizeof(SceneMatrices) == 240, "SceneMatrices deve seguir o layout std140 de SceneBlock");
+
 // Classe: MyGLWidget
 // Descrição: Este é o widget principal onde toda a renderização OpenGL ocorre.
 //            Ele herda de QOpenGLWidget e QOpenGLFunctions, fornecendo um contexto OpenGL
@@ -124,8 +144,8 @@ protected:
 private slots:
     // Slot Privado: gameTick
     // Descrição: O slot principal do loop do jogo, acionado pelo timer.
-    //            Contém a lógica de atualização da simulação (movimento do trator,
-    //            cálculo de FPS, leitura de temperatura, atualização do terreno).
+    //            Lê o estado publicado pela simulação (que roda em TractorSimulation),
+    //            faz a leitura de temperatura, emite os sinais da interface e agenda o redesenho.
     void gameTick();
 
     // Slot Privado: onSpeedUpdate
@@ -150,8 +170,45 @@ private:
     // Descrição: Configura os shaders, VAO e VBO para renderizar o modelo do trator.
     void setupTractorGL();
 
+    // Método: needsRedraw
+    // Descrição: Decide, no modo de redesenho sob demanda, se o tick atual precisa de um quadro:
+    //            terreno pendente, intervalo ocioso esgotado ou movimento na tela acima do limite.
+    // Parâmetros:
+    //   - state: O estado mais recente da simulação.
+    // Retorno: bool - true para agendar o redesenho.
+    bool needsRedraw(const TractorState& state) const;
+
+    // Método: applyQualityLevel
+    // Descrição: Aplica as configurações do nível atual do governador de qualidade ao terreno e
+    //            ao timer do loop.
+    void applyQualityLevel();
+
+    // Método: reportFrameStats
+    // Descrição: Registra periodicamente a taxa de quadros alcançada, os ticks sem redesenho e a
+    //            fração do tempo em que a thread principal não estava desenhando.
+    void reportFrameStats();
+
+    // Método: setupSceneUniformBuffer
+    // Descrição: Cria o UBO da cena e liga o bloco `SceneBlock` de cada programa de shader ao
+    //            ponto SCENE_UNIFORM_BINDING. Chamado depois que os programas foram linkados.
+    void setupSceneUniformBuffer();
+
+    // Método: updateSceneUniformBuffer
+    // Descrição: Grava as matrizes da câmera e a luz do quadro no UBO da cena (uma vez por quadro).
+    // Parâmetros:
+    //   - viewProjection: A matriz projeção * visão do quadro.
+    void updateSceneUniformBuffer(const QMatrix4x4& viewProjection);
+
     void checkMovementStatus();
 
+    // Método: geoToWorld
+    // Descrição: Converte uma coordenada geográfica para o mundo (origem no primeiro fix do GPS,
+    //            X para o leste e -Z para o norte), por distância e azimute a partir da referência.
+    // Parâmetros:
+    //   - coordinate: A coordenada a converter.
+    //   - worldX / worldZ: Recebem as coordenadas X e Z do mundo.
+    void geoToWorld(const QGeoCoordinate& coordinate, double& worldX, double& worldZ) const;
+
     float calculateSignalConfidence(const GpsData& data);
 
     void updateFilterParameters(const GpsData& data);
@@ -196,6 +253,40 @@ private:
     // Descrição: Timer para medir o tempo decorrido para calcular o FPS.
     QElapsedTimer m_fpsTime;
 
+    // Membro: m_lastPaintTimer
+    // Tipo: QElapsedTimer
+    // Descrição: Tempo desde o último quadro desenhado (taxa mínima do redesenho sob demanda).
+    QElapsedTimer m_lastPaintTimer;
+
+    // Membros: m_lastPaintedPosition / m_lastPaintedRotation
+    // Tipo: QVector3D / float
+    // Descrição: Posição e rumo do trator no último quadro desenhado, comparados com o estado da
+    //            simulação para estimar quanto a imagem mudaria.
+    QVector3D m_lastPaintedPosition;
+    float m_lastPaintedRotation = 0.0f;
+
+    // Membros: m_frameStatsTimer / m_frameStatsFrames / m_frameStatsSkippedTicks / m_frameStatsPaintNs
+    // Tipo: QElapsedTimer / int / int / qint64
+    // Descrição: Janela do relatório periódico de quadros: quadros desenhados, ticks sem
+    //            redesenho e tempo gasto dentro do paintGL.
+    QElapsedTimer m_frameStatsTimer;
+    int m_frameStatsFrames = 0;
+    int m_frameStatsSkippedTicks = 0;
+    qint64 m_frameStatsPaintNs = 0;
+
+    // Membro: m_qualityGovernor
+    // Tipo: std::unique_ptr<QualityGovernor>
+    // Descrição: Lê a temperatura (WorldConfig::thermalZonePath) e escolhe o nível de qualidade.
+    std::unique_ptr<QualityGovernor> m_qualityGovernor;
+
+    // Membros: m_governorClock / m_governorFrames / m_governorPaintNs
+    // Tipo: QElapsedTimer / int / qint64
+    // Descrição: Relógio do governador e quadros e tempo de paintGL desde a última amostra
+    //            (tempo de quadro médio).
+    QElapsedTimer m_governorClock;
+    int m_governorFrames = 0;
+    qint64 m_governorPaintNs = 0;
+
     // Membro: m_tempReadTimer
     // Tipo: QElapsedTimer
     // Descrição: Timer para controlar a frequência de leitura da temperatura da CPU.
@@ -212,6 +303,16 @@ private:
     QOpenGLExtraFunctions *m_extraFunction;
 
 
+    // Constante: SCENE_UNIFORM_BINDING
+    // Descrição: Ponto de ligação do UBO da cena (GL_UNIFORM_BUFFER).
+    static constexpr GLuint SCENE_UNIFORM_BINDING = 0;
+
+    // Membro: m_sceneUniformBuffer
+    // Tipo: GLuint
+    // Descrição: UBO com o conteúdo de SceneMatrices, compartilhado pelos shaders de terreno, linhas e trator.
+    //            0 enquanto não foi criado.
+    GLuint m_sceneUniformBuffer = 0;
+
     // Membro: m_tractorVao
     // Tipo: QOpenGLVertexArrayObject
     // Descrição: VAO para o modelo 3D do trator.
@@ -230,8 +331,6 @@ private:
     const float WHEELBASE = 3.0f;
     const float MAX_STEERING_ANGLE = 0.5;
 
-    QElapsedTimer m_gameTickTimer;
-
     // Membro: m_terrainShaderProgram
     // Tipo: QOpenGLShaderProgram
     // Descrição: Programa de shader para renderizar o terreno.
@@ -274,7 +373,11 @@ private:
     bool m_hasReferenceCoordinate;
     float m_currentHeading; // Rumo atual do trator (do GPS)
 
-    immfilter *m_immFilter;
+    // Membro: m_simulation
+    // Tipo: TractorSimulation
+    // Descrição: Thread da simulação: dona do filtro IMM, publica os estados do trator que o
+    //            paintGL interpola. Recebe as medições GPS e os perfis do filtro.
+    TractorSimulation m_simulation;
 
     QString m_requiredRtkMode;
     bool m_isRtkSignalLost;
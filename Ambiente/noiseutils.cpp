@@ -1,7 +1,376 @@
 #include "noiseutils.h" // Inclui o cabeçalho do namespace NoiseUtils.
 
-// Este arquivo .cpp está vazio porque todas as funções do namespace NoiseUtils
-// são definidas como `inline` diretamente no arquivo de cabeçalho `noiseutils.h`.
-// Funções `inline` são tipicamente pequenas e o compilador tenta expandi-las no local da chamada,
-// o que pode melhorar a performance, mas significa que a implementação não aparece aqui.
-// Futuras implementações de ruído (Perlin, Simplex etc.) seriam adicionadas aqui se não fossem `inline`.
+// As funções pontuais (getHeight, getNormal) são `inline` no cabeçalho. Aqui ficam o estado
+// do motor de alturas, as funções de avaliação em lote e a escolha, em tempo de execução,
+// do kernel vetorizado.
+
+namespace NoiseUtils {
+namespace detail {
+OctaveTable g_octaves; // Vazia (terreno plano) até o primeiro `configure`.
+const HeightSource* g_heightSource = nullptr; // Sem fonte externa: ruído procedural.
+} // namespace detail
+} // namespace NoiseUtils
+
+namespace {
+
+NoiseUtils::NoiseParams g_params; // Parâmetros aplicados pelo último `configure`.
+
+// Cada kernel é o mesmo laço sem desvios sobre o ruído de gradiente, compilado com um
+// conjunto de instruções diferente (atributo `target` do GCC/Clang). O laço externo percorre
+// as oitavas e o interno os pontos (SoA): o laço interno, sem dependências entre pontos,
+// é vetorizado pelo compilador com a largura do conjunto escolhido. O ruído continua
+// escrito uma única vez (noiseutils.h) e todos os kernels o acompanham.
+
+/**
+ * @brief Corpo comum dos kernels de lote com coordenadas arbitrárias.
+ */
+inline __attribute__((always_inline)) void heightsBody(const float* __restrict worldX, const float* __restrict worldZ,
+                                                       int count, float* __restrict outHeights)
+{
+    const NoiseUtils::detail::OctaveTable& octaves = NoiseUtils::detail::g_octaves;
+    for (int i = 0; i < count; ++i) {
+        outHeights[i] = 0.0f;
+    }
+    for (int o = 0; o < octaves.count; ++o) {
+        const float frequency = octaves.frequency[o];
+        const float amplitude = octaves.amplitude[o];
+        const quint32 seed = octaves.seed[o];
+        for (int i = 0; i < count; ++i) {
+            float dx, dz;
+            outHeights[i] += amplitude * NoiseUtils::detail::gradientNoise(worldX[i] * frequency, worldZ[i] * frequency,
+                                                                           seed, dx, dz);
+        }
+    }
+}
+
+/**
+ * @brief Corpo comum dos kernels de uma linha igualmente espaçada em X.
+ */
+inline __attribute__((always_inline)) void heightRowBody(float startX, float stepX, float worldZ, int count,
+                                                         float* __restrict outHeights)
+{
+    const NoiseUtils::detail::OctaveTable& octaves = NoiseUtils::detail::g_octaves;
+    for (int i = 0; i < count; ++i) {
+        outHeights[i] = 0.0f;
+    }
+    for (int o = 0; o < octaves.count; ++o) {
+        const float frequency = octaves.frequency[o];
+        const float amplitude = octaves.amplitude[o];
+        const quint32 seed = octaves.seed[o];
+        const float z = worldZ * frequency;
+        for (int i = 0; i < count; ++i) {
+            float dx, dz;
+            const float x = (startX + static_cast<float>(i) * stepX) * frequency;
+            outHeights[i] += amplitude * NoiseUtils::detail::gradientNoise(x, z, seed, dx, dz);
+        }
+    }
+}
+
+// Os kernels pedem o modelo de custo "dynamic" do vetorizador: no -O2 do qmake, o GCC 12+
+// usa o modelo "very-cheap", que recusa laços longos como o do ruído.
+#if defined(__clang__)
+#define NOISE_KERNEL_TARGET(isa) __attribute__((target(isa)))
+#define NOISE_KERNEL_BASE
+#else
+#define NOISE_KERNEL_TARGET(isa) __attribute__((target(isa), optimize("vect-cost-model=dynamic")))
+#define NOISE_KERNEL_BASE __attribute__((optimize("vect-cost-model=dynamic")))
+#endif
+
+using HeightsKernel = void (*)(const float*, const float*, int, float*);
+using HeightRowKernel = void (*)(float, float, float, int, float*);
+
+#if defined(__x86_64__) || defined(__i386__)
+NOISE_KERNEL_TARGET("sse4.1")
+void heightsSse41(const float* worldX, const float* worldZ, int count, float* outHeights)
+{
+    heightsBody(worldX, worldZ, count, outHeights);
+}
+
+NOISE_KERNEL_TARGET("sse4.1")
+void heightRowSse41(float startX, float stepX, float worldZ, int count, float* outHeights)
+{
+    heightRowBody(startX, stepX, worldZ, count, outHeights);
+}
+
+NOISE_KERNEL_TARGET("avx2,fma")
+void heightsAvx2(const float* worldX, const float* worldZ, int count, float* outHeights)
+{
+    heightsBody(worldX, worldZ, count, outHeights);
+}
+
+NOISE_KERNEL_TARGET("avx2,fma")
+void heightRowAvx2(float startX, float stepX, float worldZ, int count, float* outHeights)
+{
+    heightRowBody(startX, stepX, worldZ, count, outHeights);
+}
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+// No AArch64 o Advanced SIMD (NEON) faz parte da arquitetura base: o kernel é o corpo comum
+// compilado sem atributo de conjunto de instruções, vetorizado com registradores de 128 bits.
+NOISE_KERNEL_BASE
+void heightsNeon(const float* worldX, const float* worldZ, int count, float* outHeights)
+{
+    heightsBody(worldX, worldZ, count, outHeights);
+}
+
+NOISE_KERNEL_BASE
+void heightRowNeon(float startX, float stepX, float worldZ, int count, float* outHeights)
+{
+    heightRowBody(startX, stepX, worldZ, count, outHeights);
+}
+#endif
+
+/**
+ * @brief Kernels escolhidos para o processador atual.
+ */
+struct Dispatch {
+    NoiseUtils::SimdLevel level;
+    HeightsKernel heights;
+    HeightRowKernel heightRow;
+};
+
+/**
+ * @brief Retorna os kernels de um nível, se ele foi compilado e o processador o suporta.
+ * @param level O nível.
+ * @param kernels Recebe os kernels do nível.
+ * @return false se o nível não está disponível (kernels fica inalterado).
+ */
+bool kernelsFor(NoiseUtils::SimdLevel level, Dispatch& kernels)
+{
+    switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+    case NoiseUtils::SimdLevel::Avx2:
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+            return false;
+        }
+        kernels = {level, heightsAvx2, heightRowAvx2};
+        return true;
+    case NoiseUtils::SimdLevel::Sse41:
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("sse4.1")) {
+            return false;
+        }
+        kernels = {level, heightsSse41, heightRowSse41};
+        return true;
+#endif
+#if defined(__ARM_NEON) || defined(__aarch64__)
+    case NoiseUtils::SimdLevel::Neon:
+        kernels = {level, heightsNeon, heightRowNeon};
+        return true;
+#endif
+    case NoiseUtils::SimdLevel::Scalar:
+        kernels = {level, NoiseUtils::getHeightsScalar, NoiseUtils::getHeightRowScalar};
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Detecta o conjunto de instruções e escolhe os kernels.
+ *
+ * Chamada uma única vez (inicialização de variável estática local, segura entre threads).
+ * Escolhe o nível mais largo disponível.
+ */
+Dispatch detectDispatch()
+{
+    Dispatch selected{};
+    for (NoiseUtils::SimdLevel level : {NoiseUtils::SimdLevel::Avx2, NoiseUtils::SimdLevel::Sse41,
+                                        NoiseUtils::SimdLevel::Neon}) {
+        if (kernelsFor(level, selected)) {
+            return selected;
+        }
+    }
+    kernelsFor(NoiseUtils::SimdLevel::Scalar, selected);
+    return selected;
+}
+
+/**
+ * @brief Retorna os kernels do processador atual, detectando-os na primeira chamada.
+ */
+const Dispatch& dispatch()
+{
+    static const Dispatch selected = detectDispatch();
+    return selected;
+}
+
+} // namespace
+
+namespace NoiseUtils {
+
+/**
+ * @brief Define os parâmetros do motor de alturas.
+ * @param params Os parâmetros do ruído.
+ *
+ * Pré-calcula frequência, amplitude e semente de cada oitava, para que as avaliações
+ * só leiam a tabela. Cada oitava usa uma semente diferente, para que os padrões não
+ * se alinhem entre as escalas.
+ */
+void configure(const NoiseParams& params)
+{
+    g_params = params;
+    g_params.octaves = qBound(1, params.octaves, MAX_OCTAVES);
+
+    detail::OctaveTable table;
+    table.count = (g_params.amplitude != 0.0f) ? g_params.octaves : 0; // Amplitude 0: terreno plano, sem custo.
+    float frequency = g_params.frequency;
+    float amplitude = g_params.amplitude;
+    for (int o = 0; o < table.count; ++o) {
+        table.frequency[o] = frequency;
+        table.amplitude[o] = amplitude;
+        table.seed[o] = g_params.seed + static_cast<quint32>(o) * 0x9e3779b9u;
+        frequency *= g_params.lacunarity;
+        amplitude *= g_params.gain;
+    }
+    detail::g_octaves = table;
+}
+
+/**
+ * @brief Retorna os parâmetros em uso.
+ */
+const NoiseParams& params()
+{
+    return g_params;
+}
+
+/**
+ * @brief Registra uma fonte de alturas externa no lugar do ruído.
+ * @param source A fonte, ou nulo para voltar ao ruído.
+ */
+void setHeightSource(const HeightSource* source)
+{
+    detail::g_heightSource = source;
+}
+
+/**
+ * @brief Retorna a fonte de alturas registrada (nula se for o ruído).
+ */
+const HeightSource* heightSource()
+{
+    return detail::g_heightSource;
+}
+
+/**
+ * @brief Avalia a altura em um lote de coordenadas com o kernel vetorizado.
+ * @param worldX Coordenadas X (count valores).
+ * @param worldZ Coordenadas Z (count valores).
+ * @param count Número de pontos.
+ * @param outHeights Destino das alturas.
+ */
+void getHeights(const float* worldX, const float* worldZ, int count, float* outHeights)
+{
+    if (detail::g_heightSource) {
+        getHeightsScalar(worldX, worldZ, count, outHeights); // A fonte externa é consultada ponto a ponto.
+        return;
+    }
+    dispatch().heights(worldX, worldZ, count, outHeights);
+}
+
+/**
+ * @brief Avalia a altura em uma linha igualmente espaçada em X com o kernel vetorizado.
+ * @param startX Coordenada X do primeiro ponto.
+ * @param stepX Distância em X entre pontos vizinhos.
+ * @param worldZ Coordenada Z da linha.
+ * @param count Número de pontos.
+ * @param outHeights Destino das alturas.
+ */
+void getHeightRow(float startX, float stepX, float worldZ, int count, float* outHeights)
+{
+    if (detail::g_heightSource) {
+        detail::g_heightSource->heightRow(startX, stepX, worldZ, count, outHeights);
+        return;
+    }
+    dispatch().heightRow(startX, stepX, worldZ, count, outHeights);
+}
+
+/**
+ * @brief Referência escalar de getHeights: uma chamada de getHeight por ponto.
+ */
+void getHeightsScalar(const float* worldX, const float* worldZ, int count, float* outHeights)
+{
+    for (int i = 0; i < count; ++i) {
+        outHeights[i] = getHeight(worldX[i], worldZ[i]);
+    }
+}
+
+/**
+ * @brief Referência escalar de getHeightRow: uma chamada de getHeight por ponto.
+ */
+void getHeightRowScalar(float startX, float stepX, float worldZ, int count, float* outHeights)
+{
+    for (int i = 0; i < count; ++i) {
+        outHeights[i] = getHeight(startX + static_cast<float>(i) * stepX, worldZ);
+    }
+}
+
+/**
+ * @brief Indica se o kernel de um nível está compilado e é suportado pelo processador.
+ * @param level O nível.
+ */
+bool isSimdLevelAvailable(SimdLevel level)
+{
+    Dispatch kernels{};
+    return kernelsFor(level, kernels);
+}
+
+/**
+ * @brief Avalia a altura em um lote de coordenadas com o kernel de um nível escolhido.
+ * @param level O nível (um nível indisponível usa a referência escalar).
+ */
+void getHeightsWith(SimdLevel level, const float* worldX, const float* worldZ, int count, float* outHeights)
+{
+    Dispatch kernels{};
+    if (detail::g_heightSource || !kernelsFor(level, kernels)) {
+        getHeightsScalar(worldX, worldZ, count, outHeights);
+        return;
+    }
+    kernels.heights(worldX, worldZ, count, outHeights);
+}
+
+/**
+ * @brief Avalia a altura em uma linha igualmente espaçada em X com o kernel de um nível escolhido.
+ * @param level O nível (um nível indisponível usa a referência escalar).
+ */
+void getHeightRowWith(SimdLevel level, float startX, float stepX, float worldZ, int count, float* outHeights)
+{
+    Dispatch kernels{};
+    if (detail::g_heightSource) {
+        detail::g_heightSource->heightRow(startX, stepX, worldZ, count, outHeights);
+        return;
+    }
+    if (!kernelsFor(level, kernels)) {
+        getHeightRowScalar(startX, stepX, worldZ, count, outHeights);
+        return;
+    }
+    kernels.heightRow(startX, stepX, worldZ, count, outHeights);
+}
+
+/**
+ * @brief Retorna o conjunto de instruções escolhido para as funções em lote.
+ */
+SimdLevel activeSimdLevel()
+{
+    return dispatch().level;
+}
+
+/**
+ * @brief Retorna o nome legível de um nível de SIMD.
+ * @param level O nível.
+ */
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Sse41:
+        return "sse4.1";
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Neon:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+} // namespace NoiseUtils
@@ -4,6 +4,7 @@
 #include <QtGlobal> // Para tipos globais do Qt, como quintptr, qreal, etc.
 #include <QtMath>   // Para funções matemáticas como qAtan2, qAsin, etc.
 #include <QVector3D> // Para a classe QVector3D, utilizada para vetores 3D.
+#include "heightsource.h" // Fonte de alturas externa (ex.: DEM) que substitui o ruído procedural.
 
 // Namespace: NoiseUtils
 // Descrição: Este namespace encapsula funções utilitárias relacionadas à geração de ruído
@@ -12,36 +13,259 @@
 //            possivelmente inserindo o código diretamente no local da chamada para melhor performance.
 namespace NoiseUtils {
 
+// Constante: MAX_OCTAVES
+// Descrição: Número máximo de oitavas do fBm (os parâmetros de cada oitava ficam em vetores fixos).
+constexpr int MAX_OCTAVES = 8;
+
+// Estrutura: NoiseParams
+// Descrição: Parâmetros do motor de alturas: ruído de gradiente 2D com semente, somado em
+//            oitavas (fBm). Preenchida a partir do WorldConfig e aplicada com `configure`.
+struct NoiseParams {
+    quint32 seed = 1337;      // Semente do hash dos gradientes.
+    int octaves = 4;          // Número de oitavas (1 a MAX_OCTAVES).
+    float frequency = 0.02f;  // Frequência da primeira oitava, em ciclos por metro.
+    float amplitude = 0.0f;   // Amplitude da primeira oitava, em metros (0 = terreno plano).
+    float lacunarity = 2.0f;  // Multiplicador da frequência a cada oitava.
+    float gain = 0.5f;        // Multiplicador da amplitude a cada oitava.
+};
+
+// Função: configure
+// Descrição: Define os parâmetros do motor de alturas e pré-calcula a frequência, a amplitude
+//            e a semente de cada oitava. Deve ser chamada antes de qualquer thread de worker
+//            avaliar alturas (as avaliações apenas leem esse estado).
+// Parâmetros:
+//   - params: Os parâmetros do ruído.
+void configure(const NoiseParams& params);
+
+// Função: params
+// Descrição: Retorna os parâmetros em uso.
+// Retorno: const NoiseParams& - Os parâmetros aplicados pelo último `configure`.
+const NoiseParams& params();
+
+// Função: setHeightSource
+// Descrição: Registra uma fonte de alturas externa (ex.: DemHeightSource) que passa a responder
+//            por getHeight, getNormal e pelas funções em lote no lugar do ruído. Nulo volta ao ruído.
+//            Como `configure`, só deve ser chamada sem workers em execução; a fonte precisa
+//            continuar válida enquanto estiver registrada.
+// Parâmetros:
+//   - source: A fonte, ou nulo.
+void setHeightSource(const HeightSource* source);
+
+// Função: heightSource
+// Descrição: Retorna a fonte de alturas registrada.
+// Retorno: const HeightSource* - A fonte, ou nulo se o ruído procedural estiver em uso.
+const HeightSource* heightSource();
+
+namespace detail {
+
+// Estrutura: OctaveTable
+// Descrição: Parâmetros pré-calculados de cada oitava, em vetores separados (SoA), lidos pelos
+//            laços de avaliação sem nenhum cálculo ou alocação por chamada.
+struct OctaveTable {
+    int count = 0;
+    float frequency[MAX_OCTAVES] = {};
+    float amplitude[MAX_OCTAVES] = {};
+    quint32 seed[MAX_OCTAVES] = {};
+};
+
+// Variável: g_octaves
+// Descrição: A tabela de oitavas ativa (definida em noiseutils.cpp, escrita só por `configure`).
+extern OctaveTable g_octaves;
+
+// Variável: g_heightSource
+// Descrição: A fonte de alturas externa registrada (nula = ruído procedural).
+extern const HeightSource* g_heightSource;
+
+// Função: hash
+// Descrição: Hash inteiro de um canto da grade do ruído (só operações inteiras, vetorizável).
+Q_ALWAYS_INLINE quint32 hash(qint32 x, qint32 z, quint32 seed) {
+    quint32 h = static_cast<quint32>(x) * 0x27d4eb2du ^ static_cast<quint32>(z) * 0x165667b1u ^ seed;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return h;
+}
+
+// Função: gradient
+// Descrição: Gradiente pseudoaleatório de um canto, com componentes em [-1, 1] tiradas dos
+//            16 bits baixos e altos do hash (sem tabela, para não exigir leituras indexadas).
+Q_ALWAYS_INLINE void gradient(qint32 x, qint32 z, quint32 seed, float& gx, float& gz) {
+    quint32 h = hash(x, z, seed);
+    gx = static_cast<float>(static_cast<qint32>(h & 0xffffu)) * (1.0f / 32767.5f) - 1.0f;
+    gz = static_cast<float>(static_cast<qint32>(h >> 16)) * (1.0f / 32767.5f) - 1.0f;
+}
+
+// Função: gradientNoise
+// Descrição: Ruído de gradiente 2D (Perlin) com interpolação quíntica e derivadas analíticas.
+//            Sem desvios: o mesmo código serve aos kernels vetorizados.
+// Parâmetros:
+//   - x, z: Coordenadas no espaço do ruído.
+//   - seed: Semente da oitava.
+//   - dx, dz: Recebem as derivadas parciais do ruído em x e em z.
+// Retorno: float - O valor do ruído, aproximadamente em [-1, 1].
+Q_ALWAYS_INLINE float gradientNoise(float x, float z, quint32 seed, float& dx, float& dz) {
+    // Piso por truncamento + correção dos negativos: ao contrário de std::floor, vetoriza
+    // sem exigir -ffast-math (conversão com truncamento e seleção por comparação).
+    qint32 ix = static_cast<qint32>(x);
+    qint32 iz = static_cast<qint32>(z);
+    ix -= (x < static_cast<float>(ix)) ? 1 : 0;
+    iz -= (z < static_cast<float>(iz)) ? 1 : 0;
+    const float fx = x - static_cast<float>(ix);
+    const float fz = z - static_cast<float>(iz);
+
+    // Interpolação quíntica e sua derivada.
+    const float ux = fx * fx * fx * (fx * (fx * 6.0f - 15.0f) + 10.0f);
+    const float uz = fz * fz * fz * (fz * (fz * 6.0f - 15.0f) + 10.0f);
+    const float dux = 30.0f * fx * fx * (fx * (fx - 2.0f) + 1.0f);
+    const float duz = 30.0f * fz * fz * (fz * (fz - 2.0f) + 1.0f);
+
+    float gax, gaz, gbx, gbz, gcx, gcz, gdx, gdz;
+    gradient(ix, iz, seed, gax, gaz);
+    gradient(ix + 1, iz, seed, gbx, gbz);
+    gradient(ix, iz + 1, seed, gcx, gcz);
+    gradient(ix + 1, iz + 1, seed, gdx, gdz);
+
+    const float va = gax * fx + gaz * fz;
+    const float vb = gbx * (fx - 1.0f) + gbz * fz;
+    const float vc = gcx * fx + gcz * (fz - 1.0f);
+    const float vd = gdx * (fx - 1.0f) + gdz * (fz - 1.0f);
+    const float k = va - vb - vc + vd;
+
+    dx = gax + ux * (gbx - gax) + uz * (gcx - gax) + ux * uz * (gax - gbx - gcx + gdx) + dux * (uz * k + (vb - va));
+    dz = gaz + ux * (gbz - gaz) + uz * (gcz - gaz) + ux * uz * (gaz - gbz - gcz + gdz) + duz * (ux * k + (vc - va));
+    return va + ux * (vb - va) + uz * (vc - va) + ux * uz * k;
+}
+
+} // namespace detail
+
+// Função: getHeightAndDerivatives
+// Descrição: Calcula a altura do terreno (fBm de ruído de gradiente, ou a fonte registrada
+//            com `setHeightSource`) e suas derivadas parciais na mesma avaliação.
+// Parâmetros:
+//   - worldX: Coordenada X no espaço do mundo.
+//   - worldZ: Coordenada Z no espaço do mundo.
+//   - dHeightDx: Recebe a inclinação da altura em X.
+//   - dHeightDz: Recebe a inclinação da altura em Z.
+// Retorno: float - A altura do terreno na coordenada especificada.
+inline float getHeightAndDerivatives(float worldX, float worldZ, float& dHeightDx, float& dHeightDz) {
+    if (detail::g_heightSource) {
+        return detail::g_heightSource->heightAndDerivatives(worldX, worldZ, dHeightDx, dHeightDz);
+    }
+    const detail::OctaveTable& octaves = detail::g_octaves;
+    float height = 0.0f;
+    dHeightDx = 0.0f;
+    dHeightDz = 0.0f;
+    for (int o = 0; o < octaves.count; ++o) {
+        const float frequency = octaves.frequency[o];
+        const float amplitude = octaves.amplitude[o];
+        float dx, dz;
+        height += amplitude * detail::gradientNoise(worldX * frequency, worldZ * frequency, octaves.seed[o], dx, dz);
+        // Regra da cadeia: d/dx [a * n(f * x)] = a * f * n'(f * x).
+        dHeightDx += amplitude * frequency * dx;
+        dHeightDz += amplitude * frequency * dz;
+    }
+    return height;
+}
+
 // Função: getHeight
-// Descrição: Calcula e retorna a altura do terreno para uma dada coordenada no mundo (worldX, worldZ).
-//            Atualmente, retorna um valor fixo de 0.0f, mas é um placeholder para uma função
-//            de geração de ruído mais complexa (e.g., Perlin Noise, Simplex Noise).
+// Descrição: Calcula e retorna a altura do terreno para uma dada coordenada no mundo (worldX, worldZ):
+//            a soma das oitavas de ruído de gradiente configuradas em `configure`.
+//            Com amplitude 0 (padrão), o terreno é plano.
 // Parâmetros:
 //   - worldX: Coordenada X no espaço do mundo.
 //   - worldZ: Coordenada Z no espaço do mundo.
 // Retorno: float - A altura do terreno na coordenada especificada.
 inline float getHeight(float worldX, float worldZ) {
-    return 0.0f; // Este é um placeholder. Futuramente, uma função de ruído real seria implementada aqui.
+    float dx, dz;
+    return getHeightAndDerivatives(worldX, worldZ, dx, dz); // As derivadas não usadas são descartadas pelo compilador.
 }
 
 // Função: getNormal
 // Descrição: Calcula e retorna o vetor normal da superfície do terreno para uma dada coordenada no mundo (worldX, worldZ).
 //            A normal é usada para determinar como a luz reflete na superfície, influenciando a aparência do terreno.
-//            A implementação atual simula a normal usando pequenas amostras da altura ao redor do ponto.
+//            Vem das derivadas analíticas do ruído, na mesma avaliação da altura: (-dh/dx, 1, -dh/dz).
 // Parâmetros:
 //   - worldX: Coordenada X no espaço do mundo.
 //   - worldZ: Coordenada Z no espaço do mundo.
 // Retorno: QVector3D - O vetor normal normalizado na coordenada especificada.
 inline QVector3D getNormal(float worldX, float worldZ) {
+    float dx, dz;
+    getHeightAndDerivatives(worldX, worldZ, dx, dz);
+    return QVector3D(-dx, 1.0f, -dz).normalized();
+}
 
-    float offset = 0.1f; // Pequeno deslocamento usado para amostrar a altura em pontos vizinhos.
+// Enumeração: SimdLevel
+// Descrição: Conjunto de instruções usado pelas funções de avaliação em lote. Escolhido uma
+//            única vez, em tempo de execução, conforme o processador (x86: SSE4.1 ou AVX2 nas
+//            máquinas de desenvolvimento; ARM: NEON no i.MX8 da Toradex).
+enum class SimdLevel {
+    Scalar, // Referência escalar, sem vetorização.
+    Sse41,  // x86 com SSE4.1 (4 alturas por instrução).
+    Avx2,   // x86 com AVX2 + FMA (8 alturas por instrução).
+    Neon    // ARMv8 com Advanced SIMD (4 alturas por instrução).
+};
 
-    float hX_minus  = getHeight(worldX - offset, worldZ); // Altura à esquerda do ponto.
-    float hX_Plus = getHeight(worldX + offset, worldZ); // Altura à direita do ponto (corrigido: deveria ser worldX + offset).
-    float hZ_minus = getHeight(worldX, worldZ - offset); // Altura para "baixo" (Z negativo) do ponto (corrigido: deveria ser worldZ - offset).
-    float hZ_plus = getHeight(worldX, worldZ + offset); // Altura para "cima" (Z positivo) do ponto (corrigido: deveria ser worldZ + offset).
-    // Cálculo da normal usando as diferenças de altura. O vetor é então normalizado.
-    return QVector3D(hX_minus - hX_Plus, 2.0f * offset, hZ_minus - hZ_plus).normalized();
-}
+// Função: getHeights
+// Descrição: Avalia a altura do terreno em um lote de coordenadas arbitrárias, usando o
+//            kernel vetorizado selecionado em tempo de execução. Equivale a chamar
+//            `getHeight(worldX[i], worldZ[i])` para cada i.
+// Parâmetros:
+//   - worldX: Coordenadas X no espaço do mundo (count valores).
+//   - worldZ: Coordenadas Z no espaço do mundo (count valores).
+//   - count: Número de pontos.
+//   - outHeights: Destino das alturas (count valores).
+void getHeights(const float* worldX, const float* worldZ, int count, float* outHeights);
+
+// Função: getHeightRow
+// Descrição: Avalia a altura do terreno em uma linha de pontos igualmente espaçados em X
+//            (uma linha da grade de um chunk): x = startX + i * stepX, z = worldZ.
+//            Usa o kernel vetorizado selecionado em tempo de execução.
+// Parâmetros:
+//   - startX: Coordenada X do primeiro ponto.
+//   - stepX: Distância em X entre pontos vizinhos.
+//   - worldZ: Coordenada Z de toda a linha.
+//   - count: Número de pontos.
+//   - outHeights: Destino das alturas (count valores).
+void getHeightRow(float startX, float stepX, float worldZ, int count, float* outHeights);
+
+// Função: getHeightsScalar
+// Descrição: Referência escalar de `getHeights`, sem vetorização, para verificação dos kernels.
+void getHeightsScalar(const float* worldX, const float* worldZ, int count, float* outHeights);
+
+// Função: getHeightRowScalar
+// Descrição: Referência escalar de `getHeightRow`, sem vetorização, para verificação dos kernels.
+void getHeightRowScalar(float startX, float stepX, float worldZ, int count, float* outHeights);
+
+// Função: isSimdLevelAvailable
+// Descrição: Indica se o kernel de um nível foi compilado neste binário e se o processador atual
+//            tem as instruções dele. O nível Scalar está sempre disponível.
+// Parâmetros:
+//   - level: O nível.
+// Retorno: bool - true se `getHeightsWith` / `getHeightRowWith` podem usar o kernel do nível.
+bool isSimdLevelAvailable(SimdLevel level);
+
+// Função: getHeightsWith
+// Descrição: Como `getHeights`, mas com o kernel de um nível escolhido por quem chama, e não o
+//            detectado. Usada pelo teste dos kernels e pela medição de desempenho (tests/).
+//            Um nível indisponível usa a referência escalar.
+void getHeightsWith(SimdLevel level, const float* worldX, const float* worldZ, int count, float* outHeights);
+
+// Função: getHeightRowWith
+// Descrição: Como `getHeightRow`, mas com o kernel de um nível escolhido por quem chama.
+void getHeightRowWith(SimdLevel level, float startX, float stepX, float worldZ, int count, float* outHeights);
+
+// Função: activeSimdLevel
+// Descrição: Retorna o conjunto de instruções escolhido para as funções em lote.
+// Retorno: SimdLevel - O nível detectado na primeira chamada.
+SimdLevel activeSimdLevel();
+
+// Função: simdLevelName
+// Descrição: Retorna o nome legível de um nível, para o log.
+// Parâmetros:
+//   - level: O nível.
+// Retorno: const char* - "scalar", "sse4.1", "avx2" ou "neon".
+const char* simdLevelName(SimdLevel level);
 }
 #endif // NOISEUTILS_H
@@ -0,0 +1,111 @@
+#include "qualitygovernor.h"
+#include "worldconfig.h"  // Nível 0 e limites de temperatura.
+#include "logger.h"       // Para MY_LOG_INFO (registro das trocas de nível).
+#include <algorithm>      // Para std::max.
+
+/**
+ * @brief Construtor: monta a tabela de níveis a partir da configuração.
+ * @param config A configuração do mundo.
+ * @param source A fonte de temperatura (pode ser nula).
+ *
+ * Nível 0: a configuração. A cada nível: 2 chunks a menos no lado da área ativa, faixas de LOD
+ * mais curtas, uma thread de geração a menos (mínimo 1) e menos quadros por segundo.
+ */
+QualityGovernor::QualityGovernor(const WorldConfig& config, std::unique_ptr<ThermalSource> source)
+    : m_source(std::move(source)),
+    m_enabled(config.qualityGovernorEnabled),
+    m_throttleCelsius(config.thermalThrottleCelsius),
+    m_stepCelsius(config.thermalStepCelsius),
+    m_hysteresisCelsius(config.thermalHysteresisCelsius),
+    m_restoreHoldMs(config.qualityRestoreHoldMs)
+{
+    static const float LOD_SCALES[LEVEL_COUNT] = {1.0f, 0.75f, 0.5f, 0.35f};
+    static const int TARGET_FPS[LEVEL_COUNT] = {60, 45, 30, 20};
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        m_levels[level].gridRenderSize = std::max(3, config.gridRenderSize - 2 * level);
+        m_levels[level].lodDistanceScale = LOD_SCALES[level];
+        m_levels[level].workerThreads = std::max(1, config.terrainWorkerThreads - level);
+        m_levels[level].targetFps = TARGET_FPS[level];
+    }
+}
+
+/**
+ * @brief Lê a temperatura e decide o nível de qualidade.
+ * @param frameTimeMs Tempo médio de quadro desde a amostra anterior (0 se não houve quadros).
+ * @param nowMs Relógio monotônico, em milissegundos.
+ * @return true se o nível mudou.
+ *
+ * Piorar é imediato (a temperatura pode pular vários níveis de uma vez; o tempo de quadro desce
+ * um nível por amostra). Melhorar é um nível por vez e exige as três condições da histerese.
+ */
+bool QualityGovernor::sample(float frameTimeMs, qint64 nowMs)
+{
+    m_hasTemperature = m_source && m_source->readCelsius(&m_temperature, &m_lastError);
+    if (!m_enabled) {
+        return false;
+    }
+
+    int target = m_level;
+    QString reason;
+    if (m_hasTemperature) {
+        int thermalLevel = 0;
+        for (int level = 1; level < LEVEL_COUNT; ++level) {
+            if (m_temperature >= thresholdFor(level)) {
+                thermalLevel = level;
+            }
+        }
+        if (thermalLevel > m_level) {
+            target = thermalLevel;
+            reason = QString("temperatura %1 °C >= %2 °C").arg(m_temperature, 0, 'f', 1).arg(thresholdFor(thermalLevel), 0, 'f', 1);
+        }
+    }
+
+    if (target == m_level && m_level < LEVEL_COUNT - 1 && frameTimeMs > frameBudgetMs(m_level)) {
+        target = m_level + 1;
+        reason = QString("tempo de quadro %1 ms > %2 ms").arg(frameTimeMs, 0, 'f', 1).arg(frameBudgetMs(m_level), 0, 'f', 1);
+    }
+
+    if (target == m_level && m_level > 0 && nowMs - m_lastChangeMs >= m_restoreHoldMs) {
+        const bool coolEnough = !m_hasTemperature || m_temperature <= thresholdFor(m_level) - m_hysteresisCelsius;
+        const bool fastEnough = frameTimeMs <= RESTORE_FRAME_FRACTION * frameBudgetMs(m_level - 1);
+        if (coolEnough && fastEnough) {
+            target = m_level - 1;
+            reason = m_hasTemperature ? QString("temperatura %1 °C, tempo de quadro %2 ms").arg(m_temperature, 0, 'f', 1).arg(frameTimeMs, 0, 'f', 1)
+                                      : QString("tempo de quadro %1 ms").arg(frameTimeMs, 0, 'f', 1);
+        }
+    }
+
+    if (target == m_level) {
+        return false;
+    }
+
+    const int previous = m_level;
+    m_level = target;
+    m_lastChangeMs = nowMs;
+    const QualityLevel& current = m_levels[m_level];
+    MY_LOG_INFO("Governor", QString("Qualidade: nível %1 -> %2 (%3). Área %4x%4 chunks, LOD x%5, %6 threads, %7 quadros/s.")
+                                .arg(previous).arg(m_level).arg(reason)
+                                .arg(current.gridRenderSize)
+                                .arg(current.lodDistanceScale, 0, 'f', 2)
+                                .arg(current.workerThreads)
+                                .arg(current.targetFps));
+    return true;
+}
+
+/**
+ * @brief Temperatura a partir da qual um nível é exigido.
+ * @param level O nível (>= 1).
+ */
+float QualityGovernor::thresholdFor(int level) const
+{
+    return m_throttleCelsius + static_cast<float>(level - 1) * m_stepCelsius;
+}
+
+/**
+ * @brief Orçamento de tempo de quadro de um nível.
+ * @param level O nível.
+ */
+float QualityGovernor::frameBudgetMs(int level) const
+{
+    return 1000.0f / static_cast<float>(m_levels[level].targetFps);
+}
@@ -0,0 +1,105 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <QString>           // Motivo da última troca e erro da leitura de temperatura.
+#include <QtGlobal>          // Para qint64.
+#include <memory>            // Para std::unique_ptr (fonte de temperatura).
+#include "thermalsource.h"   // Fonte de temperatura (sysfs ou substituta).
+
+struct WorldConfig;
+
+// Estrutura: QualityLevel
+// Descrição: As configurações de um nível de qualidade do governador.
+struct QualityLevel {
+    int gridRenderSize;       // Lado da área de terreno ativa, em chunks (terrainmanager::setActiveGridSize).
+    float lodDistanceScale;   // Multiplicador das faixas de LOD (terrainmanager::setLodDistanceScale).
+    int workerThreads;        // Threads de geração de malha.
+    int targetFps;            // Taxa de ticks/quadros do widget.
+};
+
+// Classe: QualityGovernor
+// Descrição: Reduz a qualidade da renderização quando o SoC esquenta ou o tempo de quadro passa
+//            do orçamento, e a restaura quando as condições voltam, com histerese.
+//            O nível 0 é a configuração do WorldConfig; cada nível seguinte diminui a área de
+//            terreno, as distâncias de LOD, as threads de geração e a taxa de quadros.
+//            Cada nível k >= 1 tem um limite de temperatura (thermalThrottleCelsius +
+//            (k - 1) * thermalStepCelsius): acima dele, o governador vai direto para o nível.
+//            Para voltar um nível, a temperatura precisa ficar `thermalHysteresisCelsius` abaixo
+//            do limite do nível atual, o tempo de quadro bem abaixo do orçamento do nível
+//            anterior, e o nível atual precisa ter durado `qualityRestoreHoldMs`.
+//            Não acessa o OpenGL nem o terreno: quem chama aplica `settings()` quando `sample`
+//            indica uma troca. Toda troca é registrada no log. Desligado
+//            (WorldConfig::qualityGovernorEnabled), só lê a temperatura e fica no nível 0.
+class QualityGovernor {
+public:
+    // Constante: LEVEL_COUNT
+    // Descrição: Número de níveis de qualidade (0 = qualidade total).
+    static constexpr int LEVEL_COUNT = 4;
+
+    // Construtor: QualityGovernor
+    // Parâmetros:
+    //   - config: A configuração do mundo (nível 0 e limites de temperatura).
+    //   - source: A fonte de temperatura (pode ser nula: o governador usa só o tempo de quadro).
+    QualityGovernor(const WorldConfig& config, std::unique_ptr<ThermalSource> source);
+
+    // Método: sample
+    // Descrição: Lê a temperatura e decide o nível. Chamado periodicamente (a cada 2 s no gameTick).
+    // Parâmetros:
+    //   - frameTimeMs: Tempo médio de quadro medido desde a amostra anterior (0 = sem quadros).
+    //   - nowMs: Relógio monotônico, em milissegundos.
+    // Retorno: bool - true se o nível mudou (aplicar `settings()`).
+    bool sample(float frameTimeMs, qint64 nowMs);
+
+    // Método: level
+    // Descrição: Retorna o nível atual (0 = qualidade total).
+    int level() const { return m_level; }
+
+    // Método: settings
+    // Descrição: Retorna as configurações do nível atual.
+    const QualityLevel& settings() const { return m_levels[m_level]; }
+
+    // Método: hasTemperature / temperature / lastError
+    // Descrição: Resultado da última leitura de temperatura e, se ela falhou, o motivo.
+    bool hasTemperature() const { return m_hasTemperature; }
+    float temperature() const { return m_temperature; }
+    const QString& lastError() const { return m_lastError; }
+
+private:
+    // Método Privado: thresholdFor
+    // Descrição: Temperatura a partir da qual o nível `level` (>= 1) é exigido.
+    float thresholdFor(int level) const;
+
+    // Método Privado: frameBudgetMs
+    // Descrição: Orçamento de tempo de quadro de um nível (1000 / targetFps).
+    float frameBudgetMs(int level) const;
+
+    // Constante: RESTORE_FRAME_FRACTION
+    // Descrição: Fração do orçamento do nível anterior abaixo da qual o tempo de quadro permite voltar.
+    static constexpr float RESTORE_FRAME_FRACTION = 0.6f;
+
+    // Membro: m_levels
+    // Tipo: QualityLevel[LEVEL_COUNT]
+    // Descrição: As configurações de cada nível, calculadas da configuração no construtor.
+    QualityLevel m_levels[LEVEL_COUNT];
+
+    // Membro: m_source
+    // Tipo: std::unique_ptr<ThermalSource>
+    // Descrição: A fonte de temperatura.
+    std::unique_ptr<ThermalSource> m_source;
+
+    // Membros de configuração (copiados do WorldConfig).
+    bool m_enabled;
+    float m_throttleCelsius;
+    float m_stepCelsius;
+    float m_hysteresisCelsius;
+    qint64 m_restoreHoldMs;
+
+    // Membros de estado.
+    int m_level = 0;
+    qint64 m_lastChangeMs = 0;
+    bool m_hasTemperature = false;
+    float m_temperature = 0.0f;
+    QString m_lastError;
+};
+
+#endif // QUALITYGOVERNOR_H
@@ -0,0 +1,317 @@
+#include "terrainbatchbuffers.h" // Inclui o cabeçalho da classe TerrainBatchBuffers.
+#include "chunk.h"               // Formatos de vértice e configuração dos atributos.
+#include "terrainindexbuffers.h" // Grade de índices de uma resolução.
+#include <QDebug>                // Para mensagens de depuração (qInfo, qWarning).
+#include <algorithm>             // Para std::clamp, std::lower_bound, std::remove_if e std::sort.
+#include <functional>            // Para std::greater (lista de slots livres decrescente).
+
+/**
+ * @brief Define o formato dos vértices guardados nas páginas.
+ * @param compact true para `CompactVertex`, false para `Vertex`.
+ */
+void TerrainBatchBuffers::setVertexFormat(bool compact)
+{
+    m_compact = compact;
+    m_vertexStride = compact ? static_cast<int>(sizeof(CompactVertex)) : static_cast<int>(sizeof(Vertex));
+}
+
+/**
+ * @brief Cria páginas até haver um número mínimo de slots livres da resolução.
+ * @param resolution Vértices por lado da malha.
+ * @param slotCount Número de slots desejado.
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ */
+void TerrainBatchBuffers::reserve(int resolution, int slotCount, QOpenGLFunctions* glFuncs)
+{
+    if (resolution <= 1 || slotCount <= 0 || !glFuncs) {
+        return;
+    }
+    Resolution& entry = resolutionFor(resolution);
+    int freeSlots = 0;
+    for (const auto& page : entry.pages) {
+        freeSlots += static_cast<int>(page->freeSlots.size());
+    }
+    while (freeSlots < slotCount) {
+        addPage(entry, glFuncs);
+        freeSlots += entry.slotsPerPage;
+    }
+}
+
+/**
+ * @brief Envia os vértices de uma malha para um slot livre.
+ * @param resolution Vértices por lado da malha.
+ * @param vertices Os vértices.
+ * @param vertexCount Quantidade de vértices.
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ * @return O slot ocupado, ou um slot inválido.
+ *
+ * Usa o menor slot livre da primeira página que tiver um, para que os chunks fiquem
+ * agrupados no começo das páginas e os slots visíveis formem faixas longas no desenho.
+ */
+TerrainBatchSlot TerrainBatchBuffers::write(int resolution, const void* vertices, int vertexCount,
+                                            QOpenGLFunctions* glFuncs)
+{
+    TerrainBatchSlot result;
+    if (resolution <= 1 || !vertices || !glFuncs || vertexCount != resolution * resolution) {
+        return result;
+    }
+    Resolution& entry = resolutionFor(resolution);
+    if (!entry.ebo) {
+        return result;
+    }
+
+    int pageIndex = 0;
+    while (pageIndex < static_cast<int>(entry.pages.size()) && entry.pages[pageIndex]->freeSlots.empty()) {
+        ++pageIndex;
+    }
+    if (pageIndex == static_cast<int>(entry.pages.size())) {
+        addPage(entry, glFuncs);
+    }
+    Page& page = *entry.pages[pageIndex];
+    const int slot = page.freeSlots.back();
+    page.freeSlots.pop_back();
+
+    const int slotBytes = entry.vertexCount * m_vertexStride;
+    page.vbo->bind();
+    page.vbo->write(slot * slotBytes, vertices, slotBytes); // glBufferSubData só na faixa do slot.
+    page.vbo->release();
+
+    result.resolution = resolution;
+    result.page = pageIndex;
+    result.slot = slot;
+    return result;
+}
+
+/**
+ * @brief Libera um slot; ele só volta aos livres depois de RETIRE_FRAMES quadros.
+ * @param slot O slot a liberar.
+ */
+void TerrainBatchBuffers::retire(const TerrainBatchSlot& slot)
+{
+    if (!slot.isValid()) {
+        return;
+    }
+    m_retired.push_back({slot, m_frame});
+}
+
+/**
+ * @brief Avança o quadro e devolve aos livres os slots aposentados há tempo suficiente.
+ */
+void TerrainBatchBuffers::beginFrame()
+{
+    ++m_frame;
+    auto ready = [this](const RetiredSlot& retired) {
+        if (m_frame - retired.frame < static_cast<quint64>(RETIRE_FRAMES)) {
+            return false;
+        }
+        auto it = m_resolutions.find(retired.slot.resolution);
+        if (it != m_resolutions.end() && retired.slot.page < static_cast<int>(it->second.pages.size())) {
+            Page& page = *it->second.pages[retired.slot.page];
+            // Mantém a lista decrescente, para que back() continue sendo o menor slot livre.
+            auto pos = std::lower_bound(page.freeSlots.begin(), page.freeSlots.end(), retired.slot.slot,
+                                        std::greater<int>());
+            page.freeSlots.insert(pos, retired.slot.slot);
+        }
+        return true;
+    };
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), ready), m_retired.end());
+}
+
+/**
+ * @brief Marca um slot para o próximo desenho da sua resolução.
+ * @param slot O slot do chunk.
+ * @param originX Canto X do chunk no mundo.
+ * @param originY Altura de referência da malha (formato compacto).
+ * @param originZ Canto Z do chunk no mundo.
+ * @param drawOrder Posição do chunk na ordem de desenho.
+ */
+void TerrainBatchBuffers::markVisible(const TerrainBatchSlot& slot, float originX, float originY, float originZ, int drawOrder)
+{
+    if (!slot.isValid()) {
+        return;
+    }
+    auto it = m_resolutions.find(slot.resolution);
+    if (it == m_resolutions.end() || slot.page >= static_cast<int>(it->second.pages.size())) {
+        return;
+    }
+    Page& page = *it->second.pages[slot.page];
+    page.origins[slot.slot] = QVector4D(originX, originZ, originY, 0.0f); // (x, z, y): ver chunkToWorld nos shaders.
+    page.visible[slot.slot] = 1;
+    page.drawOrder[slot.slot] = drawOrder;
+}
+
+/**
+ * @brief Desenha os slots marcados de uma resolução.
+ * @param resolution Vértices por lado da malha.
+ * @param program O shader de terreno (ligado).
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ * @return Chamadas de desenho feitas.
+ *
+ * Junta os slots vizinhos marcados de cada página em faixas (os índices de uma faixa são
+ * contíguos no EBO compartilhado) e desenha as faixas em ordem crescente de `drawOrder`, com
+ * um glDrawElements cada. Ao passar para outra página, liga o seu VAO e envia as suas origens
+ * (até o último slot marcado). Dentro de uma faixa, a ordem é a dos slots.
+ */
+int TerrainBatchBuffers::drawVisible(int resolution, QOpenGLShaderProgram* program, QOpenGLFunctions* glFuncs)
+{
+    auto it = m_resolutions.find(resolution);
+    if (it == m_resolutions.end() || !program || !glFuncs) {
+        return 0;
+    }
+    Resolution& entry = it->second;
+
+    // Um slot marcado por entrada, na ordem de desenho.
+    m_runs.clear();
+    for (int pageIndex = 0; pageIndex < static_cast<int>(entry.pages.size()); ++pageIndex) {
+        Page& page = *entry.pages[pageIndex];
+        page.originCount = 0;
+        for (int slot = 0; slot < entry.slotsPerPage; ++slot) {
+            if (page.visible[slot]) {
+                m_runs.push_back(Run{pageIndex, slot, 1, page.drawOrder[slot]});
+                page.visible[slot] = 0;
+                page.originCount = slot + 1; // Origens enviadas até o último slot marcado.
+            }
+        }
+    }
+    if (m_runs.empty()) {
+        return 0;
+    }
+    std::sort(m_runs.begin(), m_runs.end(), [](const Run& a, const Run& b) { return a.drawOrder < b.drawOrder; });
+
+    // Junta em uma faixa só os slots vizinhos da mesma página que também são os próximos na
+    // ordem: a faixa é desenhada inteira de uma vez, então juntar slots fora de ordem tiraria
+    // do lugar os chunks entre eles.
+    size_t runCount = 0;
+    for (size_t i = 0; i < m_runs.size(); ++i) {
+        const Run& next = m_runs[i];
+        if (runCount > 0) {
+            Run& last = m_runs[runCount - 1];
+            if (next.page == last.page && next.firstSlot == last.firstSlot + last.slotCount) {
+                ++last.slotCount;
+                continue;
+            }
+        }
+        m_runs[runCount++] = next;
+    }
+    m_runs.resize(runCount);
+
+    program->setUniformValue("batchVertexCount", entry.vertexCount);
+    int boundPage = -1;
+    for (const Run& run : m_runs) {
+        Page& page = *entry.pages[run.page];
+        if (run.page != boundPage) {
+            if (boundPage >= 0) {
+                entry.pages[boundPage]->vao->release();
+            }
+            program->setUniformValueArray("chunkOrigins", page.origins.data(), page.originCount);
+            page.vao->bind();
+            boundPage = run.page;
+        }
+        const size_t offset = static_cast<size_t>(run.firstSlot) * static_cast<size_t>(entry.indexCount) * sizeof(GLuint);
+        glFuncs->glDrawElements(GL_TRIANGLES, run.slotCount * entry.indexCount, GL_UNSIGNED_INT,
+                                reinterpret_cast<const void*>(offset));
+    }
+    entry.pages[boundPage]->vao->release();
+    return static_cast<int>(m_runs.size());
+}
+
+/**
+ * @brief Libera todas as páginas e os EBOs.
+ */
+void TerrainBatchBuffers::clear()
+{
+    m_resolutions.clear();
+    m_retired.clear();
+    m_allocatedBytes = 0;
+}
+
+/**
+ * @brief Retorna o total de páginas, de todas as resoluções.
+ */
+int TerrainBatchBuffers::pageCount() const
+{
+    int count = 0;
+    for (const auto& entry : m_resolutions) {
+        count += static_cast<int>(entry.second.pages.size());
+    }
+    return count;
+}
+
+/**
+ * @brief Retorna os dados de uma resolução, criando o EBO compartilhado na primeira vez.
+ * @param resolution Vértices por lado da malha.
+ *
+ * O EBO repete a grade de índices da resolução uma vez por slot, deslocada de
+ * slot * vértices por chunk (o papel do basevertex que o GLES 3.0 não tem). Os índices são
+ * sempre de 32 bits: uma página passa de 65536 vértices mesmo no formato compacto.
+ */
+TerrainBatchBuffers::Resolution& TerrainBatchBuffers::resolutionFor(int resolution)
+{
+    Resolution& entry = m_resolutions[resolution];
+    if (entry.ebo) {
+        return entry;
+    }
+
+    entry.vertexCount = resolution * resolution;
+    entry.indexCount = TerrainIndexBuffers::indexCount(resolution);
+    entry.slotsPerPage = std::clamp(PAGE_TARGET_BYTES / std::max(1, entry.vertexCount * m_vertexStride),
+                                    1, MAX_SLOTS_PER_PAGE);
+
+    const std::vector<GLuint> grid = TerrainIndexBuffers::buildGridIndices(resolution);
+    std::vector<GLuint> indices;
+    indices.reserve(grid.size() * static_cast<size_t>(entry.slotsPerPage));
+    for (int slot = 0; slot < entry.slotsPerPage; ++slot) {
+        const GLuint base = static_cast<GLuint>(slot * entry.vertexCount);
+        for (GLuint index : grid) {
+            indices.push_back(base + index);
+        }
+    }
+
+    entry.ebo = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::IndexBuffer);
+    entry.ebo->create();
+    entry.ebo->setUsagePattern(QOpenGLBuffer::StaticDraw); // Os índices nunca mudam.
+    entry.ebo->bind();
+    entry.ebo->allocate(indices.data(), static_cast<int>(indices.size() * sizeof(GLuint)));
+    entry.ebo->release();
+    m_allocatedBytes += static_cast<qint64>(indices.size() * sizeof(GLuint));
+    return entry;
+}
+
+/**
+ * @brief Cria uma página de uma resolução.
+ * @param entry Os dados da resolução.
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ *
+ * O VBO é alocado sem dados; o VAO guarda os atributos do formato e o EBO compartilhado.
+ */
+void TerrainBatchBuffers::addPage(Resolution& entry, QOpenGLFunctions* glFuncs)
+{
+    auto page = std::make_unique<Page>();
+    const int pageBytes = entry.slotsPerPage * entry.vertexCount * m_vertexStride;
+
+    page->vbo = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer);
+    page->vbo->create();
+    page->vbo->setUsagePattern(QOpenGLBuffer::DynamicDraw); // Slots reescritos a cada mudança de malha.
+    page->vbo->bind();
+    page->vbo->allocate(pageBytes);
+
+    page->vao = std::make_unique<QOpenGLVertexArrayObject>();
+    page->vao->create();
+    page->vao->bind();
+    chunk::setupVertexAttributes(glFuncs, m_compact ? TerrainVertexFormat::Compact : TerrainVertexFormat::Full);
+    entry.ebo->bind(); // O vínculo do EBO faz parte do estado do VAO.
+    page->vao->release();
+    entry.ebo->release();
+    page->vbo->release();
+
+    page->freeSlots.reserve(entry.slotsPerPage);
+    for (int slot = entry.slotsPerPage - 1; slot >= 0; --slot) {
+        page->freeSlots.push_back(slot);
+    }
+    page->origins.assign(entry.slotsPerPage, QVector4D());
+    page->visible.assign(entry.slotsPerPage, 0);
+    page->drawOrder.assign(entry.slotsPerPage, 0);
+
+    entry.pages.push_back(std::move(page));
+    m_allocatedBytes += pageBytes;
+}
@@ -0,0 +1,198 @@
+#ifndef TERRAINBATCHBUFFERS_H
+#define TERRAINBATCHBUFFERS_H
+
+#include <QOpenGLBuffer>             // VBOs das páginas e EBO compartilhado de cada resolução.
+#include <QOpenGLVertexArrayObject>  // Um VAO por página.
+#include <QOpenGLFunctions>          // Para glDrawElements e os ponteiros de atributo.
+#include <QOpenGLShaderProgram>      // Uniformes do desenho em lote (origens dos chunks).
+#include <QVector4D>                 // Origem de cada slot, enviada ao shader.
+#include <QtGlobal>                  // Para quint64 e quint8.
+#include <map>                       // Páginas agrupadas por resolução.
+#include <memory>                    // Para std::unique_ptr (objetos OpenGL).
+#include <vector>                    // Listas de páginas, slots livres e aposentados.
+
+// Estrutura: TerrainBatchSlot
+// Descrição: Onde está a malha de um chunk no desenho em lote: a resolução, a página dessa
+//            resolução e o slot dentro da página. Um slot inválido (page < 0) não tem malha.
+struct TerrainBatchSlot {
+    int resolution = 0;
+    int page = -1;
+    int slot = -1;
+
+    bool isValid() const { return page >= 0; }
+};
+
+// Classe: TerrainBatchBuffers
+// Descrição: Armazena os vértices de todos os chunks de uma mesma resolução (nível de LOD) em
+//            poucos VBOs grandes ("páginas"), cada um dividido em slots de tamanho fixo, para que
+//            o terreno inteiro seja desenhado com poucas chamadas em vez de uma por chunk.
+//            O GLES 3.0 não tem glDrawElementsBaseVertex, então o EBO de uma resolução repete a
+//            grade de índices uma vez por slot, já deslocada de slot * vértices por chunk. O
+//            shader obtém o slot de gl_VertexID / batchVertexCount e a origem do chunk no
+//            uniforme `chunkOrigins`, enviado uma vez por página; os slots vizinhos visíveis saem
+//            em um único glDrawElements.
+//            Um slot liberado só volta a ser usado depois de RETIRE_FRAMES quadros, para que a
+//            reescrita não espere a GPU terminar de desenhar o quadro anterior.
+//            Deve ser usada apenas na thread que possui o contexto OpenGL.
+class TerrainBatchBuffers {
+public:
+    // Constante: MAX_SLOTS_PER_PAGE
+    // Descrição: Máximo de chunks por página. Limitado pelo tamanho do array `chunkOrigins` do
+    //            shader (o GLES 3.0 garante só 256 vetores de uniformes no vertex shader).
+    static constexpr int MAX_SLOTS_PER_PAGE = 128;
+
+    // Constante: PAGE_TARGET_BYTES
+    // Descrição: Tamanho aproximado do VBO de uma página; define quantos slots ela tem
+    //            (poucos nas resoluções altas, até MAX_SLOTS_PER_PAGE nas baixas).
+    static constexpr int PAGE_TARGET_BYTES = 1024 * 1024;
+
+    // Constante: RETIRE_FRAMES
+    // Descrição: Quadros que um slot liberado espera antes de ser reaproveitado.
+    static constexpr int RETIRE_FRAMES = 2;
+
+    TerrainBatchBuffers() = default;
+
+    // Impedir Cópias (Deletadas): a classe possui objetos OpenGL.
+    TerrainBatchBuffers(const TerrainBatchBuffers&) = delete;
+    TerrainBatchBuffers& operator=(const TerrainBatchBuffers&) = delete;
+
+    // Método: setVertexFormat
+    // Descrição: Define o formato dos vértices guardados (`Vertex` ou `CompactVertex`).
+    //            Deve ser chamado antes da primeira página.
+    // Parâmetros:
+    //   - compact: true para `CompactVertex`.
+    void setVertexFormat(bool compact);
+
+    // Método: reserve
+    // Descrição: Cria páginas até haver `slotCount` slots livres da resolução (na inicialização,
+    //            para que os primeiros uploads não criem objetos OpenGL). Requer o contexto ativo.
+    // Parâmetros:
+    //   - resolution: Vértices por lado da malha.
+    //   - slotCount: Número de slots desejado.
+    //   - glFuncs: Ponteiro para as funções OpenGL.
+    void reserve(int resolution, int slotCount, QOpenGLFunctions* glFuncs);
+
+    // Método: write
+    // Descrição: Pega um slot livre da resolução (criando uma página se preciso) e envia os
+    //            vértices para ele (glBufferSubData). Requer o contexto ativo.
+    // Parâmetros:
+    //   - resolution: Vértices por lado da malha.
+    //   - vertices: Os vértices, no formato definido em `setVertexFormat`.
+    //   - vertexCount: Quantidade de vértices (resolution²).
+    //   - glFuncs: Ponteiro para as funções OpenGL.
+    // Retorno: TerrainBatchSlot - O slot ocupado, ou inválido se a malha não cabe em um slot.
+    TerrainBatchSlot write(int resolution, const void* vertices, int vertexCount, QOpenGLFunctions* glFuncs);
+
+    // Método: retire
+    // Descrição: Libera um slot. Ele volta a ficar disponível depois de RETIRE_FRAMES quadros.
+    // Parâmetros:
+    //   - slot: O slot (ignorado se inválido).
+    void retire(const TerrainBatchSlot& slot);
+
+    // Método: beginFrame
+    // Descrição: Avança o contador de quadros e devolve aos livres os slots aposentados há
+    //            RETIRE_FRAMES quadros. Chamado uma vez por quadro, antes dos uploads.
+    void beginFrame();
+
+    // Método: markVisible
+    // Descrição: Marca um slot para ser desenhado no próximo `drawVisible` da sua resolução.
+    // Parâmetros:
+    //   - slot: O slot do chunk.
+    //   - originX / originZ: Canto do chunk no mundo (o que a matriz de modelo faria).
+    //   - originY: Altura de referência da malha (chunk::heightBase; 0 fora do formato compacto).
+    //   - drawOrder: Posição do chunk na ordem de desenho (menor primeiro: o mais próximo).
+    void markVisible(const TerrainBatchSlot& slot, float originX, float originY, float originZ, int drawOrder = 0);
+
+    // Método: drawVisible
+    // Descrição: Desenha os slots marcados da resolução em ordem crescente de `drawOrder` (de
+    //            frente para trás, para o early-Z): um glDrawElements por faixa de slots vizinhos
+    //            da mesma página que também são consecutivos nessa ordem. As origens de uma página
+    //            são enviadas quando o desenho passa para ela. As marcas são limpas. Os uniformes
+    //            do nível (morphing, passo da grade) devem ser definidos por quem chama.
+    // Parâmetros:
+    //   - resolution: Vértices por lado da malha.
+    //   - program: O shader de terreno (ligado).
+    //   - glFuncs: Ponteiro para as funções OpenGL.
+    // Retorno: int - Chamadas de desenho feitas.
+    int drawVisible(int resolution, QOpenGLShaderProgram* program, QOpenGLFunctions* glFuncs);
+
+    // Método: clear
+    // Descrição: Libera todas as páginas. Requer o contexto OpenGL ativo.
+    void clear();
+
+    // Métodos de diagnóstico.
+    int pageCount() const;
+    qint64 allocatedBytes() const { return m_allocatedBytes; }
+
+private:
+    // Estrutura: Page
+    // Descrição: Um VBO com `slotsPerPage` malhas de uma resolução, e o VAO que o liga ao EBO.
+    struct Page {
+        std::unique_ptr<QOpenGLBuffer> vbo;
+        std::unique_ptr<QOpenGLVertexArrayObject> vao;
+        std::vector<int> freeSlots;      // Em ordem decrescente: back() é o menor slot livre.
+        std::vector<QVector4D> origins;  // Origem (x, z) de cada slot, para `chunkOrigins`.
+        std::vector<quint8> visible;     // Slots marcados para o próximo desenho.
+        std::vector<int> drawOrder;      // Ordem de desenho de cada slot marcado.
+        int originCount = 0;             // Origens a enviar no desenho (até o último slot marcado).
+    };
+
+    // Estrutura: Run
+    // Descrição: Uma faixa de slots vizinhos marcados de uma página, consecutivos na ordem de
+    //            desenho, e a ordem do seu primeiro slot.
+    struct Run {
+        int page;
+        int firstSlot;
+        int slotCount;
+        int drawOrder;
+    };
+
+    // Estrutura: Resolution
+    // Descrição: As páginas de uma resolução e o EBO que todas compartilham (os índices são
+    //            relativos ao início do VBO, iguais em todas as páginas).
+    struct Resolution {
+        int vertexCount = 0;       // Vértices por chunk.
+        int indexCount = 0;        // Índices por chunk.
+        int slotsPerPage = 0;
+        std::unique_ptr<QOpenGLBuffer> ebo;
+        std::vector<std::unique_ptr<Page>> pages;
+    };
+
+    // Estrutura: RetiredSlot
+    // Descrição: Um slot liberado e o quadro em que isso aconteceu.
+    struct RetiredSlot {
+        TerrainBatchSlot slot;
+        quint64 frame;
+    };
+
+    // Método Privado: resolutionFor
+    // Descrição: Retorna os dados da resolução, criando o EBO na primeira vez.
+    Resolution& resolutionFor(int resolution);
+
+    // Método Privado: addPage
+    // Descrição: Cria uma página da resolução (VBO, VAO e atributos) e a adiciona à lista.
+    void addPage(Resolution& entry, QOpenGLFunctions* glFuncs);
+
+    // Membro: m_resolutions
+    // Tipo: std::map<int, Resolution>
+    // Descrição: As páginas de cada resolução já usada.
+    std::map<int, Resolution> m_resolutions;
+
+    // Membro: m_retired
+    // Tipo: std::vector<RetiredSlot>
+    // Descrição: Slots liberados esperando RETIRE_FRAMES quadros.
+    std::vector<RetiredSlot> m_retired;
+
+    // Membro: m_runs
+    // Tipo: std::vector<Run>
+    // Descrição: Faixas do `drawVisible` em andamento (reaproveitado entre quadros).
+    std::vector<Run> m_runs;
+
+    // Membros de configuração e diagnóstico.
+    bool m_compact = false;
+    int m_vertexStride = 0;
+    quint64 m_frame = 0;
+    qint64 m_allocatedBytes = 0;
+};
+
+#endif // TERRAINBATCHBUFFERS_H
@@ -0,0 +1,64 @@
+#include "terrainbufferpool.h" // Inclui o cabeçalho da classe TerrainBufferPool.
+
+/**
+ * @brief Garante um número mínimo de buffers livres de um tamanho.
+ * @param byteSize Tamanho de cada buffer, em bytes.
+ * @param count Número de buffers livres desejado.
+ */
+void TerrainBufferPool::preallocate(int byteSize, int count)
+{
+    if (byteSize <= 0) {
+        return;
+    }
+    std::vector<std::unique_ptr<QOpenGLBuffer>>& freeList = m_freeBuffers[byteSize];
+    while (static_cast<int>(freeList.size()) < count) {
+        freeList.push_back(createBuffer(byteSize));
+    }
+}
+
+/**
+ * @brief Retira um buffer do pool (ou cria um novo).
+ * @param byteSize Tamanho do buffer, em bytes.
+ * @return O buffer, com `byteSize` bytes alocados.
+ */
+std::unique_ptr<QOpenGLBuffer> TerrainBufferPool::acquire(int byteSize)
+{
+    auto it = m_freeBuffers.find(byteSize);
+    if (it != m_freeBuffers.end() && !it->second.empty()) {
+        std::unique_ptr<QOpenGLBuffer> buffer = std::move(it->second.back());
+        it->second.pop_back();
+        ++m_reusedBuffers;
+        return buffer;
+    }
+    return createBuffer(byteSize);
+}
+
+/**
+ * @brief Devolve um buffer ao pool.
+ * @param buffer O buffer a ser reaproveitado.
+ * @param byteSize O tamanho com que o buffer foi obtido.
+ *
+ * O conteúdo antigo não é apagado: quem o pegar de novo vai sobrescrevê-lo inteiro.
+ */
+void TerrainBufferPool::release(std::unique_ptr<QOpenGLBuffer> buffer, int byteSize)
+{
+    if (!buffer || !buffer->isCreated() || byteSize <= 0) {
+        return;
+    }
+    m_freeBuffers[byteSize].push_back(std::move(buffer));
+}
+
+/**
+ * @brief Cria um VBO com `byteSize` bytes alocados e sem dados.
+ */
+std::unique_ptr<QOpenGLBuffer> TerrainBufferPool::createBuffer(int byteSize)
+{
+    auto buffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer);
+    buffer->create();
+    buffer->setUsagePattern(QOpenGLBuffer::DynamicDraw); // Reescrito a cada mudança de malha.
+    buffer->bind();
+    buffer->allocate(byteSize); // Só reserva o armazenamento.
+    buffer->release();
+    ++m_createdBuffers;
+    return buffer;
+}
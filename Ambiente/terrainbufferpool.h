@@ -0,0 +1,79 @@
+#ifndef TERRAINBUFFERPOOL_H
+#define TERRAINBUFFERPOOL_H
+
+#include <QOpenGLBuffer>  // Para os VBOs reaproveitados entre chunks.
+#include <map>            // Para as listas de buffers livres, por tamanho.
+#include <memory>         // Para std::unique_ptr (posse dos buffers).
+#include <vector>         // Para as listas de buffers livres.
+
+// Classe: TerrainBufferPool
+// Descrição: Pool de VBOs de terreno, agrupados pelo tamanho em bytes. Como cada LOD tem uma
+//            resolução fixa, há poucos tamanhos distintos (um por LOD e formato de vértice).
+//            Um chunk que muda de LOD devolve o seu VBO ao pool e pega um do novo tamanho,
+//            em vez de destruir e criar objetos OpenGL no meio do quadro, o que no driver
+//            da GPU do i.MX8 causa alocações e travamentos.
+//            Deve ser usada apenas na thread que possui o contexto OpenGL.
+class TerrainBufferPool {
+public:
+    TerrainBufferPool() = default;
+
+    // Impedir Cópias (Deletadas): a classe possui objetos OpenGL.
+    TerrainBufferPool(const TerrainBufferPool&) = delete;
+    TerrainBufferPool& operator=(const TerrainBufferPool&) = delete;
+
+    // Método: preallocate
+    // Descrição: Garante que haja pelo menos `count` buffers livres de `byteSize` bytes.
+    //            Chamado na inicialização, para que os primeiros uploads não criem buffers.
+    // Parâmetros:
+    //   - byteSize: Tamanho de cada buffer, em bytes.
+    //   - count: Número de buffers livres desejado.
+    void preallocate(int byteSize, int count);
+
+    // Método: acquire
+    // Descrição: Retira do pool um buffer de `byteSize` bytes, ou cria um novo se não houver.
+    // Parâmetros:
+    //   - byteSize: Tamanho do buffer, em bytes.
+    // Retorno: std::unique_ptr<QOpenGLBuffer> - O buffer, com armazenamento já alocado.
+    std::unique_ptr<QOpenGLBuffer> acquire(int byteSize);
+
+    // Método: release
+    // Descrição: Devolve um buffer ao pool, para ser reaproveitado por outro chunk.
+    //            O tamanho é informado por quem devolve (QOpenGLBuffer::size() consultaria
+    //            o driver de forma síncrona e exige o buffer ligado).
+    // Parâmetros:
+    //   - buffer: O buffer (pode ser nulo).
+    //   - byteSize: O tamanho com que o buffer foi obtido em `acquire`.
+    void release(std::unique_ptr<QOpenGLBuffer> buffer, int byteSize);
+
+    // Método: createdBuffers
+    // Descrição: Retorna quantos buffers o pool já criou (diagnóstico).
+    // Retorno: int - Total de buffers criados.
+    int createdBuffers() const { return m_createdBuffers; }
+
+    // Método: reusedBuffers
+    // Descrição: Retorna quantas vezes um buffer livre foi reaproveitado (diagnóstico).
+    // Retorno: int - Total de reaproveitamentos.
+    int reusedBuffers() const { return m_reusedBuffers; }
+
+private:
+    // Método Privado: createBuffer
+    // Descrição: Cria um VBO e aloca `byteSize` bytes sem dados iniciais.
+    std::unique_ptr<QOpenGLBuffer> createBuffer(int byteSize);
+
+    // Membro: m_freeBuffers
+    // Tipo: std::map<int, std::vector<std::unique_ptr<QOpenGLBuffer>>>
+    // Descrição: Os buffers livres, agrupados por tamanho em bytes.
+    std::map<int, std::vector<std::unique_ptr<QOpenGLBuffer>>> m_freeBuffers;
+
+    // Membro: m_createdBuffers
+    // Tipo: int
+    // Descrição: Total de buffers criados.
+    int m_createdBuffers = 0;
+
+    // Membro: m_reusedBuffers
+    // Tipo: int
+    // Descrição: Total de buffers reaproveitados.
+    int m_reusedBuffers = 0;
+};
+
+#endif // TERRAINBUFFERPOOL_H
@@ -0,0 +1,128 @@
+#include "terraincompletionqueue.h" // Inclui o cabeçalho da classe TerrainCompletionQueue.
+#include <chrono>                    // Para std::chrono::steady_clock (relógio monotônico).
+#include <cstdint>                   // Para intptr_t (diferença com sinal entre posições).
+
+/**
+ * @brief Construtor da classe TerrainCompletionQueue.
+ * @param capacity Número mínimo de malhas que a fila comporta.
+ *
+ * A capacidade é arredondada para a próxima potência de 2 (mínimo 2), para que o
+ * índice da célula seja obtido com uma máscara. Cada célula começa com a sequência
+ * igual à sua posição, ou seja, livre para a primeira volta dos produtores.
+ */
+TerrainCompletionQueue::TerrainCompletionQueue(size_t capacity) :
+    m_mask(0),
+    m_enqueuePos(0),
+    m_dequeuePos(0),
+    m_fullRetries(0),
+    m_waitingProducers(0)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_mask = size - 1;
+    m_cells.reset(new Cell[size]);
+    for (size_t i = 0; i < size; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Tenta enfileirar uma malha.
+ * @param mesh A malha; movida apenas em caso de sucesso.
+ * @return false se a fila estiver cheia.
+ *
+ * O produtor reserva uma posição com compare-exchange em `m_enqueuePos` e só então
+ * escreve na célula; a publicação da sequência (release) torna a malha visível ao consumidor.
+ */
+bool TerrainCompletionQueue::tryPush(chunk::MeshDataPtr& mesh)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = m_cells[pos & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            // A célula está livre nesta volta: tenta reservá-la.
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.mesh = std::move(mesh);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            // Outro produtor reservou a posição; `pos` já foi atualizada pelo compare-exchange.
+        } else if (diff < 0) {
+            // A célula ainda guarda uma malha da volta anterior: a fila está cheia.
+            m_fullRetries.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Retira a malha mais antiga da fila.
+ * @return A malha, ou nulo se a fila estiver vazia.
+ *
+ * Com um único consumidor não há disputa por `m_dequeuePos`; a célula é devolvida
+ * aos produtores da próxima volta ao publicar a sequência pos + capacidade.
+ */
+chunk::MeshDataPtr TerrainCompletionQueue::tryPop()
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Cell& cell = m_cells[pos & m_mask];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) {
+        return nullptr; // O produtor desta posição ainda não publicou a malha.
+    }
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    chunk::MeshDataPtr mesh = std::move(cell.mesh);
+    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    if (m_waitingProducers.load() > 0) {
+        QMutexLocker locker(&m_spaceMutex);
+        m_spaceAvailable.wakeAll();
+    }
+    return mesh;
+}
+
+/**
+ * @brief Espera, sem consumir CPU, até haver espaço na fila.
+ * @param timeoutMs Espera máxima, em milissegundos.
+ *
+ * O worker se registra como esperando antes de conferir de novo a fila sob o mutex: uma
+ * retirada que aconteça entre a conferência e a espera precisa do mesmo mutex para acordá-lo,
+ * então o aviso não se perde. De qualquer forma, a espera termina no tempo limite.
+ */
+void TerrainCompletionQueue::waitForSpace(unsigned long timeoutMs)
+{
+    m_waitingProducers.fetch_add(1);
+    {
+        QMutexLocker locker(&m_spaceMutex);
+        if (approximateSize() >= capacity()) {
+            m_spaceAvailable.wait(&m_spaceMutex, timeoutMs);
+        }
+    }
+    m_waitingProducers.fetch_sub(1);
+}
+
+/**
+ * @brief Retorna o número aproximado de malhas na fila.
+ *
+ * Inclui as posições já reservadas por produtores que ainda estão escrevendo.
+ */
+size_t TerrainCompletionQueue::approximateSize() const
+{
+    size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+    size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+    return (enqueued > dequeued) ? enqueued - dequeued : 0;
+}
+
+/**
+ * @brief Relógio monotônico em microssegundos.
+ */
+qint64 TerrainCompletionQueue::timestampUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
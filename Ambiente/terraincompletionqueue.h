@@ -0,0 +1,122 @@
+#ifndef TERRAINCOMPLETIONQUEUE_H
+#define TERRAINCOMPLETIONQUEUE_H
+
+#include "chunk.h"    // Para chunk::MeshDataPtr, o item transportado pela fila.
+#include <atomic>     // Para os contadores de posição e de sequência sem travas.
+#include <cstddef>    // Para size_t.
+#include <memory>     // Para std::unique_ptr (vetor de células).
+#include <QMutex>         // Protege a espera dos workers por espaço na fila cheia.
+#include <QWaitCondition> // Acorda os workers que esperam espaço quando a thread principal retira malhas.
+
+// Classe: TerrainCompletionQueue
+// Descrição: Fila circular limitada, sem travas, de malhas prontas: várias threads de worker
+//            produzem e apenas a thread principal consome (MPSC). Segue o algoritmo de fila
+//            limitada de Dmitry Vyukov: cada célula tem um número de sequência que indica se
+//            ela está livre para o produtor da volta atual ou pronta para o consumidor.
+//            Substitui um evento Qt (Qt::QueuedConnection) por chunk: o `terrainmanager`
+//            esvazia a fila em um ponto fixo do quadro, com um limite de itens por quadro.
+//            A capacidade é arredondada para a próxima potência de 2.
+class TerrainCompletionQueue {
+public:
+    // Construtor: TerrainCompletionQueue
+    // Descrição: Aloca todas as células de uma vez; nenhuma alocação ocorre depois.
+    // Parâmetros:
+    //   - capacity: Número mínimo de malhas que a fila comporta (arredondado para potência de 2).
+    explicit TerrainCompletionQueue(size_t capacity);
+
+    // Impedir Cópias (Deletadas): as células são compartilhadas com as threads de worker.
+    TerrainCompletionQueue(const TerrainCompletionQueue&) = delete;
+    TerrainCompletionQueue& operator=(const TerrainCompletionQueue&) = delete;
+
+    // Método: tryPush
+    // Descrição: Tenta enfileirar uma malha. Pode ser chamado por várias threads ao mesmo tempo.
+    // Parâmetros:
+    //   - mesh: A malha. Só é movida se a operação tiver sucesso; se a fila estiver cheia,
+    //           continua com quem chamou, para uma nova tentativa.
+    // Retorno: bool - false se a fila estiver cheia.
+    bool tryPush(chunk::MeshDataPtr& mesh);
+
+    // Método: waitForSpace
+    // Descrição: Bloqueia o worker até a thread principal retirar uma malha ou até o tempo limite,
+    //            sem ocupar um núcleo enquanto a fila está cheia. Volta na hora se houver espaço.
+    //            O tempo limite permite a quem chamou verificar se o seu trabalho ficou obsoleto.
+    // Parâmetros:
+    //   - timeoutMs: Espera máxima, em milissegundos.
+    void waitForSpace(unsigned long timeoutMs);
+
+    // Método: tryPop
+    // Descrição: Retira a malha mais antiga da fila. Apenas a thread principal deve chamá-lo.
+    //            Acorda os workers que esperam espaço em `waitForSpace`.
+    // Retorno: chunk::MeshDataPtr - A malha, ou nulo se a fila estiver vazia.
+    chunk::MeshDataPtr tryPop();
+
+    // Método: approximateSize
+    // Descrição: Retorna o número aproximado de malhas na fila (exato se não houver
+    //            produtores ativos no momento da leitura).
+    // Retorno: size_t - Profundidade da fila.
+    size_t approximateSize() const;
+
+    // Método: capacity
+    // Descrição: Retorna a capacidade da fila.
+    // Retorno: size_t - Número de células.
+    size_t capacity() const { return m_mask + 1; }
+
+    // Método: fullRetries
+    // Descrição: Retorna quantas vezes um worker encontrou a fila cheia (diagnóstico).
+    // Retorno: int - Total acumulado de tentativas rejeitadas.
+    int fullRetries() const { return m_fullRetries.load(std::memory_order_relaxed); }
+
+    // Método Estático: timestampUs
+    // Descrição: Relógio monotônico, em microssegundos, usado para medir a latência das malhas
+    //            entre o pedido, a conclusão no worker e o upload.
+    // Retorno: qint64 - Microssegundos desde uma origem arbitrária.
+    static qint64 timestampUs();
+
+private:
+    // Estrutura: Cell
+    // Descrição: Uma posição da fila circular. `sequence` == posição: livre para o produtor;
+    //            `sequence` == posição + 1: contém uma malha pronta para o consumidor.
+    struct Cell {
+        std::atomic<size_t> sequence;
+        chunk::MeshDataPtr mesh;
+    };
+
+    // Membro: m_cells
+    // Tipo: std::unique_ptr<Cell[]>
+    // Descrição: As células da fila, alocadas no construtor.
+    std::unique_ptr<Cell[]> m_cells;
+
+    // Membro: m_mask
+    // Tipo: size_t
+    // Descrição: Capacidade - 1, usada para converter posições em índices de célula.
+    size_t m_mask;
+
+    // Membro: m_enqueuePos
+    // Tipo: std::atomic<size_t>
+    // Descrição: Próxima posição a ser reservada por um produtor. Fica em uma linha de cache
+    //            própria para não disputar com o consumidor.
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+
+    // Membro: m_dequeuePos
+    // Tipo: std::atomic<size_t>
+    // Descrição: Próxima posição a ser lida pelo consumidor.
+    alignas(64) std::atomic<size_t> m_dequeuePos;
+
+    // Membro: m_fullRetries
+    // Tipo: std::atomic<int>
+    // Descrição: Total de tentativas de enfileiramento rejeitadas por fila cheia.
+    std::atomic<int> m_fullRetries;
+
+    // Membro: m_waitingProducers
+    // Tipo: std::atomic<int>
+    // Descrição: Workers bloqueados em `waitForSpace`. Sem nenhum, `tryPop` não toca no mutex.
+    std::atomic<int> m_waitingProducers;
+
+    // Membros: m_spaceMutex / m_spaceAvailable
+    // Tipo: QMutex / QWaitCondition
+    // Descrição: A espera dos workers pela fila cheia (só usados quando ela enche).
+    QMutex m_spaceMutex;
+    QWaitCondition m_spaceAvailable;
+};
+
+#endif // TERRAINCOMPLETIONQUEUE_H
@@ -150,24 +150,23 @@ void TerrainGrid::updateGridGeometry(float currentCameraWorldX, float currentCam
 /**
  * @brief Desenha a grade na tela.
  * @param lineShaderProgram O programa de shader de linha a ser usado.
- * @param viewMatrix A matriz de visão atual da câmera.
- * @param projectionMatrix A matriz de projeção atual da câmera.
+ * @param cameraPosition A posição atual da câmera no mundo.
+ *
+ * A posição vem pronta da câmera (antes era obtida invertendo a matriz de visão a cada quadro);
+ * as matrizes de visão e projeção estão no UBO da cena.
  */
-void TerrainGrid::render(QOpenGLShaderProgram* lineShaderProgram, const QMatrix4x4& viewMatrix, const QMatrix4x4& projectionMatrix) {
+void TerrainGrid::render(QOpenGLShaderProgram* lineShaderProgram, const QVector3D& cameraPosition) {
     if (m_vertexCount == 0 || !m_vao.isCreated()) {
         return;
     }
 
     lineShaderProgram->bind();
-    lineShaderProgram->setUniformValue("projectionMatrix", projectionMatrix);
-    lineShaderProgram->setUniformValue("viewMatrix", viewMatrix);
 
     // Lógica para posicionar a grade dinamicamente com a câmera.
-    QVector3D cameraPos = viewMatrix.inverted() * QVector3D(0,0,0);
     float gridSquareSize = m_config->gridSquareSize;
 
-    float gridOffsetX = qFloor(cameraPos.x() / gridSquareSize) * gridSquareSize;
-    float gridOffsetZ = qFloor(cameraPos.z() / gridSquareSize) * gridSquareSize;
+    float gridOffsetX = qFloor(cameraPosition.x() / gridSquareSize) * gridSquareSize;
+    float gridOffsetZ = qFloor(cameraPosition.z() / gridSquareSize) * gridSquareSize;
 
     QMatrix4x4 modelMatrix;
     modelMatrix.setToIdentity();
@@ -49,9 +49,9 @@ public:
     // Descrição: Desenha a grade na tela usando o shader de linha fornecido.
     // Parâmetros:
     //   - lineShaderProgram: O programa de shader OpenGL a ser usado para renderizar as linhas.
-    //   - viewMatrix: A matriz de visão atual da câmera.
-    //   - projectionMatrix: A matriz de projeção atual da câmera.
-    void render(QOpenGLShaderProgram* lineShaderProgram, const QMatrix4x4& viewMatrix, const QMatrix4x4& projectionMatrix);
+    //   - cameraPosition: A posição atual da câmera no mundo (a grade acompanha a câmera).
+    //   As matrizes de visão e projeção vêm do UBO da cena (bloco SceneBlock do shader de linha).
+    void render(QOpenGLShaderProgram* lineShaderProgram, const QVector3D& cameraPosition);
 
 private:
     // Membro: m_vao
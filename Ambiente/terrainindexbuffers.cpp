@@ -0,0 +1,120 @@
+#include "terrainindexbuffers.h" // Inclui o cabeçalho da classe TerrainIndexBuffers.
+#include <QDebug>                // Para mensagens de depuração (qInfo, qWarning).
+
+/**
+ * @brief Retorna o buffer de índices compartilhado de uma resolução.
+ * @param resolution Número de vértices por lado da malha.
+ * @return O buffer (criado sob demanda), ou nullptr se a resolução for inválida.
+ *
+ * Na primeira chamada para uma resolução, a lista de índices é gerada e enviada
+ * para a GPU com uso estático; as chamadas seguintes apenas retornam o buffer.
+ */
+QOpenGLBuffer* TerrainIndexBuffers::buffer(int resolution)
+{
+    if (resolution <= 1) {
+        return nullptr; // Resolução inválida (mínimo 2x2 para formar triângulos).
+    }
+    if (m_indexType == GL_UNSIGNED_SHORT && resolution > 256) {
+        qWarning() << "Resolucao" << resolution << "excede o limite de indices de 16 bits.";
+        return nullptr;
+    }
+
+    auto it = m_buffers.find(resolution);
+    if (it != m_buffers.end()) {
+        return it->second.get();
+    }
+
+    std::vector<GLuint> indices = buildGridIndices(resolution);
+
+    auto ebo = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::IndexBuffer); // Cria o EBO compartilhado.
+    ebo->create(); // Aloca o EBO na GPU.
+    ebo->setUsagePattern(QOpenGLBuffer::StaticDraw); // Escrito uma vez, lido por todos os chunks.
+    ebo->bind();
+    if (m_indexType == GL_UNSIGNED_SHORT) {
+        // Índices de 16 bits: metade da memória e da banda de leitura dos índices.
+        std::vector<GLushort> shortIndices(indices.begin(), indices.end());
+        ebo->allocate(shortIndices.data(), static_cast<int>(shortIndices.size() * sizeof(GLushort)));
+    } else {
+        ebo->allocate(indices.data(), static_cast<int>(indices.size() * sizeof(GLuint)));
+    }
+    ebo->release();
+
+    qInfo() << "Index buffer compartilhado criado para resolucao" << resolution << "-" << indices.size() << "indices";
+
+    QOpenGLBuffer* result = ebo.get();
+    m_buffers.emplace(resolution, std::move(ebo));
+    return result;
+}
+
+/**
+ * @brief Define o tipo dos índices dos buffers compartilhados.
+ * @param type GL_UNSIGNED_INT ou GL_UNSIGNED_SHORT.
+ *
+ * Os buffers já criados com outro tipo são liberados e recriados na próxima chamada a `buffer`.
+ */
+void TerrainIndexBuffers::setIndexType(GLenum type)
+{
+    if (type == m_indexType) {
+        return;
+    }
+    m_indexType = type;
+    m_buffers.clear();
+}
+
+/**
+ * @brief Retorna o número de índices de uma malha com a resolução informada.
+ * @param resolution Número de vértices por lado da malha.
+ */
+int TerrainIndexBuffers::indexCount(int resolution)
+{
+    if (resolution <= 1) {
+        return 0;
+    }
+    return (resolution - 1) * (resolution - 1) * 6;
+}
+
+/**
+ * @brief Libera todos os buffers compartilhados.
+ *
+ * Os destrutores dos QOpenGLBuffer liberam os recursos da GPU; o contexto deve estar ativo.
+ */
+void TerrainIndexBuffers::clear()
+{
+    m_buffers.clear();
+}
+
+/**
+ * @brief Gera os índices de uma grade resolution x resolution.
+ * @param resolution Número de vértices por lado da malha.
+ * @return Os índices, dois triângulos por quadrado da grade.
+ *
+ * Cada quadrado [r][c] ... [r+1][c+1] é dividido em dois triângulos, com a mesma
+ * ordem de vértices (linha por linha) usada em `chunk::generateMeshData`.
+ */
+std::vector<GLuint> TerrainIndexBuffers::buildGridIndices(int resolution)
+{
+    std::vector<GLuint> indices;
+    if (resolution <= 1) {
+        return indices;
+    }
+    indices.reserve(static_cast<size_t>(indexCount(resolution)));
+
+    for (int r = 0; r < resolution - 1; ++r) {
+        for (int c = 0; c < resolution - 1; ++c) {
+            // Calcula os índices dos 4 vértices que formam o quadrado atual.
+            GLuint topLeft = static_cast<GLuint>(r * resolution + c);
+            GLuint topRight = topLeft + 1;
+            GLuint bottomLeft = static_cast<GLuint>((r + 1) * resolution + c);
+            GLuint bottomRight = bottomLeft + 1;
+            // Primeiro triângulo (superior esquerdo).
+            indices.push_back(topLeft);
+            indices.push_back(bottomLeft);
+            indices.push_back(topRight);
+            // Segundo triângulo (inferior direito).
+            indices.push_back(topRight);
+            indices.push_back(bottomLeft);
+            indices.push_back(bottomRight);
+        }
+    }
+    return indices;
+}
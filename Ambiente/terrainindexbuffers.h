@@ -0,0 +1,78 @@
+#ifndef TERRAININDEXBUFFERS_H
+#define TERRAININDEXBUFFERS_H
+
+#include <QOpenGLBuffer>     // Para o Element Buffer Object (EBO) compartilhado de cada resolução.
+#include <QOpenGLFunctions>  // Para o tipo GLuint.
+#include <map>               // Para associar cada resolução ao seu buffer.
+#include <memory>            // Para std::unique_ptr (gerenciamento dos objetos OpenGL).
+#include <vector>            // Para a lista de índices gerada na CPU.
+
+// Classe: TerrainIndexBuffers
+// Descrição: Conjunto de buffers de índices imutáveis, um por resolução de malha.
+//            Todos os chunks de uma mesma resolução têm a mesma topologia (uma grade
+//            resolution x resolution dividida em triângulos), então a lista de índices é
+//            gerada e enviada para a GPU uma única vez e ligada ao VAO de cada chunk.
+//            Os índices podem ser de 32 bits (GL_UNSIGNED_INT) ou, no formato compacto de
+//            vértice, de 16 bits (GL_UNSIGNED_SHORT, até 256 x 256 vértices).
+//            Deve ser usada apenas na thread que possui o contexto OpenGL.
+class TerrainIndexBuffers {
+public:
+    TerrainIndexBuffers() = default;
+
+    // Método: setIndexType
+    // Descrição: Define o tipo dos índices. Se mudar, os buffers já criados são liberados
+    //            e recriados sob demanda. Requer o contexto OpenGL ativo.
+    // Parâmetros:
+    //   - type: GL_UNSIGNED_INT ou GL_UNSIGNED_SHORT.
+    void setIndexType(GLenum type);
+
+    // Método: indexType
+    // Descrição: Retorna o tipo dos índices, para ser passado a glDrawElements.
+    // Retorno: GLenum - GL_UNSIGNED_INT ou GL_UNSIGNED_SHORT.
+    GLenum indexType() const { return m_indexType; }
+
+    // Impedir Cópias (Deletadas): a classe possui objetos OpenGL.
+    TerrainIndexBuffers(const TerrainIndexBuffers&) = delete;
+    TerrainIndexBuffers& operator=(const TerrainIndexBuffers&) = delete;
+
+    // Método: buffer
+    // Descrição: Retorna o buffer de índices da resolução informada, criando-o e fazendo
+    //            o upload na primeira vez. Requer o contexto OpenGL ativo.
+    // Parâmetros:
+    //   - resolution: Número de vértices por lado da malha.
+    // Retorno: QOpenGLBuffer* - O buffer compartilhado, ou nullptr se a resolução for inválida
+    //          (ou grande demais para índices de 16 bits).
+    QOpenGLBuffer* buffer(int resolution);
+
+    // Método: indexCount
+    // Descrição: Retorna o número de índices de uma malha com a resolução informada.
+    // Parâmetros:
+    //   - resolution: Número de vértices por lado da malha.
+    // Retorno: int - (resolution - 1)² * 6, ou 0 se a resolução for inválida.
+    static int indexCount(int resolution);
+
+    // Método: clear
+    // Descrição: Libera todos os buffers. Requer o contexto OpenGL ativo.
+    void clear();
+
+    // Método Estático: buildGridIndices
+    // Descrição: Gera a lista de índices de uma grade resolution x resolution, com dois
+    //            triângulos por quadrado, na mesma ordem de vértices de `chunk::generateMeshData`.
+    // Parâmetros:
+    //   - resolution: Número de vértices por lado da malha.
+    // Retorno: std::vector<GLuint> - Os índices gerados.
+    static std::vector<GLuint> buildGridIndices(int resolution);
+
+private:
+    // Membro: m_buffers
+    // Tipo: std::map<int, std::unique_ptr<QOpenGLBuffer>>
+    // Descrição: O buffer de índices de cada resolução já usada.
+    std::map<int, std::unique_ptr<QOpenGLBuffer>> m_buffers;
+
+    // Membro: m_indexType
+    // Tipo: GLenum
+    // Descrição: Tipo dos índices de todos os buffers.
+    GLenum m_indexType = GL_UNSIGNED_INT;
+};
+
+#endif // TERRAININDEXBUFFERS_H
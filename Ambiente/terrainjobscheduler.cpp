@@ -0,0 +1,237 @@
+#include "terrainjobscheduler.h" // Inclui o cabeçalho da classe TerrainJobScheduler.
+#include "chunkworker.h"         // Para executar e destruir os workers.
+#include <QRunnable>             // Classe base do Runner submetido ao pool privado.
+#include <QMutexLocker>          // Para travar o mutex com RAII.
+#include <algorithm>             // Para std::push_heap, std::pop_heap, std::make_heap.
+#include <cmath>                 // Para std::sqrt.
+
+/**
+ * @brief Tarefa leve submetida ao pool privado.
+ *
+ * Cada Runner executa exatamente um trabalho: o de maior prioridade no momento
+ * em que ganha uma thread. Se a fila estiver vazia (o trabalho foi cancelado),
+ * termina sem fazer nada.
+ */
+class TerrainJobScheduler::Runner : public QRunnable {
+public:
+    explicit Runner(TerrainJobScheduler* scheduler) : m_scheduler(scheduler) {
+        setAutoDelete(true); // O pool destrói o Runner após a execução.
+    }
+
+    void run() override {
+        ChunkWorker* worker = m_scheduler->takeNext();
+        if (!worker) {
+            return;
+        }
+        worker->run();
+        delete worker; // O agendador é dono do worker.
+    }
+
+private:
+    TerrainJobScheduler* m_scheduler;
+};
+
+/**
+ * @brief Construtor da classe TerrainJobScheduler.
+ * @param workerCount Número máximo de threads de geração de malha.
+ */
+TerrainJobScheduler::TerrainJobScheduler(int workerCount) :
+    m_nextSequence(0),
+    m_cancelledJobs(0),
+    m_acceptingJobs(true)
+{
+    setWorkerCount(workerCount);
+}
+
+/**
+ * @brief Destrutor da classe TerrainJobScheduler.
+ *
+ * Garante que nenhuma thread do pool continue usando o agendador depois de destruído.
+ */
+TerrainJobScheduler::~TerrainJobScheduler()
+{
+    shutdown();
+}
+
+/**
+ * @brief Define o número máximo de threads de geração de malha.
+ * @param workerCount Número de threads (mínimo 1).
+ */
+void TerrainJobScheduler::setWorkerCount(int workerCount)
+{
+    m_pool.setMaxThreadCount(qMax(1, workerCount));
+}
+
+/**
+ * @brief Retorna o número máximo de threads de geração de malha.
+ */
+int TerrainJobScheduler::workerCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+/**
+ * @brief Atualiza o foco das prioridades e reordena a fila.
+ * @param position Posição do trator no mundo.
+ * @param heading Direção de deslocamento no plano XZ.
+ *
+ * Chamado a cada quadro. A fila tem no máximo um trabalho por slot da grade
+ * (algumas centenas), então recalcular todas as prioridades é barato.
+ */
+void TerrainJobScheduler::setFocus(const QVector3D& position, const QVector3D& heading)
+{
+    QMutexLocker locker(&m_mutex);
+    m_focusPosition = position;
+
+    QVector3D flatHeading(heading.x(), 0.0f, heading.z());
+    m_focusHeading = (flatHeading.lengthSquared() > 1e-6f) ? flatHeading.normalized() : QVector3D();
+
+    if (m_queue.empty()) {
+        return;
+    }
+    for (Job& job : m_queue) {
+        job.priority = priorityFor(job.center);
+    }
+    std::make_heap(m_queue.begin(), m_queue.end(), runsLater);
+}
+
+/**
+ * @brief Enfileira um worker, substituindo o trabalho pendente com a mesma chave.
+ * @param key Chave do trabalho (slot da grade).
+ * @param worker O worker a executar (o agendador assume a posse).
+ * @param chunkCenter Centro do chunk no mundo.
+ */
+void TerrainJobScheduler::submit(int key, ChunkWorker* worker, const QVector3D& chunkCenter)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_acceptingJobs) {
+            delete worker;
+            return;
+        }
+
+        // Um pedido mais novo para o mesmo slot torna o anterior obsoleto: substitui no lugar.
+        for (size_t i = 0; i < m_queue.size(); ++i) {
+            if (m_queue[i].key == key) {
+                delete m_queue[i].worker;
+                ++m_cancelledJobs;
+                m_queue[i] = m_queue.back();
+                m_queue.pop_back();
+                std::make_heap(m_queue.begin(), m_queue.end(), runsLater);
+                break;
+            }
+        }
+
+        m_queue.push_back({key, worker, chunkCenter, priorityFor(chunkCenter), m_nextSequence++});
+        std::push_heap(m_queue.begin(), m_queue.end(), runsLater);
+    }
+    // Um Runner por trabalho: ele escolhe o trabalho de maior prioridade ao ganhar uma thread.
+    m_pool.start(new Runner(this));
+}
+
+/**
+ * @brief Retira da fila o trabalho com a chave informada, se ainda não começou.
+ * @param key Chave do trabalho.
+ * @return true se um trabalho foi removido.
+ */
+bool TerrainJobScheduler::cancel(int key)
+{
+    QMutexLocker locker(&m_mutex);
+    for (size_t i = 0; i < m_queue.size(); ++i) {
+        if (m_queue[i].key == key) {
+            delete m_queue[i].worker;
+            ++m_cancelledJobs;
+            m_queue[i] = m_queue.back();
+            m_queue.pop_back();
+            std::make_heap(m_queue.begin(), m_queue.end(), runsLater);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Descarta a fila, recusa novos trabalhos e espera os trabalhos em execução.
+ */
+void TerrainJobScheduler::shutdown()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_acceptingJobs = false;
+        for (Job& job : m_queue) {
+            delete job.worker;
+        }
+        m_cancelledJobs += static_cast<int>(m_queue.size());
+        m_queue.clear();
+    }
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief Retorna quantos trabalhos estão na fila.
+ */
+int TerrainJobScheduler::pendingJobs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_queue.size());
+}
+
+/**
+ * @brief Retorna quantos trabalhos foram descartados antes de começar.
+ */
+int TerrainJobScheduler::cancelledJobs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cancelledJobs;
+}
+
+/**
+ * @brief Retira da fila o trabalho de maior prioridade.
+ * @return O worker a executar, ou nullptr se a fila estiver vazia.
+ */
+ChunkWorker* TerrainJobScheduler::takeNext()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_queue.empty()) {
+        return nullptr;
+    }
+    std::pop_heap(m_queue.begin(), m_queue.end(), runsLater);
+    ChunkWorker* worker = m_queue.back().worker;
+    m_queue.pop_back();
+    return worker;
+}
+
+/**
+ * @brief Calcula a prioridade de um chunk em relação ao foco atual.
+ * @param center Centro do chunk no mundo.
+ * @return Menor valor = mais urgente.
+ *
+ * A base é a distância no plano XZ até o trator. O cosseno do ângulo entre a
+ * direção de deslocamento e a direção até o chunk escala essa distância, de modo
+ * que os chunks à frente do trator sejam gerados antes dos que ficaram para trás.
+ */
+float TerrainJobScheduler::priorityFor(const QVector3D& center) const
+{
+    float dx = center.x() - m_focusPosition.x();
+    float dz = center.z() - m_focusPosition.z();
+    float distance = std::sqrt(dx * dx + dz * dz);
+    if (distance < 1e-3f) {
+        return 0.0f;
+    }
+    float alignment = (dx * m_focusHeading.x() + dz * m_focusHeading.z()) / distance;
+    return distance * (1.0f - HEADING_WEIGHT * alignment);
+}
+
+/**
+ * @brief Comparador do heap: true se `a` deve executar depois de `b`.
+ *
+ * std::push_heap/pop_heap mantêm no topo o maior elemento segundo o comparador;
+ * aqui, "maior" é o de menor prioridade numérica (e, no empate, o mais antigo).
+ */
+bool TerrainJobScheduler::runsLater(const Job& a, const Job& b)
+{
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.sequence > b.sequence;
+}
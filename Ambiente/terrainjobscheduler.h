@@ -0,0 +1,172 @@
+#ifndef TERRAINJOBSCHEDULER_H
+#define TERRAINJOBSCHEDULER_H
+
+#include <QThreadPool>  // Pool de threads privado do terreno (não altera o pool global do processo).
+#include <QMutex>       // Para proteger a fila de prioridade, acessada pela thread principal e pelos workers.
+#include <QVector3D>    // Para a posição e direção do trator usadas no cálculo de prioridade.
+#include <QtGlobal>     // Para quint64.
+#include <vector>       // Armazenamento do heap de trabalhos.
+
+// Declaração antecipada de ChunkWorker
+// Descrição: O agendador apenas guarda e executa os workers; não precisa da definição completa aqui.
+class ChunkWorker;
+
+// Classe: TerrainJobScheduler
+// Descrição: Agendador dedicado dos trabalhos de geração de malha do terreno.
+//            Em vez da fila FIFO do QThreadPool global, mantém uma fila de prioridade
+//            ordenada pela distância do chunk ao trator, com bônus para os chunks à frente
+//            (na direção de deslocamento). As prioridades são recalculadas sempre que o foco
+//            (posição/direção do trator) muda, enquanto os trabalhos ainda estão na fila.
+//            Cada slot da grade tem no máximo um trabalho na fila: um novo pedido para a
+//            mesma chave substitui o anterior. As threads vêm de um QThreadPool próprio,
+//            com número de workers configurável.
+class TerrainJobScheduler {
+public:
+    // Construtor: TerrainJobScheduler
+    // Descrição: Cria o pool privado com o número de threads informado.
+    // Parâmetros:
+    //   - workerCount: Número máximo de threads de geração de malha.
+    explicit TerrainJobScheduler(int workerCount = 3);
+
+    // Destrutor: ~TerrainJobScheduler
+    // Descrição: Descarta os trabalhos na fila e espera os que estão em execução terminarem.
+    ~TerrainJobScheduler();
+
+    // Impedir Cópias (Deletadas): o agendador possui threads e workers.
+    TerrainJobScheduler(const TerrainJobScheduler&) = delete;
+    TerrainJobScheduler& operator=(const TerrainJobScheduler&) = delete;
+
+    // Método: setWorkerCount
+    // Descrição: Define o número máximo de threads de geração de malha.
+    // Parâmetros:
+    //   - workerCount: Número de threads (mínimo 1).
+    void setWorkerCount(int workerCount);
+
+    // Método: workerCount
+    // Descrição: Retorna o número máximo de threads de geração de malha.
+    // Retorno: int - O número de threads.
+    int workerCount() const;
+
+    // Método: setFocus
+    // Descrição: Atualiza o ponto de referência das prioridades (a posição do trator e sua
+    //            direção de deslocamento) e reordena a fila com as novas prioridades.
+    // Parâmetros:
+    //   - position: Posição do trator no mundo.
+    //   - heading: Direção de deslocamento no plano XZ (não precisa estar normalizada;
+    //              um vetor nulo desativa o bônus de direção).
+    void setFocus(const QVector3D& position, const QVector3D& heading);
+
+    // Método: submit
+    // Descrição: Enfileira um worker. O agendador assume a posse do worker e o destrói
+    //            após a execução ou o cancelamento. Se já houver um trabalho na fila com a
+    //            mesma chave, ele é descartado e substituído.
+    // Parâmetros:
+    //   - key: Chave do trabalho (o slot da grade de chunks).
+    //   - worker: O worker a executar.
+    //   - chunkCenter: Centro do chunk no mundo, usado no cálculo de prioridade.
+    void submit(int key, ChunkWorker* worker, const QVector3D& chunkCenter);
+
+    // Método: cancel
+    // Descrição: Retira da fila e destrói o trabalho com a chave informada, se ele ainda não começou.
+    // Parâmetros:
+    //   - key: Chave do trabalho.
+    // Retorno: bool - true se um trabalho foi removido.
+    bool cancel(int key);
+
+    // Método: shutdown
+    // Descrição: Descarta todos os trabalhos na fila, recusa novos e espera os trabalhos
+    //            em execução terminarem.
+    void shutdown();
+
+    // Método: pendingJobs
+    // Descrição: Retorna quantos trabalhos estão na fila esperando uma thread.
+    // Retorno: int - Tamanho da fila.
+    int pendingJobs() const;
+
+    // Método: cancelledJobs
+    // Descrição: Retorna quantos trabalhos foram descartados da fila antes de começar (diagnóstico).
+    // Retorno: int - Total acumulado de cancelamentos.
+    int cancelledJobs() const;
+
+private:
+    // Estrutura: Job
+    // Descrição: Um trabalho na fila de prioridade.
+    struct Job {
+        int key;                // Chave (slot da grade).
+        ChunkWorker* worker;    // O worker a executar (posse do agendador).
+        QVector3D center;       // Centro do chunk no mundo.
+        float priority;         // Menor valor = executa antes.
+        quint64 sequence;       // Ordem de chegada, para desempate (FIFO entre prioridades iguais).
+    };
+
+    // Classe: Runner
+    // Descrição: QRunnable leve submetido ao pool privado, um por trabalho enfileirado.
+    //            Ao ganhar uma thread, retira da fila o trabalho de maior prioridade
+    //            naquele momento (não o que existia quando o Runner foi criado).
+    class Runner;
+
+    // Método Privado: takeNext
+    // Descrição: Retira da fila o trabalho de maior prioridade. Chamado pelas threads do pool.
+    // Retorno: ChunkWorker* - O worker a executar, ou nullptr se a fila estiver vazia.
+    ChunkWorker* takeNext();
+
+    // Método Privado: priorityFor
+    // Descrição: Calcula a prioridade de um chunk em relação ao foco atual (m_mutex deve estar travado).
+    // Parâmetros:
+    //   - center: Centro do chunk no mundo.
+    // Retorno: float - Distância no plano XZ, reduzida para chunks à frente e aumentada para os de trás.
+    float priorityFor(const QVector3D& center) const;
+
+    // Método Privado Estático: runsLater
+    // Descrição: Comparador do heap: true se `a` deve executar depois de `b`.
+    static bool runsLater(const Job& a, const Job& b);
+
+    // Membro: m_mutex
+    // Tipo: QMutex
+    // Descrição: Protege a fila e o foco, acessados pela thread principal e pelas threads do pool.
+    mutable QMutex m_mutex;
+
+    // Membro: m_queue
+    // Tipo: std::vector<Job>
+    // Descrição: Os trabalhos pendentes, organizados como heap (std::push_heap/std::pop_heap).
+    std::vector<Job> m_queue;
+
+    // Membro: m_focusPosition
+    // Tipo: QVector3D
+    // Descrição: Posição do trator usada no cálculo de prioridade.
+    QVector3D m_focusPosition;
+
+    // Membro: m_focusHeading
+    // Tipo: QVector3D
+    // Descrição: Direção de deslocamento normalizada no plano XZ (ou nula).
+    QVector3D m_focusHeading;
+
+    // Membro: m_nextSequence
+    // Tipo: quint64
+    // Descrição: Contador de chegada dos trabalhos.
+    quint64 m_nextSequence;
+
+    // Membro: m_cancelledJobs
+    // Tipo: int
+    // Descrição: Total de trabalhos descartados antes de começar.
+    int m_cancelledJobs;
+
+    // Membro: m_acceptingJobs
+    // Tipo: bool
+    // Descrição: false depois de `shutdown()`; novos trabalhos são descartados.
+    bool m_acceptingJobs;
+
+    // Membro: m_pool
+    // Tipo: QThreadPool
+    // Descrição: Pool de threads privado do terreno.
+    QThreadPool m_pool;
+
+    // Membro: HEADING_WEIGHT
+    // Tipo: const float
+    // Descrição: Quanto a direção de deslocamento pesa na prioridade. Com 0.5, um chunk
+    //            bem à frente conta como se estivesse à metade da distância, e um bem
+    //            atrás como se estivesse a 1.5x a distância.
+    const float HEADING_WEIGHT = 0.5f;
+};
+
+#endif // TERRAINJOBSCHEDULER_H
@@ -2,37 +2,69 @@
 #include "chunkworker.h"    // Inclui o cabeçalho da classe ChunkWorker.
 #include <QDebug>           // Para mensagens de depuração.
 #include <cmath>            // Para funções matemáticas como std::floor.
-#include <QThreadPool>      // Para gerenciar um pool de threads para tarefas em segundo plano.
+#include <algorithm>        // Para std::min, std::max, std::clamp, std::sort, std::unique.
+#include <QElapsedTimer>    // Para medir o tempo gasto com uploads no quadro.
+#include <QStringList>      // Para listar as resoluções dos níveis de LOD no log.
 #include "worldconfig.h"    // Inclui a estrutura WorldConfig para parâmetros do mundo.
+#include "noiseutils.h"     // Para configurar o motor de alturas e registrar o kernel SIMD escolhido.
 
 /**
  * @brief Construtor da classe terrainmanager.
  *
- * Inicializa os membros da classe e configura o número máximo de threads
- * que o QThreadPool global pode usar para gerar chunks, deixando um núcleo
- * livre para a thread principal e o sistema operacional.
+ * Inicializa os membros da classe. O número de threads de geração de chunks
+ * é configurado em `init`, no pool privado do agendador.
  */
 terrainmanager::terrainmanager() :
     QObject(nullptr), // Chama o construtor da classe base QObject.
     m_centerChunkX(0), // Inicializa a coordenada X do chunk central da grade.
     m_centerChunkZ(0), // Inicializa a coordenada Z do chunk central da grade.
+    m_activeHalfGrid(0), // Definido em `init` (a grade inteira).
+    m_lodDistanceScale(1.0f), // Faixas de LOD da configuração.
+    m_regeneratedChunks(0), // Nenhum chunk regenerado por mudança de altura ainda.
+    m_trianglesLastFrame(0), // Nada desenhado ainda.
+    m_lodSwitches(0), // Nenhuma troca de LOD ainda.
+    m_chunksDrawnLastFrame(0), // Nenhum chunk desenhado ainda.
+    m_chunksCulledLastFrame(0),
+    m_drawCallsLastFrame(0),
+    m_drawOrderBenchmarkFrame(0), // Nenhum quadro medido ainda.
+    m_drawOrderBenchmarkNs{0, 0},
+    m_drawOrderBenchmarkSamples{0, 0},
+    m_lodBenchmarkFrame(0), // Nenhum quadro medido ainda.
+    m_lodBenchmarkTriangles(0),
+    m_lodBenchmarkSwaps(0),
+    m_lodBenchmarkPops(0),
+    m_lodBenchmarkWorstGap(0.0f),
+    m_deferredLodChunks(0),
+    m_queuedUploadBytes(0), // Fila de uploads vazia.
+    m_framesOverBudget(0), // Nenhum quadro acima do orçamento ainda.
+    m_deferredUploadFrames(0), // Nenhum upload adiado ainda.
+    m_completionQueueDepth(0), // Fila de conclusão vazia.
+    m_maxCompletionQueueDepth(0),
+    m_avgRequestToReadyMs(0.0f), // Sem amostras de latência ainda.
+    m_avgReadyToUploadMs(0.0f),
     m_glFuncsRef(nullptr) // Inicializa a referência para as funções OpenGL.
 {
-    // Definimos o número máximo de threads que queremos usar para gerar chunks.
-    // A recomendação é deixar 1 núcleo livre para a thread principal e o sistema operacional.
-    QThreadPool::globalInstance()->setMaxThreadCount(3);
 }
 
 /**
  * @brief Destrutor da classe terrainmanager.
  *
- * Garante que todos os trabalhos de geração de chunk submetidos ao QThreadPool
- * sejam concluídos antes que o gerenciador de terreno seja destruído.
+ * Descarta os trabalhos ainda na fila e espera os que estão em execução terminarem,
+ * para que nenhum worker envie resultados para um gerenciador já destruído.
+ * Antes, todos os tokens de geração avançam: um worker esperando espaço na fila de
+ * conclusão (que ninguém mais esvazia) percebe que é obsoleto e termina.
  */
 terrainmanager::~terrainmanager()
 {
-    // Espera todos os trabalhos na piscina terminarem antes de fechar.
-    QThreadPool::globalInstance()->waitForDone();
+    for (auto& row : m_chunks) {
+        for (chunk& c : row) {
+            c.advanceGeneration();
+        }
+    }
+    m_scheduler.shutdown();
+    if (m_demSource || m_gnssSource) {
+        NoiseUtils::setHeightSource(nullptr); // Nenhum worker consulta mais a fonte de alturas.
+    }
 }
 
 /**
@@ -49,13 +81,94 @@ terrainmanager::~terrainmanager()
  */
 void terrainmanager::init(const WorldConfig* config, QOpenGLShaderProgram* terrainShaderProgram, QOpenGLFunctions *glFuncs) {
     m_config = config; // Armazena o ponteiro para a configuração do mundo.
+    m_activeHalfGrid = m_config->gridRenderSize / 2; // Toda a grade começa ativa.
     m_glFuncsRef = glFuncs; // Armazena a referência para as funções OpenGL.
 
+    // Define o número de threads de geração de chunks no pool privado do agendador.
+    // A recomendação é deixar 1 núcleo livre para a thread principal e o sistema operacional.
+    m_scheduler.setWorkerCount(m_config->terrainWorkerThreads);
+
+    // A fila de conclusão precisa existir antes do primeiro pedido de malha (recenterGrid abaixo).
+    m_completions = std::make_unique<TerrainCompletionQueue>(static_cast<size_t>(m_config->completionQueueCapacity));
+    m_meshCache.setBudgetBytes(m_config->meshCacheBudgetBytes);
+    // Configura o motor de alturas antes do primeiro pedido de malha (os workers só leem esse estado).
+    NoiseUtils::NoiseParams noise;
+    noise.seed = m_config->terrainNoiseSeed;
+    noise.octaves = m_config->terrainNoiseOctaves;
+    noise.frequency = m_config->terrainNoiseFrequency;
+    noise.amplitude = m_config->terrainNoiseAmplitude;
+    noise.lacunarity = m_config->terrainNoiseLacunarity;
+    noise.gain = m_config->terrainNoiseGain;
+    NoiseUtils::configure(noise);
+    if (m_config->terrainDemPath && m_config->terrainDemPath[0] != '\0') {
+        auto dem = std::make_unique<DemHeightSource>();
+        QString error;
+        if (dem->open(QString::fromUtf8(m_config->terrainDemPath), &error)) {
+            m_demSource = std::move(dem);
+            NoiseUtils::setHeightSource(m_demSource.get());
+        } else {
+            qWarning() << "DEM do terreno indisponivel, usando o ruido procedural:" << error;
+        }
+    }
+    if (!m_demSource && m_config->gnssTerrainEnabled) {
+        m_gnssSource = std::make_unique<GnssHeightSource>(m_config->gnssTerrainCellSize, m_config->gnssTerrainSplatRadius,
+                                                          static_cast<float>(m_config->chunkSize),
+                                                          m_config->gnssTerrainDirtyThreshold);
+        NoiseUtils::setHeightSource(m_gnssSource.get());
+    }
+    qInfo() << "Kernel de alturas em lote do terreno:" << NoiseUtils::simdLevelName(NoiseUtils::activeSimdLevel())
+            << "- oitavas:" << (noise.amplitude != 0.0f ? noise.octaves : 0);
+
+    // Cria os buffers de índices compartilhados das duas resoluções (init roda com o contexto ativo).
+    // O formato compacto de vértice usa índices de 16 bits.
+    m_indexBuffers.setIndexType(m_config->compactTerrainVertices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+    buildLodLevels();
+    for (int resolution : m_lodResolutions) {
+        m_indexBuffers.buffer(resolution);
+    }
+
+    // Pré-aloca os VBOs (ou, no desenho em lote, os slots das páginas) para que os primeiros
+    // uploads e as trocas de LOD não criem objetos OpenGL no meio do quadro. A quantidade de
+    // cada nível é a dos chunks cujo centro cai na faixa do nível (com a histerese) com a
+    // câmera no centro da grade.
+    m_batchBuffers.setVertexFormat(m_config->compactTerrainVertices);
+    if (!m_config->heightTextureTerrain) {
+        const int vertexStride = m_config->compactTerrainVertices ? static_cast<int>(sizeof(CompactVertex))
+                                                                  : static_cast<int>(sizeof(Vertex));
+        const int halfGrid = m_config->gridRenderSize / 2;
+        for (int level = 0; level < lodLevelCount(); ++level) {
+            const float nearest = (level == 0) ? 0.0f : lodRange(level - 1) * (1.0f - LOD_HYSTERESIS_FRACTION);
+            const float farthest = lodRange(level) * (1.0f + LOD_HYSTERESIS_FRACTION);
+            int chunksInLevel = 0;
+            for (int i = -halfGrid; i <= halfGrid; ++i) {
+                for (int j = -halfGrid; j <= halfGrid; ++j) {
+                    const float distance = std::hypot(static_cast<float>(i), static_cast<float>(j)) * m_config->chunkSize;
+                    if (distance >= nearest && distance <= farthest) {
+                        ++chunksInLevel;
+                    }
+                }
+            }
+            const int resolution = m_lodResolutions[level];
+            if (batchedDraws()) {
+                m_batchBuffers.reserve(resolution, chunksInLevel, glFuncs);
+            } else {
+                m_bufferPool.preallocate(resolution * resolution * vertexStride, chunksInLevel);
+            }
+        }
+        if (batchedDraws()) {
+            qInfo() << "Desenho do terreno em lote:" << m_batchBuffers.pageCount() << "paginas,"
+                    << (m_batchBuffers.allocatedBytes() / 1024) << "KB";
+        } else {
+            qInfo() << "Pool de VBOs do terreno pre-alocado:" << m_bufferPool.createdBuffers() << "buffers";
+        }
+    }
+
     // Redimensiona a matriz de vetores para o tamanho da grade de renderização definida em m_config.
     m_chunks.resize(m_config->gridRenderSize);
     for (int i = 0; i < m_config->gridRenderSize; ++i) {
         m_chunks[i].resize(m_config->gridRenderSize);
     }
+    m_lodSwapPending.assign(static_cast<size_t>(m_config->gridRenderSize) * m_config->gridRenderSize, 0);
     // Inicia a grade de chunks centrada em (0, 0).
     recenterGrid(0, 0);
 }
@@ -63,12 +176,22 @@ void terrainmanager::init(const WorldConfig* config, QOpenGLShaderProgram* terra
 /**
  * @brief Atualiza o estado do terreno com base na posição da câmera.
  * @param cameraPos A posição atual da câmera no espaço do mundo.
+ * @param viewProjection A matriz projeção * visão da câmera.
  *
- * Esta função verifica se o centro da grade de chunks precisa ser atualizado (lógica de terreno infinito)
+ * Primeiro recebe as malhas prontas da fila de conclusão, em um ponto fixo do quadro.
+ * Depois verifica se o centro da grade de chunks precisa ser atualizado (lógica de terreno infinito)
  * e também ajusta o Nível de Detalhe (LOD) dos chunks com base na distância da câmera,
  * disparando novos trabalhos de geração de malha se o LOD de um chunk precisar mudar.
+ * A troca de LOD de um chunk fora da tela (com a margem de um chunk, para que ele já esteja
+ * pronto quando a câmera girar) fica para um `update` em que ele esteja visível.
  */
-void terrainmanager::update(const QVector3D& cameraPos) {
+void terrainmanager::update(const QVector3D& cameraPos, const QMatrix4x4& viewProjection) {
+    m_lastCameraPos = cameraPos; // Usada para ordenar a fila de uploads.
+    m_frustum.update(viewProjection); // Volume de visão deste quadro (culling do update e do render).
+
+    drainCompletions();
+    regenerateDirtyChunks();
+
     // Verifica se o centro da grade precisa mudar (lógica de terreno infinito):
     // Calcula em qual chunk a câmera está localizada no momento.
     int cameraChunkX = static_cast<int>(std::floor(cameraPos.x() / m_config->chunkSize));
@@ -79,40 +202,125 @@ void terrainmanager::update(const QVector3D& cameraPos) {
         recenterGrid(cameraChunkX, cameraChunkZ);
     }
 
-    // Atualiza o nível de detalhe (LOD) dos chunks existentes:
+    // Atualiza o nível de detalhe (LOD) dos chunks existentes.
+    // Cada nível cobre uma faixa de distância com o dobro da largura da anterior; a histerese
+    // (proporcional à faixa) evita que um chunk fique alternando entre dois níveis no limite.
+    const int coarsestLevel = lodLevelCount() - 1;
+    const float lodCullMargin = static_cast<float>(m_config->chunkSize);
+    m_deferredLodChunks = 0;
     for (int i = 0; i < m_config->gridRenderSize; ++i) {
         for (int j = 0; j < m_config->gridRenderSize; ++j){
             chunk& currentChunk = m_chunks[i][j]; // Obtém uma referência para o chunk atual.
-            int currentLOD = currentChunk.getLOD(); // Obtém o LOD atual do chunk.
-            int desiredLOD = currentLOD; // Inicializa o LOD desejado com o LOD atual.
+            const int currentLOD = currentChunk.getLOD(); // Obtém o LOD atual do chunk.
+            if (currentLOD < 0 || !isChunkInActiveArea(currentChunk)) {
+                continue; // Fora da área ativa, o chunk fica no nível em que está.
+            }
 
             // Calcula a distância da câmera até o centro do chunk.
             float distanceToChunk = cameraPos.distanceToPoint(currentChunk.getCenterPosition(m_config->chunkSize));
 
-            // Lógica de histerese para transição de LOD:
-            // Isso evita que os chunks fiquem "pipocando" entre LODs quando a câmera está exatamente no limiar.
-            if (currentLOD == 1 && distanceToChunk < m_config->lodDistanceThreshold - LOD_HYSTERESIS_BUFFER) {
-                // Se o chunk está em baixa resolução (LOD 1), ele só muda para alta resolução (LOD 0)
-                // se entrar bem na zona de alta resolução (distância menor que o limiar menos o buffer).
-                desiredLOD = 0;
-            } else if (currentLOD == 0 && distanceToChunk > m_config->lodDistanceThreshold + LOD_HYSTERESIS_BUFFER) {
-                // Se o chunk está em alta resolução (LOD 0), ele só muda para baixa resolução (LOD 1)
-                // se sair bem da zona de alta resolução (distância maior que o limiar mais o buffer).
-                desiredLOD = 1;
+            // Aproxima (nível mais fino) enquanto estiver bem dentro da faixa do nível anterior,
+            // ou afasta (nível mais grosso) enquanto estiver bem além do fim da faixa atual.
+            int desiredLOD = currentLOD;
+            while (desiredLOD > 0 && distanceToChunk < lodRange(desiredLOD - 1) * (1.0f - LOD_HYSTERESIS_FRACTION)) {
+                --desiredLOD;
+            }
+            while (desiredLOD < coarsestLevel && distanceToChunk > lodRange(desiredLOD) * (1.0f + LOD_HYSTERESIS_FRACTION)) {
+                ++desiredLOD;
             }
 
             // Se o LOD desejado for diferente do LOD atual, atualiza o chunk e dispara um novo trabalho de geração de malha.
             if (currentLOD != desiredLOD) {
+                // Fora da tela, a malha atual continua valendo até o chunk ficar visível.
+                if (!isChunkVisible(currentChunk, lodCullMargin)) {
+                    ++m_deferredLodChunks;
+                    continue;
+                }
                 currentChunk.setLOD(desiredLOD); // Define o novo LOD para o chunk.
-                // Define a nova resolução com base no LOD desejado.
-                int newRes = (desiredLOD == 0) ? m_config->highRes : m_config->lowRes;
-                // Cria um novo trabalho (QRunnable) para gerar a malha em uma thread separada.
-                ChunkWorker* worker = new ChunkWorker(currentChunk.chunkGridX(), currentChunk.chunkGridZ(), newRes, m_config, this);
-                // Submete o trabalho à piscina de threads. O Qt cuida do resto (execução em background).
-                QThreadPool::globalInstance()->start(worker);
+                // Pede a nova malha; um trabalho anterior deste chunk ainda na fila é descartado.
+                requestMesh(i, j, m_lodResolutions[desiredLOD]);
+                m_lodSwapPending[static_cast<size_t>(i) * m_config->gridRenderSize + j] = 1;
+                ++m_lodSwitches;
             }
         }
     }
+    reportStats();
+}
+
+/**
+ * @brief Informa a posição e a direção de deslocamento do trator ao agendador.
+ * @param tractorPos Posição do trator no mundo.
+ * @param tractorHeading Direção "para frente" do trator.
+ *
+ * Os trabalhos ainda na fila são repriorizados imediatamente.
+ */
+void terrainmanager::setFocus(const QVector3D& tractorPos, const QVector3D& tractorHeading) {
+    m_scheduler.setFocus(tractorPos, tractorHeading);
+}
+
+/**
+ * @brief Entrega uma altitude do GNSS ao modelo de elevação.
+ * @param worldX Coordenada X do mundo da antena.
+ * @param worldZ Coordenada Z do mundo da antena.
+ * @param altitude Altitude medida, em metros.
+ * @param verticalSigma Desvio padrão vertical, em metros.
+ */
+void terrainmanager::addElevationSample(float worldX, float worldZ, double altitude, float verticalSigma) {
+    if (m_gnssSource) {
+        m_gnssSource->addSample(worldX, worldZ, altitude, verticalSigma);
+    }
+}
+
+/**
+ * @brief Posiciona o DEM no mundo e regenera o terreno já gerado.
+ * @param worldX Coordenada X do mundo do centro da célula noroeste do DEM.
+ * @param worldZ Coordenada Z do mundo do centro da célula noroeste do DEM.
+ *
+ * As malhas do cache e as que estão na fila ou nos workers foram geradas com a posição
+ * anterior: o cache é esvaziado e o novo pedido de cada chunk torna as demais obsoletas.
+ */
+void terrainmanager::setDemWorldOrigin(double worldX, double worldZ) {
+    if (!m_demSource) {
+        return;
+    }
+    m_demSource->setWorldOrigin(worldX, worldZ);
+    m_meshCache.clear();
+    for (int i = 0; i < m_config->gridRenderSize; ++i) {
+        for (int j = 0; j < m_config->gridRenderSize; ++j) {
+            const chunk& target = m_chunks[i][j];
+            if (target.getLOD() != -1) {
+                requestMeshIfActive(i, j, m_lodResolutions[target.getLOD()]);
+            }
+        }
+    }
+    qInfo() << "DEM posicionado no mundo: celula noroeste em" << worldX << "," << worldZ;
+}
+
+/**
+ * @brief Regenera os chunks cuja altura mudou no modelo do GNSS.
+ *
+ * Cada chunk afetado perde as malhas guardadas no cache (em todas as resoluções). Os que
+ * estão na grade recebem um novo pedido de malha no seu LOD atual; a malha antiga continua
+ * visível até a nova chegar, e um trabalho anterior ainda na fila passa a ser obsoleto.
+ */
+void terrainmanager::regenerateDirtyChunks() {
+    if (!m_gnssSource) {
+        return;
+    }
+    m_gnssSource->takeDirtyChunks(m_dirtyChunks);
+    for (const auto& dirty : m_dirtyChunks) {
+        m_meshCache.invalidate(dirty.first, dirty.second);
+
+        const int slotX = gridSlot(dirty.first);
+        const int slotZ = gridSlot(dirty.second);
+        const chunk& target = m_chunks[slotX][slotZ];
+        if (target.getLOD() == -1 || target.chunkGridX() != dirty.first || target.chunkGridZ() != dirty.second) {
+            continue; // Fora da grade: será gerado com as alturas novas quando entrar.
+        }
+        if (requestMeshIfActive(slotX, slotZ, m_lodResolutions[target.getLOD()])) {
+            ++m_regeneratedChunks;
+        }
+    }
 }
 
 /**
@@ -121,32 +329,281 @@ void terrainmanager::update(const QVector3D& cameraPos) {
  * @param newCenterZ A nova coordenada Z do chunk central da grade.
  *
  * Esta função é chamada quando a câmera se move para um novo chunk "central".
- * Ela reutiliza os objetos `chunk` existentes, atribuindo-lhes novas coordenadas
- * de grade e disparando a geração de novas malhas para essas posições.
+ * A matriz `m_chunks` é um anel toroidal: cada coordenada de chunk tem um slot fixo.
+ * Ao mover a janela visível, apenas os slots cuja coordenada saiu da janela (a nova
+ * borda de avanço) são reciclados e recebem um trabalho de geração de malha.
+ * Os chunks que continuam visíveis mantêm sua malha, seu LOD e seus buffers de GPU.
  */
 void terrainmanager::recenterGrid(int newCenterX, int newCenterZ){
-    qInfo() << "Recentering grid to:" << newCenterX << "," << newCenterZ;
     m_centerChunkX = newCenterX; // Atualiza a coordenada X do centro da grade.
     m_centerChunkZ = newCenterZ; // Atualiza a coordenada Z do centro da grade.
 
     int halfGrid = m_config->gridRenderSize / 2; // Calcula a metade do tamanho da grade.
+    int recycledCount = 0; // Quantos chunks precisaram ser reciclados neste recentramento.
 
-    // Itera sobre todas as posições na grade de chunks.
+    // Itera sobre todas as coordenadas da nova janela visível.
     for (int i = 0; i < m_config->gridRenderSize; ++i) {
         for (int j = 0; j < m_config->gridRenderSize; ++j) {
             // Calcula as coordenadas X e Z do chunk no mundo com base no novo centro.
             int chunkX = m_centerChunkX - halfGrid + i;
             int chunkZ = m_centerChunkZ - halfGrid + j;
-            // Recicla o chunk na posição [i][j] da nossa matriz para a nova coordenada.
-            m_chunks[i][j].recycle(chunkX, chunkZ, m_config->chunkSize);
+            chunk& slotChunk = m_chunks[gridSlot(chunkX)][gridSlot(chunkZ)];
+
+            // Se o slot já contém esta coordenada, o chunk continua válido e não é tocado.
+            // LOD -1 indica um chunk sem malha válida (nunca inicializado, ou fora da área ativa).
+            const bool sameCoordinate = slotChunk.chunkGridX() == chunkX && slotChunk.chunkGridZ() == chunkZ;
+            if (sameCoordinate && (slotChunk.getLOD() != -1 || !isChunkInActiveArea(slotChunk))) {
+                continue;
+            }
+
+            // Recicla o chunk deste slot para a nova coordenada.
+            slotChunk.recycle(chunkX, chunkZ, m_config->chunkSize, batchedDraws() ? &m_batchBuffers : nullptr);
+            m_lodSwapPending[static_cast<size_t>(gridSlot(chunkX)) * m_config->gridRenderSize + gridSlot(chunkZ)] = 0;
 
             // Dispara um trabalho de geração de malha em segundo plano para este chunk.
-            // A lógica de LOD inicializa todos os chunks com baixa resolução ao recentrar.
-            m_chunks[i][j].setLOD(1); // Define o LOD inicial como baixa resolução.
-            ChunkWorker* worker = new ChunkWorker(chunkX, chunkZ, m_config->lowRes, m_config, this);
-            QThreadPool::globalInstance()->start(worker); // Submete o trabalho ao pool de threads.
+            // Os chunks reciclados começam no nível mais grosso; `update` os refina pela distância.
+            // Fora da área ativa, a malha fica para quando a área crescer.
+            slotChunk.setLOD(lodLevelCount() - 1);
+            if (requestMeshIfActive(gridSlot(chunkX), gridSlot(chunkZ), m_lodResolutions.back())) {
+                ++recycledCount;
+            }
+        }
+    }
+    // Os tiles do DEM fora da nova janela são devolvidos ao sistema (os pedidos acima
+    // ainda não rodaram, então os tiles que eles vão ler são relidos sob demanda).
+    if (m_demSource) {
+        m_demSource->trim(m_config->terrainDemMaxResidentTiles);
+    }
+    qInfo() << "Recentering grid to:" << newCenterX << "," << newCenterZ << "- chunks reciclados:" << recycledCount;
+}
+
+/**
+ * @brief Registra a cada 5 segundos as métricas do terreno.
+ *
+ * Uma linha por assunto (geração, uploads, cache e fontes de altura, desenho), para que o log
+ * do recentramento fique só com o recentramento. Os contadores são acumulados desde o início.
+ */
+void terrainmanager::reportStats() {
+    if (!m_statsTimer.isValid()) {
+        m_statsTimer.start();
+        return;
+    }
+    if (m_statsTimer.elapsed() < STATS_REPORT_INTERVAL_MS) {
+        return;
+    }
+    m_statsTimer.restart();
+
+    qInfo() << "Terreno - geracao: na fila:" << m_scheduler.pendingJobs()
+            << "- obsoletos cancelados:" << m_scheduler.cancelledJobs()
+            << "- fila de conclusao:" << m_completionQueueDepth << "(max" << m_maxCompletionQueueDepth << ")"
+            << "- latencia pedido->pronta ms:" << m_avgRequestToReadyMs;
+    qInfo() << "Terreno - uploads: bytes na fila:" << m_queuedUploadBytes
+            << "- quadros acima do orcamento:" << m_framesOverBudget
+            << "- quadros com uploads adiados:" << m_deferredUploadFrames
+            << "- pronta->upload ms:" << m_avgReadyToUploadMs;
+    qInfo() << "Terreno - cache de malhas (acertos/falhas/descartes/KB):" << m_meshCache.hits() << "/" << m_meshCache.misses()
+            << "/" << m_meshCache.evictions() << "/" << (m_meshCache.bytes() / 1024);
+    if (m_demSource) {
+        qInfo() << "Terreno - tiles do DEM (residentes/devolvidos):" << m_demSource->residentTiles()
+                << "/" << m_demSource->evictedTiles();
+    }
+    if (m_gnssSource) {
+        qInfo() << "Terreno - altitudes GNSS (amostras/rejeitadas/blocos):" << m_gnssSource->samples()
+                << "/" << m_gnssSource->rejectedSamples() << "/" << m_gnssSource->blocks()
+                << "- chunks regenerados por altura:" << m_regeneratedChunks;
+    }
+    qInfo() << "Terreno - desenho: triangulos no quadro:" << m_trianglesLastFrame
+            << "- chunks desenhados/descartados:" << m_chunksDrawnLastFrame << "/" << m_chunksCulledLastFrame
+            << "- chamadas de desenho:" << m_drawCallsLastFrame
+            << "- trocas de LOD:" << m_lodSwitches
+            << "- LOD adiado (fora da tela):" << m_deferredLodChunks;
+}
+
+/**
+ * @brief Monta os níveis de LOD e as faixas de morphing.
+ *
+ * Os níveis vão de `highRes` a `lowRes` e daí, pela metade, até `coarsestRes`. A faixa do
+ * nível k termina em lodDistanceThreshold * 2^k (o último nível vai até o infinito).
+ *
+ * Faixa de morphing do nível k (CDLOD): o morphing tem de terminar antes de o chunk passar
+ * para o nível k + 1 (a malha totalmente deformada é igual à do nível seguinte) e não pode
+ * ter começado quando o chunk acabou de chegar do nível k - 1. A troca usa a distância até
+ * o centro do chunk e o morphing a distância até cada vértice; a diferença entre as duas é
+ * coberta por uma margem de 3/4 do lado do chunk (mais que a meia diagonal).
+ */
+void terrainmanager::buildLodLevels() {
+    m_lodResolutions.clear();
+    m_morphRanges.clear();
+    m_morphRatios.clear();
+    for (int resolution = m_config->highRes; resolution > 1; resolution = chunk::nextLodResolution(resolution, *m_config)) {
+        m_lodResolutions.push_back(resolution);
+    }
+    for (size_t level = 0; level < m_lodResolutions.size(); ++level) {
+        const bool last = (level + 1 == m_lodResolutions.size());
+        m_morphRatios.push_back(last ? 1 : (m_lodResolutions[level] - 1) / (m_lodResolutions[level + 1] - 1));
+    }
+
+    const float margin = 0.75f * static_cast<float>(m_config->chunkSize);
+    const int levels = lodLevelCount();
+    bool snapping = false;
+    for (int level = 0; level < levels; ++level) {
+        if (level == levels - 1) {
+            m_morphRanges.append(QVector2D(1.0e9f, 0.0f)); // Último nível: nada para onde deformar.
+            continue;
+        }
+        const float previousRange = (level == 0) ? 0.0f : lodRange(level - 1);
+        const float end = lodRange(level) * (1.0f - LOD_HYSTERESIS_FRACTION) - margin;
+        const float earliest = (level == 0) ? 0.0f : previousRange * (1.0f + LOD_HYSTERESIS_FRACTION) + margin;
+        float start = std::max(earliest, end - m_config->lodMorphFraction * (lodRange(level) - previousRange));
+        if (start >= end - 0.01f) {
+            start = end - 0.01f; // Faixas curtas demais para o tamanho do chunk: troca quase instantânea.
+            snapping = true;
+        }
+        m_morphRanges.append(QVector2D(start, 1.0f / (end - start)));
+    }
+
+    QStringList levelsText;
+    for (int level = 0; level < levels; ++level) {
+        levelsText << QString("%1@%2m").arg(m_lodResolutions[level]).arg(level == levels - 1 ? -1.0f : lodRange(level));
+    }
+    qInfo() << "Niveis de LOD do terreno (resolucao@fim da faixa):" << levelsText.join(" ");
+    if (snapping) {
+        qWarning() << "lodDistanceThreshold curto demais para o tamanho do chunk: sem faixa de morphing em algum nivel";
+    }
+}
+
+/**
+ * @brief Retorna a distância em que termina a faixa de um nível de LOD.
+ * @param level O nível.
+ */
+float terrainmanager::lodRange(int level) const {
+    return m_config->lodDistanceThreshold * m_lodDistanceScale * static_cast<float>(1 << level);
+}
+
+/**
+ * @brief Retorna o nível de LOD de uma resolução de malha.
+ * @param resolution Vértices por lado.
+ * @return O nível, ou -1 se a resolução não for de nenhum nível (ou 0, sem malha).
+ */
+int terrainmanager::lodLevelForResolution(int resolution) const {
+    for (int level = 0; level < lodLevelCount(); ++level) {
+        if (m_lodResolutions[level] == resolution) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Pede a malha de um chunk, se ele estiver na área ativa.
+ * @param slotX Índice X do slot.
+ * @param slotZ Índice Z do slot.
+ * @param resolution A resolução da malha.
+ * @return true se a malha foi pedida.
+ *
+ * Fora da área ativa, o chunk não é desenhado nem refinado, então gerar a sua malha só
+ * gastaria os workers. O LOD -1 marca que a malha que ele tem (se tiver) não vale mais;
+ * `setActiveGridSize` a pede quando a área voltar a cobri-lo.
+ */
+bool terrainmanager::requestMeshIfActive(int slotX, int slotZ, int resolution) {
+    chunk& target = m_chunks[slotX][slotZ];
+    if (isChunkInActiveArea(target)) {
+        requestMesh(slotX, slotZ, resolution);
+        return true;
+    }
+    target.setLOD(-1);
+    target.advanceGeneration(); // Um trabalho anterior ainda na fila ou rodando fica obsoleto.
+    return false;
+}
+
+/**
+ * @brief Indica se o terreno é desenhado em lote (TerrainBatchBuffers).
+ */
+bool terrainmanager::batchedDraws() const {
+    return m_config->batchedTerrainDraws && !m_config->heightTextureTerrain;
+}
+
+/**
+ * @brief Testa se um chunk está dentro da área ativa.
+ * @param currentChunk O chunk a testar.
+ * @return true se a distância em chunks até o centro (nos dois eixos) não passa da metade da área.
+ */
+bool terrainmanager::isChunkInActiveArea(const chunk& currentChunk) const {
+    return std::abs(currentChunk.chunkGridX() - m_centerChunkX) <= m_activeHalfGrid &&
+           std::abs(currentChunk.chunkGridZ() - m_centerChunkZ) <= m_activeHalfGrid;
+}
+
+/**
+ * @brief Testa se um chunk pode aparecer na tela.
+ * @param currentChunk O chunk a testar.
+ * @param margin Distância que a caixa pode estar fora do volume de visão e ainda ser aceita.
+ * @return true se a caixa envolvente cruza o volume de visão, ou se o chunk ainda não tem malha.
+ *
+ * X/Z vêm da posição do chunk na grade; Y vem das alturas da malha que está na GPU, que é a
+ * que será desenhada. Numa troca de LOD, a malha anterior (da mesma coordenada) continua até a
+ * nova subir; após uma reciclagem, o chunk fica sem malha até a da nova coordenada subir.
+ */
+bool terrainmanager::isChunkVisible(const chunk& currentChunk, float margin) const {
+    if (currentChunk.indexCount() == 0) {
+        return true; // Sem malha, a extensão em Y é desconhecida.
+    }
+    const float size = static_cast<float>(m_config->chunkSize);
+    const float minX = currentChunk.chunkGridX() * size;
+    const float minZ = currentChunk.chunkGridZ() * size;
+    return m_frustum.intersectsBox(QVector3D(minX, currentChunk.minHeight(), minZ),
+                                   QVector3D(minX + size, currentChunk.maxHeight(), minZ + size), margin);
+}
+
+/**
+ * @brief Converte uma coordenada de chunk no índice do seu slot no anel toroidal.
+ * @param chunkCoord Coordenada X ou Z do chunk na grade lógica.
+ * @return Índice no intervalo [0, gridRenderSize).
+ *
+ * Usa o módulo matemático (sempre não negativo), já que coordenadas de chunk
+ * podem ser negativas.
+ */
+int terrainmanager::gridSlot(int chunkCoord) const {
+    const int size = m_config->gridRenderSize;
+    int slot = chunkCoord % size;
+    return (slot < 0) ? slot + size : slot;
+}
+
+/**
+ * @brief Pede uma nova malha para o chunk de um slot.
+ * @param slotX Índice X do slot em `m_chunks`.
+ * @param slotZ Índice Z do slot em `m_chunks`.
+ * @param resolution Resolução da malha a ser gerada.
+ *
+ * O pedido anterior do mesmo slot fica obsoleto: se ainda estiver na fila do agendador,
+ * é substituído pelo novo (ou cancelado, se a malha vier do cache); se já estiver rodando,
+ * o próprio worker percebe pelo token de geração e abandona o trabalho.
+ */
+void terrainmanager::requestMesh(int slotX, int slotZ, int resolution) {
+    chunk& target = m_chunks[slotX][slotZ];
+
+    // Avança o token: qualquer trabalho anterior (na fila ou rodando) passa a ser obsoleto.
+    quint32 generation = target.advanceGeneration();
+    const int key = slotX * m_config->gridRenderSize + slotZ;
+
+    // Um chunk revisitado (passada de volta no talhão) reaproveita a malha guardada no cache.
+    if (m_meshCache.enabled()) {
+        chunk::MeshDataPtr cached = m_meshCache.take(target.chunkGridX(), target.chunkGridZ(), resolution);
+        if (cached) {
+            m_scheduler.cancel(key);
+            cached->generation = generation;
+            cached->requestedAtUs = cached->readyAtUs = TerrainCompletionQueue::timestampUs();
+            target.setPendingMeshData(std::move(*cached));
+            m_uploadQueue.push_back(key);
+            m_queuedUploadBytes += target.pendingMeshBytes();
+            return;
         }
     }
+
+    // Cria um novo trabalho para gerar a malha em uma thread separada e o entrega ao agendador,
+    // que o executa por ordem de prioridade (distância e direção em relação ao trator).
+    ChunkWorker* worker = new ChunkWorker(target.chunkGridX(), target.chunkGridZ(), resolution,
+                                          generation, target.generationToken(), m_config, m_completions.get());
+    m_scheduler.submit(key, worker, target.getCenterPosition(m_config->chunkSize));
 }
 
 /**
@@ -155,41 +612,443 @@ void terrainmanager::recenterGrid(int newCenterX, int newCenterZ){
  * @param lineShaderProgram Ponteiro para o shader das linhas (pode ser nullptr).
  * @param glFuncs Ponteiro para as funções OpenGL.
  *
- * Itera sobre todos os chunks na grade e chama seus métodos de renderização,
- * dependendo de qual shader foi fornecido (terreno ou linhas).
+ * Primeiro envia para a GPU as malhas prontas que cabem no orçamento do quadro;
+ * depois itera sobre todos os chunks na grade e desenha os que estão no volume de visão
+ * da câmera (calculado no `update`); os demais nem chegam a `chunk::render`.
+ * Os chunks visíveis são desenhados da frente para trás (WorldConfig::sortTerrainFrontToBack),
+ * para que o early-Z da GPU descarte os fragmentos dos chunks de trás que ficam cobertos.
+ * No desenho em lote, os chunks visíveis só marcam o seu slot (com a sua posição na ordem), e
+ * cada nível de LOD é desenhado na mesma ordem, em faixas de slots vizinhos que também são
+ * consecutivos na ordem. Entre níveis, a ordem é a dos níveis (do mais fino ao mais grosso),
+ * que acompanha a distância.
  */
 void terrainmanager::render(QOpenGLShaderProgram* terrainShaderProgram, QOpenGLFunctions *glFuncs) {
+    if (batchedDraws()) {
+        m_batchBuffers.beginFrame(); // Slots aposentados há quadros suficientes voltam a ficar livres.
+    }
+    processUploadQueue(glFuncs);
+
     // Se o shader de terreno foi passado, desenhamos o terreno.
-    if (terrainShaderProgram) {
+    m_trianglesLastFrame = 0;
+    m_chunksDrawnLastFrame = 0;
+    m_chunksCulledLastFrame = 0;
+    m_drawCallsLastFrame = 0;
+    if (!terrainShaderProgram) {
+        return;
+    }
+
+    // Lista dos chunks visíveis (slots da grade), na ordem de desenho.
+    const int gridSize = m_config->gridRenderSize;
+    m_drawList.clear();
+    for (int i = 0; i < gridSize; ++i) {
+        for (int j = 0; j < gridSize; ++j) {
+            // Chunk sem malha (recém-reciclado, ou ainda sem a primeira): nada a desenhar.
+            if (m_chunks[i][j].indexCount() == 0) {
+                continue;
+            }
+            if (!isChunkInActiveArea(m_chunks[i][j]) || !isChunkVisible(m_chunks[i][j], 0.0f)) {
+                ++m_chunksCulledLastFrame;
+                continue;
+            }
+            m_drawList.push_back(i * gridSize + j);
+        }
+    }
+
+    // Na medição da ordem de desenho, alterna a ordenação a cada janela de quadros e
+    // cronometra só o desenho do terreno (glFinish antes e depois).
+    const int benchmarkFrames = m_config->terrainDrawOrderBenchmarkFrames;
+    const bool benchmarking = benchmarkFrames > 0;
+    bool sortDrawList = m_config->sortTerrainFrontToBack;
+    if (benchmarking) {
+        sortDrawList = ((m_drawOrderBenchmarkFrame / benchmarkFrames) % 2) == 0;
+    }
+    if (sortDrawList) {
+        sortDrawListFrontToBack();
+    }
+    QElapsedTimer drawTimer;
+    if (benchmarking) {
+        glFuncs->glFinish();
+        drawTimer.start();
+    }
+
+    const bool batched = batchedDraws();
+    if (!batched) {
+        terrainShaderProgram->setUniformValue("batchVertexCount", 0); // Um chunk por desenho, com modelMatrix.
+    }
+    for (int order = 0; order < static_cast<int>(m_drawList.size()); ++order) {
+        const int slotKey = m_drawList[order];
+        chunk& current = m_chunks[slotKey / gridSize][slotKey % gridSize];
+        if (batched) {
+            // Só marca o slot; a página inteira é desenhada depois, por nível.
+            if (!current.batchSlot().isValid()) {
+                continue;
+            }
+            m_batchBuffers.markVisible(current.batchSlot(),
+                                       static_cast<float>(current.chunkGridX() * m_config->chunkSize),
+                                       current.heightBase(),
+                                       static_cast<float>(current.chunkGridZ() * m_config->chunkSize), order);
+        } else {
+            // A faixa de morphing é a do nível da malha que está na GPU, não a do LOD pedido.
+            const int level = lodLevelForResolution(current.currentResolution());
+            if (level >= 0) {
+                terrainShaderProgram->setUniformValue("morphRange", m_morphRanges[level]);
+                if (m_config->heightTextureTerrain) {
+                    terrainShaderProgram->setUniformValue("morphRatio", m_morphRatios[level]);
+                }
+            }
+            current.render(terrainShaderProgram, glFuncs);
+            if (current.indexCount() > 0) {
+                ++m_drawCallsLastFrame;
+            }
+        }
+        m_trianglesLastFrame += current.indexCount() / 3;
+        ++m_chunksDrawnLastFrame;
+    }
+
+    if (batched) {
+        // Nível por nível, do mais fino (o mais perto da câmera) ao mais grosso, com os
+        // uniformes do nível definidos uma única vez.
+        for (int level = 0; level < lodLevelCount(); ++level) {
+            const int resolution = m_lodResolutions[level];
+            terrainShaderProgram->setUniformValue("morphRange", m_morphRanges[level]);
+            if (m_config->compactTerrainVertices) {
+                terrainShaderProgram->setUniformValue("gridStep",
+                                                      static_cast<float>(m_config->chunkSize) / (resolution - 1));
+            }
+            m_drawCallsLastFrame += m_batchBuffers.drawVisible(resolution, terrainShaderProgram, glFuncs);
+        }
+    }
+
+    if (benchmarking) {
+        glFuncs->glFinish();
+        const int mode = sortDrawList ? 0 : 1;
+        m_drawOrderBenchmarkNs[mode] += drawTimer.nsecsElapsed();
+        ++m_drawOrderBenchmarkSamples[mode];
+        ++m_drawOrderBenchmarkFrame;
+        if (m_drawOrderBenchmarkFrame % (2 * benchmarkFrames) == 0) {
+            qInfo() << "Ordem de desenho do terreno (ms por quadro, com glFinish): frente-para-tras"
+                    << (m_drawOrderBenchmarkNs[0] / 1.0e6 / std::max(1, m_drawOrderBenchmarkSamples[0]))
+                    << "- ordem da grade"
+                    << (m_drawOrderBenchmarkNs[1] / 1.0e6 / std::max(1, m_drawOrderBenchmarkSamples[1]));
+            m_drawOrderBenchmarkNs[0] = m_drawOrderBenchmarkNs[1] = 0;
+            m_drawOrderBenchmarkSamples[0] = m_drawOrderBenchmarkSamples[1] = 0;
+        }
+    }
+    if (m_config->terrainLodBenchmarkFrames > 0) {
+        reportLodBenchmark();
+    }
+}
+
+/**
+ * @brief Classifica uma troca de nível de LOD que acabou de chegar à GPU.
+ * @param target O chunk, já com a malha nova.
+ * @param previousResolution A resolução da malha substituída.
+ *
+ * A troca não tem salto quando a malha mais fina do par está totalmente deformada até a
+ * superfície da mais grossa (fator de morphing 1) em todo o chunk: basta testar o ponto da
+ * caixa envolvente mais próximo da câmera, onde o fator é o menor. A falta de deformação
+ * (1 - fator) nesse ponto é a fração da diferença entre os níveis que aparece como salto.
+ */
+void terrainmanager::recordLodSwap(const chunk& target, int previousResolution) {
+    const int finerLevel = lodLevelForResolution(std::max(previousResolution, target.currentResolution()));
+    if (previousResolution <= 0 || previousResolution == target.currentResolution()
+        || finerLevel < 0 || finerLevel >= lodLevelCount() - 1) {
+        return; // Sem malha anterior, mesma resolução ou nível desconhecido: não é uma troca.
+    }
+    const float size = static_cast<float>(m_config->chunkSize);
+    const float minX = target.chunkGridX() * size;
+    const float minZ = target.chunkGridZ() * size;
+    const float dx = std::max({minX - m_lastCameraPos.x(), 0.0f, m_lastCameraPos.x() - (minX + size)});
+    const float dy = std::max({target.minHeight() - m_lastCameraPos.y(), 0.0f, m_lastCameraPos.y() - target.maxHeight()});
+    const float dz = std::max({minZ - m_lastCameraPos.z(), 0.0f, m_lastCameraPos.z() - (minZ + size)});
+    const float nearest = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    const QVector2D& range = m_morphRanges[finerLevel];
+    const float morph = std::clamp((nearest - range.x()) * range.y(), 0.0f, 1.0f);
+    ++m_lodBenchmarkSwaps;
+    if (morph < 1.0f) {
+        ++m_lodBenchmarkPops;
+        m_lodBenchmarkWorstGap = std::max(m_lodBenchmarkWorstGap, 1.0f - morph);
+    }
+}
+
+/**
+ * @brief Acumula os triângulos do quadro e registra a medição do LOD a cada janela.
+ */
+void terrainmanager::reportLodBenchmark() {
+    m_lodBenchmarkTriangles += m_trianglesLastFrame;
+    if (++m_lodBenchmarkFrame < m_config->terrainLodBenchmarkFrames) {
+        return;
+    }
+    qInfo() << "LOD do terreno:" << lodLevelCount() << "niveis - triangulos por quadro (media):"
+            << (m_lodBenchmarkTriangles / m_lodBenchmarkFrame)
+            << "- trocas de nivel na GPU:" << m_lodBenchmarkSwaps
+            << "- sem salto:" << (m_lodBenchmarkSwaps - m_lodBenchmarkPops)
+            << "- com salto:" << m_lodBenchmarkPops
+            << "- maior deformacao faltante:" << qRound(m_lodBenchmarkWorstGap * 100.0f) << "%";
+    m_lodBenchmarkFrame = 0;
+    m_lodBenchmarkTriangles = 0;
+    m_lodBenchmarkSwaps = 0;
+    m_lodBenchmarkPops = 0;
+    m_lodBenchmarkWorstGap = 0.0f;
+}
+
+/**
+ * @brief Ordena a lista de desenho da frente para trás (distância até a câmera).
+ *
+ * Counting sort em faixas de meio chunk: O(n) sem comparações, e as faixas são finas o
+ * bastante para o early-Z (chunks na mesma faixa mal se sobrepõem na tela). A distância é a
+ * do centro da caixa envolvente do chunk, sem consultar a função de altura.
+ */
+void terrainmanager::sortDrawListFrontToBack() {
+    const int gridSize = m_config->gridRenderSize;
+    const float binSize = 0.5f * m_config->chunkSize;
+    // A grade cobre até gridSize * chunkSize * sqrt(2) / 2 a partir do centro; a câmera pode
+    // estar a até um chunk do centro. O que passar disso vai para a última faixa.
+    const int binCount = 2 * gridSize + 4;
+    const size_t count = m_drawList.size();
+
+    m_drawListBins.resize(count);
+    m_drawListBinStart.assign(static_cast<size_t>(binCount) + 1, 0);
+    for (size_t k = 0; k < count; ++k) {
+        const int slotKey = m_drawList[k];
+        const chunk& current = m_chunks[slotKey / gridSize][slotKey % gridSize];
+        const QVector3D center((current.chunkGridX() + 0.5f) * m_config->chunkSize,
+                               0.5f * (current.minHeight() + current.maxHeight()),
+                               (current.chunkGridZ() + 0.5f) * m_config->chunkSize);
+        const int bin = std::min(static_cast<int>(m_lastCameraPos.distanceToPoint(center) / binSize), binCount - 1);
+        m_drawListBins[k] = bin;
+        ++m_drawListBinStart[static_cast<size_t>(bin) + 1];
+    }
+    for (int bin = 0; bin < binCount; ++bin) {
+        m_drawListBinStart[static_cast<size_t>(bin) + 1] += m_drawListBinStart[static_cast<size_t>(bin)];
+    }
+    m_drawListScratch.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        m_drawListScratch[static_cast<size_t>(m_drawListBinStart[static_cast<size_t>(m_drawListBins[k])]++)] = m_drawList[k];
+    }
+    m_drawList.swap(m_drawListScratch);
+}
+
+/**
+ * @brief Envia para a GPU as malhas prontas, dentro do orçamento do quadro.
+ * @param glFuncs Ponteiro para as funções OpenGL.
+ *
+ * Após um recentramento, dezenas de chunks podem ficar prontos ao mesmo tempo; enviar
+ * todos no mesmo paintGL causa engasgos visíveis. A fila é ordenada pela distância até a
+ * câmera e esvaziada até o limite de bytes ou de tempo do quadro.
+ */
+void terrainmanager::processUploadQueue(QOpenGLFunctions* glFuncs) {
+    if (m_uploadQueue.empty()) {
+        m_queuedUploadBytes = 0;
+        return;
+    }
+
+    const int gridSize = m_config->gridRenderSize;
+    auto chunkAt = [this, gridSize](int key) -> chunk& { return m_chunks[key / gridSize][key % gridSize]; };
+
+    // Remove entradas repetidas e chunks cuja malha pendente foi descartada (reciclagem).
+    // Uma malha pendente de um pedido já substituído (o token de geração avançou, por exemplo
+    // porque as alturas do chunk mudaram) também é descartada: enviá-la mostraria alturas antigas
+    // e a colocaria no cache, de onde poderia voltar numa próxima visita. A malha do pedido
+    // novo entra na fila quando ficar pronta.
+    std::sort(m_uploadQueue.begin(), m_uploadQueue.end());
+    m_uploadQueue.erase(std::unique(m_uploadQueue.begin(), m_uploadQueue.end()), m_uploadQueue.end());
+    m_uploadQueue.erase(std::remove_if(m_uploadQueue.begin(), m_uploadQueue.end(),
+                                       [&](int key) {
+                                           chunk& target = chunkAt(key);
+                                           if (target.isPendingMeshStale()) {
+                                               target.discardPendingMesh();
+                                           }
+                                           return !target.hasPendingMesh();
+                                       }),
+                        m_uploadQueue.end());
+
+    // Os chunks mais próximos da câmera sobem primeiro.
+    std::vector<std::pair<float, int>> ordered;
+    ordered.reserve(m_uploadQueue.size());
+    for (int key : m_uploadQueue) {
+        float distance = m_lastCameraPos.distanceToPoint(chunkAt(key).getCenterPosition(m_config->chunkSize));
+        ordered.emplace_back(distance, key);
+    }
+    std::sort(ordered.begin(), ordered.end());
+
+    const qint64 timeBudgetNs = static_cast<qint64>(m_config->uploadBudgetMsPerFrame * 1000000.0f);
+    const qint64 byteBudget = m_config->uploadBudgetBytesPerFrame;
+    QElapsedTimer uploadTimer;
+    uploadTimer.start();
+
+    qint64 uploadedBytes = 0;
+    size_t next = 0;
+    chunk::MeshData uploaded; // Malha recém-enviada, guardada no cache para uma próxima visita.
+    for (; next < ordered.size(); ++next) {
+        chunk& target = chunkAt(ordered[next].second);
+        // Pelo menos uma malha sobe por quadro, para a fila nunca travar.
+        if (next > 0 && (uploadedBytes + target.pendingMeshBytes() > byteBudget
+                         || uploadTimer.nsecsElapsed() >= timeBudgetNs)) {
+            break;
+        }
+        const qint64 readyAtUs = target.pendingMeshReadyAtUs();
+        // Um chunk reciclado não tem malha anterior: a primeira malha não é uma troca de LOD.
+        const int previousResolution = target.indexCount() > 0 ? target.currentResolution() : 0;
+        uploadedBytes += target.uploadPendingMesh(glFuncs, &m_indexBuffers, &m_bufferPool,
+                                                  batchedDraws() ? &m_batchBuffers : nullptr,
+                                                  m_meshCache.enabled() ? &uploaded : nullptr);
+        if (m_meshCache.enabled()) {
+            m_meshCache.insert(std::move(uploaded));
+        }
+        char& swapPending = m_lodSwapPending[static_cast<size_t>(ordered[next].second)];
+        if (swapPending) {
+            swapPending = 0;
+            if (m_config->terrainLodBenchmarkFrames > 0) {
+                recordLodSwap(target, previousResolution);
+            }
+        }
+        const float readyToUploadMs = (TerrainCompletionQueue::timestampUs() - readyAtUs) / 1000.0f;
+        m_avgReadyToUploadMs += LATENCY_SMOOTHING * (readyToUploadMs - m_avgReadyToUploadMs);
+    }
+
+    if (uploadTimer.nsecsElapsed() > timeBudgetNs) {
+        ++m_framesOverBudget;
+    }
+
+    // O que não coube fica para os próximos quadros.
+    m_uploadQueue.clear();
+    m_queuedUploadBytes = 0;
+    for (size_t i = next; i < ordered.size(); ++i) {
+        m_uploadQueue.push_back(ordered[i].second);
+        m_queuedUploadBytes += chunkAt(ordered[i].second).pendingMeshBytes();
+    }
+    if (!m_uploadQueue.empty()) {
+        ++m_deferredUploadFrames;
+    }
+}
+
+/**
+ * @brief Limita a área desenhada e refinada a um quadrado em volta do centro da grade.
+ * @param gridSize Lado da área, em chunks (arredondado para ímpar e limitado a gridRenderSize).
+ */
+void terrainmanager::setActiveGridSize(int gridSize) {
+    if (!m_config) {
+        return; // Antes de `init`.
+    }
+    const int halfGrid = std::clamp(gridSize / 2, 0, m_config->gridRenderSize / 2);
+    if (halfGrid == m_activeHalfGrid) {
+        return;
+    }
+    const bool growing = halfGrid > m_activeHalfGrid;
+    m_activeHalfGrid = halfGrid;
+    // Os chunks que a área passa a cobrir e que ficaram sem malha válida pedem a do nível mais grosso.
+    if (growing) {
         for (int i = 0; i < m_config->gridRenderSize; ++i) {
             for (int j = 0; j < m_config->gridRenderSize; ++j) {
-                m_chunks[i][j].render(terrainShaderProgram, glFuncs);
+                chunk& target = m_chunks[i][j];
+                if (target.getLOD() == -1 && isChunkInActiveArea(target)) {
+                    target.setLOD(lodLevelCount() - 1);
+                    requestMesh(i, j, m_lodResolutions.back());
+                }
             }
         }
     }
+    qInfo() << "Area ativa do terreno:" << activeGridSize() << "x" << activeGridSize() << "chunks (grade" << m_config->gridRenderSize << ")";
 }
 
 /**
- * @brief Slot para receber a malha pronta de um ChunkWorker.
- * @param chunkX Coordenada X do chunk.
- * @param chunkZ Coordenada Z do chunk.
- * @param meshData A estrutura MeshData contendo a malha gerada.
+ * @brief Multiplica as distâncias das faixas de LOD e recalcula o morphing.
+ * @param scale O multiplicador (limitado a 0.1 ou mais).
+ */
+void terrainmanager::setLodDistanceScale(float scale) {
+    scale = std::max(scale, 0.1f);
+    if (scale == m_lodDistanceScale) {
+        return;
+    }
+    m_lodDistanceScale = scale;
+    if (!m_config) {
+        return; // Antes de `init`: os níveis são montados lá, já com a escala.
+    }
+    buildLodLevels(); // As resoluções não mudam; as faixas de morphing acompanham as novas distâncias.
+}
+
+/**
+ * @brief Muda o número de threads de geração de malha.
+ * @param workerThreads Número de threads (mínimo 1).
+ */
+void terrainmanager::setWorkerThreads(int workerThreads) {
+    m_scheduler.setWorkerCount(workerThreads);
+}
+
+/**
+ * @brief Indica se há trabalho de terreno que ainda vai aparecer na tela.
+ * @return true se há malhas na fila do agendador, na fila de conclusão ou esperando upload.
  *
- * Este slot é chamado na thread principal (graças ao Qt::QueuedConnection)
+ * Um trabalho já em execução em um worker não é contado: quando termina, a malha entra na fila
+ * de conclusão e a próxima consulta a encontra.
+ */
+bool terrainmanager::hasPendingWork() const
+{
+    if (!m_uploadQueue.empty()) {
+        return true;
+    }
+    if (m_completions && m_completions->approximateSize() > 0) {
+        return true;
+    }
+    return m_scheduler.pendingJobs() > 0;
+}
+
+/**
+ * @brief Retira da fila de conclusão as malhas prontas, até o limite do quadro.
+ *
+ * Substitui um evento Qt por chunk: as malhas chegam todas em um ponto conhecido do
+ * quadro, sem se intercalar com eventos de entrada e timers. Também atualiza a métrica
+ * de profundidade da fila e a latência pedido -> pronta.
+ */
+void terrainmanager::drainCompletions() {
+    if (!m_completions) {
+        return;
+    }
+    m_maxCompletionQueueDepth = std::max(m_maxCompletionQueueDepth, static_cast<int>(m_completions->approximateSize()));
+
+    for (int drained = 0; drained < m_config->completionDrainPerFrame; ++drained) {
+        chunk::MeshDataPtr mesh = m_completions->tryPop();
+        if (!mesh) {
+            break;
+        }
+        const float requestToReadyMs = (mesh->readyAtUs - mesh->requestedAtUs) / 1000.0f;
+        m_avgRequestToReadyMs += LATENCY_SMOOTHING * (requestToReadyMs - m_avgRequestToReadyMs);
+        onMeshReady(std::move(mesh));
+    }
+    m_completionQueueDepth = static_cast<int>(m_completions->approximateSize());
+}
+
+/**
+ * @brief Recebe a malha pronta de um ChunkWorker.
+ * @param meshData A malha gerada, por posse única.
+ *
+ * É chamado na thread principal por `drainCompletions`
  * e é responsável por armazenar a malha gerada no `chunk` correspondente.
- * O upload real para a GPU ocorrerá na próxima chamada a `render`.
+ * O upload real para a GPU ocorrerá pela fila de uploads, em `render`, dentro do orçamento do quadro.
  */
-void terrainmanager::onMeshReady(int chunkX, int chunkZ, const chunk::MeshData& meshData)
+void terrainmanager::onMeshReady(chunk::MeshDataPtr meshData)
 {
-    // Calcula a posição do chunk na nossa grade interna (matriz m_chunks).
-    int grid_i = (chunkX - m_centerChunkX) + m_config->gridRenderSize / 2;
-    int grid_j = (chunkZ - m_centerChunkZ) + m_config->gridRenderSize / 2;
-
-    // Verifica se o chunk ainda pertence à grade atual.
-    // É possível que o chunk já tenha saído da área de renderização antes que sua malha fosse gerada.
-    if(grid_i >= 0 && grid_i < m_config->gridRenderSize && grid_j >= 0 && grid_j < m_config->gridRenderSize) {
-        chunk& targetChunk = m_chunks[grid_i][grid_j]; // Obtém uma referência para o chunk alvo.
-        // Apenas armazena os dados da malha; o upload para a GPU (uploadMeshData) será feito em render().
-        targetChunk.setPendingMeshData(meshData);
+    if (!meshData) {
+        return;
+    }
+    const int chunkX = meshData->chunkGridX;
+    const int chunkZ = meshData->chunkGridZ;
+
+    // Localiza o slot da coordenada no anel toroidal.
+    chunk& targetChunk = m_chunks[gridSlot(chunkX)][gridSlot(chunkZ)];
+
+    // Verifica se o slot ainda contém este chunk e se este é o pedido mais recente para ele.
+    // É possível que o chunk já tenha saído da área de renderização (e o slot tenha sido
+    // reciclado para outra coordenada) ou mudado de LOD depois que o worker terminou;
+    // nesse caso o token de geração não bate e o resultado antigo é descartado.
+    if (targetChunk.chunkGridX() == chunkX && targetChunk.chunkGridZ() == chunkZ
+        && targetChunk.generation() == meshData->generation) {
+        // Apenas armazena os dados da malha e enfileira o slot; o upload para a GPU será feito
+        // por processUploadQueue(), em render(), respeitando o orçamento do quadro.
+        targetChunk.setPendingMeshData(std::move(*meshData));
+        m_uploadQueue.push_back(gridSlot(chunkX) * m_config->gridRenderSize + gridSlot(chunkZ));
+        m_queuedUploadBytes += targetChunk.pendingMeshBytes();
     }
 }
@@ -6,7 +6,19 @@
 #include <QVector3D>            // Para QVector3D, usado para a posição da câmera e cálculo de distância.
 #include <QOpenGLShaderProgram> // Para QOpenGLShaderProgram, usado para os shaders de terreno e linha.
 #include <QOpenGLFunctions>     // Para QOpenGLFunctions, para acesso às funções OpenGL.
-#include <QThread>              // Incluído, mas QThreadPool é usado para gerenciamento de threads de worker.
+#include "terrainjobscheduler.h" // Agendador por prioridade dos trabalhos de geração de malha.
+#include "terrainindexbuffers.h" // Buffers de índices compartilhados por resolução.
+#include "terrainbufferpool.h"  // Pool de VBOs reaproveitados entre chunks.
+#include "terraincompletionqueue.h" // Fila sem travas de malhas prontas (workers -> thread principal).
+#include "terrainmeshcache.h"   // Cache LRU de malhas já geradas.
+#include "demheightsource.h"    // Fonte de alturas lida de um DEM mapeado em memória.
+#include "gnssheightsource.h"   // Fonte de alturas construída com as altitudes do GNSS.
+#include "viewfrustum.h"        // Volume de visão da câmera, para o culling dos chunks.
+#include "terrainbatchbuffers.h" // Páginas de vértices do desenho em lote.
+#include <memory>               // Para std::unique_ptr (fila de conclusão criada em `init`).
+#include <QVector>              // Para as faixas de morphing de cada nível de LOD.
+#include <QVector2D>            // Faixa de morphing (início, 1 / largura) enviada ao shader.
+#include <QElapsedTimer>        // Janela do relatório periódico de métricas.
 
 // Declaração antecipada de ChunkWorker e WorldConfig
 // Descrição: Usadas para evitar inclusões circulares e para declarar que terrainmanager
@@ -17,7 +29,8 @@ struct WorldConfig;
 // Classe: terrainmanager
 // Descrição: Gerencia a geração, atualização e renderização dos chunks de terreno.
 //            Esta classe implementa a lógica de terreno infinito, LOD (Nível de Detalhe)
-//            e delega a geração de malha para threads de worker para evitar bloqueios na UI.
+//            e delega a geração de malha para threads de worker (via TerrainJobScheduler)
+//            para evitar bloqueios na UI.
 //            É responsável por manter a grade de chunks centrada na câmera e por disparar
 //            a recriação de malhas quando o LOD ou a posição do centro da grade muda.
 class terrainmanager : public QObject {
@@ -25,13 +38,14 @@ class terrainmanager : public QObject {
 
 public:
     // Construtor: terrainmanager
-    // Descrição: Inicializa o gerenciador de terreno e configura o QThreadPool global
-    //            para limitar o número de threads usadas para geração de chunks.
+    // Descrição: Inicializa o gerenciador de terreno. O número de threads de geração de
+    //            chunks é definido em `init`, a partir de `WorldConfig::terrainWorkerThreads`,
+    //            no pool privado do agendador (o QThreadPool global não é alterado).
     terrainmanager();
 
     // Destrutor: ~terrainmanager
-    // Descrição: Garante que todos os trabalhos pendentes no QThreadPool sejam concluídos
-    //            antes que o gerenciador seja destruído.
+    // Descrição: Descarta os trabalhos na fila do agendador e espera os que estão em
+    //            execução terminarem antes que o gerenciador seja destruído.
     ~terrainmanager();
 
     // Método: init
@@ -49,52 +63,301 @@ public:
 
     // Método: update
     // Descrição: Atualiza o estado do terreno com base na posição atual da câmera.
-    //            Verifica se a grade de chunks precisa ser recentrada e se o LOD
-    //            dos chunks precisa ser ajustado, disparando novos trabalhos de geração de malha.
+    //            Primeiro retira da fila de conclusão as malhas prontas (até
+    //            `WorldConfig::completionDrainPerFrame`). Depois verifica se a grade de chunks
+    //            precisa ser recentrada e se o LOD dos chunks precisa ser ajustado,
+    //            disparando novos trabalhos de geração de malha. A troca de LOD dos chunks
+    //            fora do volume de visão fica adiada até eles se aproximarem da tela.
     // Parâmetros:
     //   - cameraPos: A posição atual da câmera no espaço do mundo.
-    void update(const QVector3D& cameraPos);
+    //   - viewProjection: A matriz projeção * visão da câmera, usada no culling dos chunks
+    //                     neste `update` e no `render` seguinte.
+    void update(const QVector3D& cameraPos, const QMatrix4x4& viewProjection);
+
+    // Método: setFocus
+    // Descrição: Informa a posição e a direção de deslocamento do trator. Os trabalhos de
+    //            geração de malha na fila são (re)priorizados pela distância a esse ponto,
+    //            com preferência para os chunks à frente do trator.
+    // Parâmetros:
+    //   - tractorPos: Posição do trator no mundo.
+    //   - tractorHeading: Direção de deslocamento do trator (vetor "para frente").
+    void setFocus(const QVector3D& tractorPos, const QVector3D& tractorHeading);
+
+    // Método: addElevationSample
+    // Descrição: Entrega uma altitude do GNSS ao modelo de elevação em construção
+    //            (`WorldConfig::gnssTerrainEnabled`). Os chunks cuja altura mudou são
+    //            regenerados no próximo `update`. Sem o modelo ativo, a amostra é ignorada.
+    // Parâmetros:
+    //   - worldX: Coordenada X do mundo da antena.
+    //   - worldZ: Coordenada Z do mundo da antena.
+    //   - altitude: Altitude medida, em metros.
+    //   - verticalSigma: Desvio padrão vertical (GnssHeightSource::verticalSigma).
+    void addElevationSample(float worldX, float worldZ, double altitude, float verticalSigma);
+
+    // Método: setDemWorldOrigin
+    // Descrição: Posiciona o DEM no mundo (DemHeightSource::setWorldOrigin) quando a origem do
+    //            mundo passa a ser conhecida. O cache de malhas é esvaziado e os chunks da grade
+    //            são regenerados no seu LOD atual. Sem DEM aberto, não faz nada.
+    // Parâmetros:
+    //   - worldX: Coordenada X do mundo do centro da célula noroeste do DEM.
+    //   - worldZ: Coordenada Z do mundo do centro da célula noroeste do DEM.
+    void setDemWorldOrigin(double worldX, double worldZ);
 
     // Método: render
     // Descrição: Renderiza todos os chunks gerenciados, usando os shaders fornecidos.
-    //            Esta função também lida com o upload de dados de malha pendentes para a GPU.
+    //            Antes de desenhar, processa a fila de uploads dentro do orçamento do quadro.
     // Parâmetros:
     //   - terrainShaderProgram: Ponteiro para o programa de shader de terreno (pode ser nullptr para renderizar apenas bordas).
     //   - lineShaderProgram: Ponteiro para o programa de shader de linha (pode ser nullptr para renderizar apenas terreno).
     //   - glFuncs: Ponteiro para as funções OpenGL.
     void render(QOpenGLShaderProgram* terrainShaderProgram, QOpenGLFunctions *glFuncs);
 
-private slots:
-    // Slot Privado: onMeshReady
-    // Descrição: Slot que recebe os dados de malha gerados por um `ChunkWorker` em uma thread separada.
-    //            É chamado via `QMetaObject::invokeMethod` com `Qt::QueuedConnection`,
-    //            garantindo que seja executado na thread do `terrainmanager` (a thread principal),
-    //            onde as operações OpenGL podem ser realizadas com segurança.
+    // Método: setActiveGridSize
+    // Descrição: Limita o terreno desenhado e refinado a um quadrado de `gridSize` chunks em volta
+    //            do centro, sem realocar a grade (que continua com `gridRenderSize`). Os chunks de
+    //            fora não geram malha (nem nos recentramentos nem por mudança de altura); quando a
+    //            área cresce, os que ficaram sem malha válida a pedem no nível mais grosso.
+    //            Usado pelo governador de qualidade.
     // Parâmetros:
-    //   - chunkX: Coordenada X do chunk para o qual a malha foi gerada.
-    //   - chunkZ: Coordenada Z do chunk para o qual a malha foi gerada.
-    //   - meshData: A estrutura `chunk::MeshData` contendo os vértices e índices prontos.
-    void onMeshReady(int chunkX, int chunkZ, const chunk::MeshData& meshData);
+    //   - gridSize: Lado da área ativa, em chunks (limitado a `gridRenderSize`).
+    void setActiveGridSize(int gridSize);
+
+    // Método: setLodDistanceScale
+    // Descrição: Multiplica as distâncias das faixas de LOD (1 = `lodDistanceThreshold`); menos que
+    //            1 traz os níveis grossos para mais perto da câmera. As faixas de morphing são
+    //            recalculadas; os chunks mudam de nível aos poucos, pela histerese normal.
+    // Parâmetros:
+    //   - scale: O multiplicador (> 0).
+    void setLodDistanceScale(float scale);
+
+    // Método: setWorkerThreads
+    // Descrição: Muda o número de threads de geração de malha em tempo de execução.
+    // Parâmetros:
+    //   - workerThreads: Número de threads (mínimo 1).
+    void setWorkerThreads(int workerThreads);
+
+    // Método: activeGridSize
+    // Descrição: Retorna o lado da área ativa, em chunks.
+    int activeGridSize() const { return m_activeHalfGrid * 2 + 1; }
+
+    // Método: hasPendingWork
+    // Descrição: Indica se o terreno ainda vai mudar na tela sem que a câmera se mova: malhas na
+    //            fila de geração, prontas na fila de conclusão ou esperando upload. Usado pelo
+    //            redesenho sob demanda (WorldConfig::renderOnDemand).
+    // Retorno: bool - true se o próximo quadro pode mostrar terreno novo.
+    bool hasPendingWork() const;
+
+    // Método: queuedUploadBytes
+    // Descrição: Retorna quantos bytes de malhas prontas ainda esperam o upload para a GPU
+    //            (medido ao fim do último processamento da fila).
+    // Retorno: qint64 - Bytes na fila de uploads.
+    qint64 queuedUploadBytes() const { return m_queuedUploadBytes; }
+
+    // Método: framesOverBudget
+    // Descrição: Retorna em quantos quadros os uploads passaram do orçamento de tempo
+    //            (uma única malha grande pode estourá-lo, já que pelo menos uma sobe por quadro).
+    // Retorno: int - Total acumulado de quadros acima do orçamento.
+    int framesOverBudget() const { return m_framesOverBudget; }
+
+    // Método: deferredUploadFrames
+    // Descrição: Retorna em quantos quadros o orçamento foi atingido e parte da fila ficou para depois.
+    // Retorno: int - Total acumulado de quadros com uploads adiados.
+    int deferredUploadFrames() const { return m_deferredUploadFrames; }
+
+    // Método: completionQueueDepth
+    // Descrição: Retorna quantas malhas prontas ficaram na fila de conclusão após o último `update`.
+    // Retorno: int - Profundidade da fila.
+    int completionQueueDepth() const { return m_completionQueueDepth; }
+
+    // Método: maxCompletionQueueDepth
+    // Descrição: Retorna a maior profundidade da fila de conclusão observada antes de esvaziá-la.
+    // Retorno: int - Profundidade máxima.
+    int maxCompletionQueueDepth() const { return m_maxCompletionQueueDepth; }
+
+    // Método: trianglesLastFrame
+    // Descrição: Retorna quantos triângulos de terreno foram desenhados no último `render`.
+    // Retorno: int - Triângulos desenhados.
+    int trianglesLastFrame() const { return m_trianglesLastFrame; }
+
+    // Método: lodSwitches
+    // Descrição: Retorna quantas trocas de nível de LOD já foram pedidas (diagnóstico).
+    // Retorno: int - Trocas de LOD.
+    int lodSwitches() const { return m_lodSwitches; }
+
+    // Método: chunksDrawnLastFrame / chunksCulledLastFrame
+    // Descrição: Retorna quantos chunks foram desenhados / descartados pelo culling no último `render`.
+    // Retorno: int - Quantidade de chunks.
+    int chunksDrawnLastFrame() const { return m_chunksDrawnLastFrame; }
+    int chunksCulledLastFrame() const { return m_chunksCulledLastFrame; }
+
+    // Método: drawCallsLastFrame
+    // Descrição: Retorna quantas chamadas glDrawElements o terreno fez no último `render`.
+    // Retorno: int - Chamadas de desenho.
+    int drawCallsLastFrame() const { return m_drawCallsLastFrame; }
+
+    // Método: deferredLodChunks
+    // Descrição: Retorna quantos chunks fora da tela tiveram a troca de LOD adiada no último `update`.
+    // Retorno: int - Quantidade de chunks.
+    int deferredLodChunks() const { return m_deferredLodChunks; }
+
+    // Método: lodLevelCount
+    // Descrição: Retorna o número de níveis de LOD, de `highRes` a `coarsestRes` (montados em `init`).
+    // Retorno: int - Níveis de LOD.
+    int lodLevelCount() const { return static_cast<int>(m_lodResolutions.size()); }
+
+    // Método: avgRequestToReadyMs
+    // Descrição: Latência média (móvel) entre o pedido de uma malha e sua conclusão no worker,
+    //            incluindo o tempo na fila do agendador.
+    // Retorno: float - Milissegundos.
+    float avgRequestToReadyMs() const { return m_avgRequestToReadyMs; }
+
+    // Método: avgReadyToUploadMs
+    // Descrição: Latência média (móvel) entre a conclusão de uma malha no worker e seu upload
+    //            para a GPU (fila de conclusão + fila de uploads).
+    // Retorno: float - Milissegundos.
+    float avgReadyToUploadMs() const { return m_avgReadyToUploadMs; }
+
+    // Método: meshCache
+    // Descrição: Acesso ao cache de malhas, para consultar os contadores de acertos, falhas
+    //            e descartes (dimensionamento de `WorldConfig::meshCacheBudgetBytes`).
+    // Retorno: const TerrainMeshCache& - O cache.
+    const TerrainMeshCache& meshCache() const { return m_meshCache; }
 
 private:
+    // Método Privado: drainCompletions
+    // Descrição: Retira da fila de conclusão até `WorldConfig::completionDrainPerFrame` malhas
+    //            prontas e as entrega a `onMeshReady`. O restante fica para o próximo quadro.
+    void drainCompletions();
+
+    // Método Privado: onMeshReady
+    // Descrição: Recebe uma malha gerada por um `ChunkWorker`, já na thread principal.
+    //            A malha chega por posse única e é movida para o chunk, sem cópias.
+    // Parâmetros:
+    //   - meshData: A malha pronta (com as coordenadas do chunk e o token de geração).
+    void onMeshReady(chunk::MeshDataPtr meshData);
+
     // Método Privado: recenterGrid
     // Descrição: Recentra a grade de chunks ao redor de uma nova posição central.
-    //            Isso envolve reciclar chunks existentes e disparar a geração de novas malhas
-    //            para os chunks recém-visíveis.
+    //            Como a grade é um anel toroidal, apenas os chunks cuja coordenada
+    //            saiu da janela visível (a nova borda de avanço) são reciclados e têm
+    //            sua malha regenerada. Os demais mantêm malha e buffers de GPU.
     // Parâmetros:
     //   - newCenterX: A nova coordenada X do chunk central da grade.
     //   - newCenterZ: A nova coordenada Z do chunk central da grade.
     void recenterGrid(int newCenterX, int newCenterZ);
 
+    // Método Privado: regenerateDirtyChunks
+    // Descrição: Descarta do cache as malhas dos chunks cuja altura mudou no modelo do GNSS e
+    //            pede de novo a malha dos que estão na grade, no LOD atual.
+    void regenerateDirtyChunks();
+
+    // Método Privado: reportStats
+    // Descrição: Registra no log, a cada `STATS_REPORT_INTERVAL_MS`, as métricas do terreno
+    //            (geração, uploads, cache, fontes de altura e desenho). Chamado no fim de `update`.
+    void reportStats();
+
+    // Método Privado: buildLodLevels
+    // Descrição: Monta a resolução de cada nível de LOD (chunk::nextLodResolution, de `highRes`
+    //            a `coarsestRes`) e a faixa de distância do morphing de cada nível, enviada ao shader.
+    void buildLodLevels();
+
+    // Método Privado: recordLodSwap
+    // Descrição: Na medição do LOD (WorldConfig::terrainLodBenchmarkFrames), classifica a troca de
+    //            nível que acabou de chegar à GPU: sem salto se o ponto do chunk mais próximo da
+    //            câmera já estava no fim da faixa de morphing do nível mais fino do par.
+    // Parâmetros:
+    //   - target: O chunk, já com a malha nova.
+    //   - previousResolution: A resolução da malha que foi substituída.
+    void recordLodSwap(const chunk& target, int previousResolution);
+
+    // Método Privado: reportLodBenchmark
+    // Descrição: Acumula os triângulos do quadro e, a cada `terrainLodBenchmarkFrames` quadros,
+    //            registra no log a medição do LOD. Chamado no fim de `render`.
+    void reportLodBenchmark();
+
+    // Método Privado: lodRange
+    // Descrição: Distância da câmera em que termina a faixa de um nível: lodDistanceThreshold * 2^nível.
+    float lodRange(int level) const;
+
+    // Método Privado: lodLevelForResolution
+    // Descrição: Retorna o nível de LOD de uma resolução de malha, ou -1 se não houver.
+    int lodLevelForResolution(int resolution) const;
+
+    // Método Privado: isChunkInActiveArea
+    // Descrição: Testa se o chunk está dentro da área ativa (`setActiveGridSize`).
+    bool isChunkInActiveArea(const chunk& currentChunk) const;
+
+    // Método Privado: isChunkVisible
+    // Descrição: Testa a caixa envolvente da malha do chunk (X/Z do chunk, Y das alturas da
+    //            malha na GPU) contra o volume de visão do último `update`.
+    // Parâmetros:
+    //   - currentChunk: O chunk a testar.
+    //   - margin: Distância, em metros, que a caixa pode estar fora da tela e ainda contar como visível.
+    // Retorno: bool - true se o chunk pode aparecer (ou se ainda não tem malha).
+    bool isChunkVisible(const chunk& currentChunk, float margin) const;
+
+    // Método Privado: batchedDraws
+    // Descrição: Indica se o terreno usa o desenho em lote (não se aplica ao formato HeightTexture,
+    //            em que cada chunk tem a sua textura de alturas).
+    bool batchedDraws() const;
+
+    // Método Privado: sortDrawListFrontToBack
+    // Descrição: Ordena `m_drawList` pela distância da câmera até cada chunk (bucket sort em
+    //            faixas de meio chunk), para que os chunks da frente sejam desenhados primeiro.
+    void sortDrawListFrontToBack();
+
+    // Método Privado: gridSlot
+    // Descrição: Converte uma coordenada de chunk no mundo para o índice da sua posição
+    //            (slot) no anel toroidal `m_chunks`. Cada coordenada tem sempre o mesmo
+    //            slot, de modo que mover a janela visível só afeta os slots da borda.
+    // Parâmetros:
+    //   - chunkCoord: Coordenada X ou Z do chunk na grade lógica do terreno.
+    // Retorno: int - Índice no intervalo [0, gridRenderSize).
+    int gridSlot(int chunkCoord) const;
+
+    // Método Privado: requestMesh
+    // Descrição: Pede uma nova malha para o chunk de um slot. Avança o token de geração
+    //            do chunk (tornando obsoleto qualquer trabalho anterior). Se a malha estiver
+    //            no cache, ela vai direto para a fila de uploads; senão, um novo `ChunkWorker`
+    //            é submetido ao agendador, que substitui o trabalho anterior desse slot
+    //            se ele ainda estiver na fila.
+    // Parâmetros:
+    //   - slotX: Índice X do slot em `m_chunks`.
+    //   - slotZ: Índice Z do slot em `m_chunks`.
+    //   - resolution: A resolução da malha a ser gerada.
+    void requestMesh(int slotX, int slotZ, int resolution);
+
+    // Método Privado: requestMeshIfActive
+    // Descrição: Chama `requestMesh` para um chunk da área ativa. Fora dela, nenhuma malha é
+    //            gerada: o chunk fica sem LOD (-1), qualquer trabalho anterior fica obsoleto e a
+    //            malha é pedida por `setActiveGridSize` quando a área voltar a cobri-lo.
+    // Parâmetros:
+    //   - slotX: Índice X do slot em `m_chunks`.
+    //   - slotZ: Índice Z do slot em `m_chunks`.
+    //   - resolution: A resolução da malha a ser gerada.
+    // Retorno: bool - true se a malha foi pedida.
+    bool requestMeshIfActive(int slotX, int slotZ, int resolution);
+
+    // Método Privado: processUploadQueue
+    // Descrição: Envia para a GPU as malhas prontas da fila, das mais próximas da câmera para
+    //            as mais distantes, até esgotar o orçamento de bytes ou de tempo do quadro
+    //            (`WorldConfig::uploadBudgetBytesPerFrame` / `uploadBudgetMsPerFrame`).
+    //            Pelo menos uma malha sobe por quadro. O restante fica para os próximos quadros,
+    //            e esses chunks continuam desenhando a malha anterior.
+    // Parâmetros:
+    //   - glFuncs: Ponteiro para as funções OpenGL (o contexto deve estar ativo).
+    void processUploadQueue(QOpenGLFunctions* glFuncs);
+
     // Membro: m_config
     // Tipo: const WorldConfig*
     // Descrição: Ponteiro constante para a configuração global do mundo.
-    const WorldConfig* m_config;
+    const WorldConfig* m_config = nullptr;
 
     // Membro: m_chunks
     // Tipo: std::vector<std::vector<chunk>>
     // Descrição: Uma matriz 2D (vetor de vetores) que armazena os objetos `chunk`
-    //            atualmente visíveis e sendo gerenciados. Representa a grade de chunks.
+    //            atualmente visíveis e sendo gerenciados. É endereçada de forma toroidal:
+    //            o chunk de coordenada (x, z) vive sempre em m_chunks[gridSlot(x)][gridSlot(z)].
     std::vector<std::vector<chunk>> m_chunks;
 
     // Membro: m_centerChunkX
@@ -107,6 +370,197 @@ private:
     // Descrição: A coordenada Z da grade do chunk que está atualmente no centro da grade de renderização.
     int m_centerChunkZ;
 
+    // Membro: m_activeHalfGrid
+    // Tipo: int
+    // Descrição: Metade do lado da área ativa (ver `setActiveGridSize`), em chunks.
+    int m_activeHalfGrid;
+
+    // Membro: m_lodDistanceScale
+    // Tipo: float
+    // Descrição: Multiplicador das faixas de LOD (ver `setLodDistanceScale`).
+    float m_lodDistanceScale;
+
+    // Membro: m_scheduler
+    // Tipo: TerrainJobScheduler
+    // Descrição: Fila de prioridade e threads próprias para os trabalhos de geração de malha.
+    //            A chave de cada trabalho é o slot (slotX * gridRenderSize + slotZ).
+    TerrainJobScheduler m_scheduler;
+
+    // Membro: m_indexBuffers
+    // Tipo: TerrainIndexBuffers
+    // Descrição: Um buffer de índices imutável por resolução (highRes e lowRes), compartilhado
+    //            pelos VAOs de todos os chunks. Criado em `init`, com o contexto OpenGL ativo.
+    TerrainIndexBuffers m_indexBuffers;
+
+    // Membro: m_bufferPool
+    // Tipo: TerrainBufferPool
+    // Descrição: VBOs livres, por tamanho, trocados entre chunks quando mudam de LOD.
+    //            Pré-alocado em `init` com buffers para as duas resoluções.
+    TerrainBufferPool m_bufferPool;
+
+    // Membro: m_batchBuffers
+    // Tipo: TerrainBatchBuffers
+    // Descrição: Páginas de vértices do desenho em lote (WorldConfig::batchedTerrainDraws):
+    //            os chunks de cada nível de LOD ocupam slots de poucos VBOs grandes, desenhados
+    //            com uma chamada por faixa de slots visíveis em vez de uma por chunk.
+    TerrainBatchBuffers m_batchBuffers;
+
+    // Membro: m_completions
+    // Tipo: std::unique_ptr<TerrainCompletionQueue>
+    // Descrição: Fila sem travas onde os workers entregam as malhas prontas. Criada em `init`,
+    //            com a capacidade de `WorldConfig::completionQueueCapacity`.
+    std::unique_ptr<TerrainCompletionQueue> m_completions;
+
+    // Membro: m_meshCache
+    // Tipo: TerrainMeshCache
+    // Descrição: Malhas já enviadas para a GPU, guardadas para quando o chunk voltar à grade.
+    TerrainMeshCache m_meshCache;
+
+    // Membro: m_demSource
+    // Tipo: std::unique_ptr<DemHeightSource>
+    // Descrição: O DEM do relevo real, aberto em `init` se `WorldConfig::terrainDemPath` estiver
+    //            definido. Nulo quando o terreno vem do ruído procedural.
+    std::unique_ptr<DemHeightSource> m_demSource;
+
+    // Membro: m_gnssSource
+    // Tipo: std::unique_ptr<GnssHeightSource>
+    // Descrição: O modelo de elevação construído com as altitudes do GNSS, criado em `init` se
+    //            `WorldConfig::gnssTerrainEnabled` e não houver DEM. Nulo caso contrário.
+    std::unique_ptr<GnssHeightSource> m_gnssSource;
+
+    // Membro: m_dirtyChunks
+    // Tipo: std::vector<std::pair<int, int>>
+    // Descrição: Chunks a regenerar neste quadro (reutilizado entre quadros, sem alocação).
+    std::vector<std::pair<int, int>> m_dirtyChunks;
+
+    // Membro: m_regeneratedChunks
+    // Tipo: int
+    // Descrição: Chunks regenerados por mudança de altura (diagnóstico).
+    int m_regeneratedChunks;
+
+    // Membro: m_trianglesLastFrame
+    // Tipo: int
+    // Descrição: Triângulos de terreno desenhados no último `render` (diagnóstico).
+    int m_trianglesLastFrame;
+
+    // Membro: m_lodSwitches
+    // Tipo: int
+    // Descrição: Trocas de nível de LOD pedidas (diagnóstico).
+    int m_lodSwitches;
+
+    // Membros: m_chunksDrawnLastFrame / m_chunksCulledLastFrame
+    // Tipo: int
+    // Descrição: Chunks desenhados / descartados pelo culling no último `render` (diagnóstico).
+    int m_chunksDrawnLastFrame;
+    int m_chunksCulledLastFrame;
+
+    // Membro: m_drawCallsLastFrame
+    // Tipo: int
+    // Descrição: Chamadas de desenho do terreno no último `render` (diagnóstico).
+    int m_drawCallsLastFrame;
+
+    // Membros: medição da ordem de desenho (WorldConfig::terrainDrawOrderBenchmarkFrames)
+    // Descrição: Quadros medidos, e o tempo total e o número de quadros de cada ordem
+    //            (índice 0: frente para trás; 1: ordem da grade).
+    int m_drawOrderBenchmarkFrame;
+    qint64 m_drawOrderBenchmarkNs[2];
+    int m_drawOrderBenchmarkSamples[2];
+
+    // Membros: medição do LOD (WorldConfig::terrainLodBenchmarkFrames)
+    // Descrição: Quadros e triângulos acumulados na janela, trocas de nível que chegaram à GPU
+    //            (total e com salto), a maior deformação que faltava numa troca (0 a 1) e, por
+    //            slot, se a malha pedida é de uma troca de nível (e não de uma reciclagem).
+    int m_lodBenchmarkFrame;
+    qint64 m_lodBenchmarkTriangles;
+    int m_lodBenchmarkSwaps;
+    int m_lodBenchmarkPops;
+    float m_lodBenchmarkWorstGap;
+    std::vector<char> m_lodSwapPending;
+
+    // Membro: m_drawList
+    // Tipo: std::vector<int>
+    // Descrição: Slots (slotX * gridRenderSize + slotZ) dos chunks visíveis, na ordem de desenho.
+    //            Os vetores auxiliares da ordenação são mantidos entre quadros, sem realocar.
+    std::vector<int> m_drawList;
+    std::vector<int> m_drawListScratch;
+    std::vector<int> m_drawListBins;
+    std::vector<int> m_drawListBinStart;
+
+    // Membro: m_deferredLodChunks
+    // Tipo: int
+    // Descrição: Chunks fora da tela com a troca de LOD adiada no último `update` (diagnóstico).
+    int m_deferredLodChunks;
+
+    // Membro: m_frustum
+    // Tipo: ViewFrustum
+    // Descrição: Volume de visão da câmera no último `update`, usado também pelo `render`.
+    ViewFrustum m_frustum;
+
+    // Membro: m_lodResolutions
+    // Tipo: std::vector<int>
+    // Descrição: Resolução (vértices por lado) de cada nível de LOD, do mais fino ao mais grosso.
+    std::vector<int> m_lodResolutions;
+
+    // Membro: m_morphRanges
+    // Tipo: QVector<QVector2D>
+    // Descrição: Faixa de morphing de cada nível: (distância de início, 1 / largura da faixa).
+    QVector<QVector2D> m_morphRanges;
+
+    // Membro: m_morphRatios
+    // Tipo: std::vector<int>
+    // Descrição: Quantas vezes o nível seguinte é mais grosso que cada nível (1 no último).
+    //            Usado pelo shader de heightmap, que calcula a altura de morphing.
+    std::vector<int> m_morphRatios;
+
+    // Membro: m_uploadQueue
+    // Tipo: std::vector<int>
+    // Descrição: Slots (slotX * gridRenderSize + slotZ) com malha pronta esperando upload.
+    std::vector<int> m_uploadQueue;
+
+    // Membro: m_lastCameraPos
+    // Tipo: QVector3D
+    // Descrição: Posição da câmera no último `update`, usada para ordenar a fila de uploads.
+    QVector3D m_lastCameraPos;
+
+    // Membro: m_queuedUploadBytes
+    // Tipo: qint64
+    // Descrição: Bytes ainda na fila de uploads após o último quadro (diagnóstico).
+    qint64 m_queuedUploadBytes;
+
+    // Membro: m_framesOverBudget
+    // Tipo: int
+    // Descrição: Quadros em que os uploads passaram do orçamento de tempo (diagnóstico).
+    int m_framesOverBudget;
+
+    // Membro: m_deferredUploadFrames
+    // Tipo: int
+    // Descrição: Quadros em que parte da fila de uploads foi adiada (diagnóstico).
+    int m_deferredUploadFrames;
+
+    // Membro: m_completionQueueDepth
+    // Tipo: int
+    // Descrição: Malhas que ficaram na fila de conclusão após o último `update` (diagnóstico).
+    int m_completionQueueDepth;
+
+    // Membro: m_maxCompletionQueueDepth
+    // Tipo: int
+    // Descrição: Maior profundidade da fila de conclusão observada (diagnóstico).
+    int m_maxCompletionQueueDepth;
+
+    // Membro: m_avgRequestToReadyMs
+    // Tipo: float
+    // Descrição: Média móvel da latência pedido -> malha pronta, em milissegundos (diagnóstico).
+    float m_avgRequestToReadyMs;
+
+    // Membro: m_avgReadyToUploadMs
+    // Tipo: float
+    // Descrição: Média móvel da latência malha pronta -> upload, em milissegundos (diagnóstico).
+    float m_avgReadyToUploadMs;
+
+    // Membro: m_statsTimer
+    // Tipo: QElapsedTimer
+    // Descrição: Janela do relatório periódico de métricas (`reportStats`).
+    QElapsedTimer m_statsTimer;
 
     // Membro: m_glFuncsRef
     // Tipo: QOpenGLFunctions*
@@ -114,13 +568,23 @@ private:
     //            Usado para realizar operações OpenGL dentro da classe.
     QOpenGLFunctions* m_glFuncsRef;
 
-    // Membro: LOD_HYSTERESIS_BUFFER
+    // Membro: LOD_HYSTERESIS_FRACTION
+    // Tipo: const float
+    // Descrição: Histerese da transição de LOD, como fração da distância de troca, para evitar
+    //            "trepidação" quando a câmera está exatamente no limite entre dois níveis.
+    //            O chunk só vai para o nível mais grosso além de limite * (1 + fração) e só
+    //            volta para o mais fino aquém de limite * (1 - fração).
+    const float LOD_HYSTERESIS_FRACTION = 0.1f;
+
+    // Membro: STATS_REPORT_INTERVAL_MS
+    // Tipo: const qint64
+    // Descrição: Intervalo entre os relatórios de métricas do terreno, em milissegundos.
+    const qint64 STATS_REPORT_INTERVAL_MS = 5000;
+
+    // Membro: LATENCY_SMOOTHING
     // Tipo: const float
-    // Descrição: Um valor de buffer usado na lógica de transição de LOD para evitar
-    //            "trepidação" visual quando a câmera está exatamente na distância de transição.
-    //            Ele cria uma pequena zona de histerese, onde o LOD só muda se a distância
-    //            cruzar o limite mais o buffer.
-    const float LOD_HYSTERESIS_BUFFER = 5.0f;
+    // Descrição: Peso de cada nova amostra nas médias móveis de latência.
+    const float LATENCY_SMOOTHING = 0.1f;
 };
 
 #endif // TERRAINMANAGER_H
@@ -0,0 +1,123 @@
+#include "terrainmeshcache.h" // Inclui o cabeçalho da classe TerrainMeshCache.
+
+/**
+ * @brief Define o limite de memória do cache.
+ * @param budgetBytes Limite em bytes (0 desativa o cache e descarta tudo).
+ */
+void TerrainMeshCache::setBudgetBytes(qint64 budgetBytes)
+{
+    m_budgetBytes = qMax<qint64>(0, budgetBytes);
+    evictToBudget();
+}
+
+/**
+ * @brief Retira do cache a malha de um chunk em uma resolução.
+ * @param chunkX Coordenada X do chunk.
+ * @param chunkZ Coordenada Z do chunk.
+ * @param resolution Resolução da malha.
+ * @return A malha, ou nulo se não estiver no cache.
+ *
+ * A posse da malha passa para quem chamou; a entrada é removida do cache.
+ */
+chunk::MeshDataPtr TerrainMeshCache::take(int chunkX, int chunkZ, int resolution)
+{
+    auto found = m_index.find({chunkX, chunkZ, resolution});
+    if (found == m_index.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    chunk::MeshDataPtr mesh = std::move(found->second->mesh);
+    erase(found->second);
+    return mesh;
+}
+
+/**
+ * @brief Guarda uma malha como a mais recente.
+ * @param mesh A malha, movida para o cache.
+ *
+ * Uma malha maior que o limite inteiro do cache não é guardada.
+ */
+void TerrainMeshCache::insert(chunk::MeshData&& mesh)
+{
+    if (!enabled()) {
+        return;
+    }
+    const Key key{mesh.chunkGridX, mesh.chunkGridZ, mesh.resolution};
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        erase(found->second);
+    }
+
+    const qint64 size = footprintBytes(mesh);
+    if (size > m_budgetBytes) {
+        return;
+    }
+    m_lru.push_front({key, std::make_unique<chunk::MeshData>(std::move(mesh)), size});
+    m_index.emplace(key, m_lru.begin());
+    m_bytes += size;
+    evictToBudget();
+}
+
+/**
+ * @brief Descarta as malhas de um chunk em todas as resoluções.
+ * @param chunkX Coordenada X do chunk.
+ * @param chunkZ Coordenada Z do chunk.
+ */
+void TerrainMeshCache::invalidate(int chunkX, int chunkZ)
+{
+    for (auto it = m_lru.begin(); it != m_lru.end();) {
+        if (it->key.chunkX == chunkX && it->key.chunkZ == chunkZ) {
+            it = erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Descarta todas as malhas guardadas.
+ */
+void TerrainMeshCache::clear()
+{
+    m_lru.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+/**
+ * @brief Estima a memória ocupada por uma malha.
+ * @param mesh A malha.
+ *
+ * Usa a capacidade (não o tamanho) dos vetores, que é o que de fato está alocado.
+ */
+qint64 TerrainMeshCache::footprintBytes(const chunk::MeshData& mesh)
+{
+    return static_cast<qint64>(sizeof(chunk::MeshData))
+        + static_cast<qint64>(mesh.vertices.capacity() * sizeof(Vertex))
+        + static_cast<qint64>(mesh.compactVertices.capacity() * sizeof(CompactVertex))
+        + static_cast<qint64>(mesh.heights.capacity() * sizeof(float));
+}
+
+/**
+ * @brief Remove uma entrada do cache.
+ * @param it A entrada em `m_lru`.
+ * @return A entrada seguinte.
+ */
+std::list<TerrainMeshCache::Entry>::iterator TerrainMeshCache::erase(std::list<Entry>::iterator it)
+{
+    m_bytes -= it->bytes;
+    m_index.erase(it->key);
+    return m_lru.erase(it);
+}
+
+/**
+ * @brief Descarta as entradas menos usadas até a memória caber no limite.
+ */
+void TerrainMeshCache::evictToBudget()
+{
+    while (!m_lru.empty() && m_bytes > m_budgetBytes) {
+        erase(std::prev(m_lru.end()));
+        ++m_evictions;
+    }
+}
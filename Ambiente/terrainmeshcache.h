@@ -0,0 +1,172 @@
+#ifndef TERRAINMESHCACHE_H
+#define TERRAINMESHCACHE_H
+
+#include "chunk.h"          // Para chunk::MeshData e chunk::MeshDataPtr, os itens guardados.
+#include <list>             // Para a ordem de uso (LRU) das entradas.
+#include <unordered_map>    // Para localizar uma entrada pela chave (x, z, resolução).
+
+// Classe: TerrainMeshCache
+// Descrição: Cache LRU, limitado por memória, de malhas de terreno já geradas, indexado por
+//            (chunkX, chunkZ, resolução). No trabalho de campo o trator faz passadas de ida
+//            e volta: um chunk que sai da grade em uma cabeceira volta segundos depois na
+//            passada seguinte. Com o cache, a malha é reaproveitada em vez de gerada de novo
+//            por um `ChunkWorker`. As malhas entram no cache depois do upload para a GPU
+//            (por movimento, sem cópia) e saem dele quando são reaproveitadas.
+//            Deve ser usada apenas na thread principal.
+class TerrainMeshCache {
+public:
+    TerrainMeshCache() = default;
+
+    // Impedir Cópias (Deletadas): as entradas são de posse única.
+    TerrainMeshCache(const TerrainMeshCache&) = delete;
+    TerrainMeshCache& operator=(const TerrainMeshCache&) = delete;
+
+    // Método: setBudgetBytes
+    // Descrição: Define o limite de memória do cache, descartando as entradas menos usadas
+    //            se necessário. Com 0, o cache fica desativado.
+    // Parâmetros:
+    //   - budgetBytes: Limite, em bytes, da memória ocupada pelas malhas guardadas.
+    void setBudgetBytes(qint64 budgetBytes);
+
+    // Método: enabled
+    // Descrição: Indica se o cache tem orçamento de memória (está ativo).
+    // Retorno: bool - true se o limite é maior que zero.
+    bool enabled() const { return m_budgetBytes > 0; }
+
+    // Método: take
+    // Descrição: Retira do cache a malha de um chunk em uma resolução, se existir.
+    //            A entrada sai do cache; ela volta quando a malha for enviada de novo para a GPU.
+    // Parâmetros:
+    //   - chunkX: Coordenada X do chunk.
+    //   - chunkZ: Coordenada Z do chunk.
+    //   - resolution: Resolução da malha.
+    // Retorno: chunk::MeshDataPtr - A malha (acerto), ou nulo (falha).
+    chunk::MeshDataPtr take(int chunkX, int chunkZ, int resolution);
+
+    // Método: insert
+    // Descrição: Guarda uma malha como a mais recente, substituindo a de mesma chave, e
+    //            descarta as menos usadas até respeitar o limite de memória.
+    // Parâmetros:
+    //   - mesh: A malha (movida para o cache).
+    void insert(chunk::MeshData&& mesh);
+
+    // Método: invalidate
+    // Descrição: Descarta as malhas de um chunk em todas as resoluções (por exemplo, quando
+    //            as alturas daquela área mudam).
+    // Parâmetros:
+    //   - chunkX: Coordenada X do chunk.
+    //   - chunkZ: Coordenada Z do chunk.
+    void invalidate(int chunkX, int chunkZ);
+
+    // Método: clear
+    // Descrição: Descarta todas as malhas guardadas.
+    void clear();
+
+    // Método: hits
+    // Descrição: Retorna quantas vezes uma malha pedida estava no cache (diagnóstico).
+    // Retorno: int - Total acumulado de acertos.
+    int hits() const { return m_hits; }
+
+    // Método: misses
+    // Descrição: Retorna quantas vezes uma malha pedida não estava no cache (diagnóstico).
+    // Retorno: int - Total acumulado de falhas.
+    int misses() const { return m_misses; }
+
+    // Método: evictions
+    // Descrição: Retorna quantas malhas foram descartadas para respeitar o limite (diagnóstico).
+    // Retorno: int - Total acumulado de descartes.
+    int evictions() const { return m_evictions; }
+
+    // Método: bytes
+    // Descrição: Retorna a memória ocupada pelas malhas guardadas.
+    // Retorno: qint64 - Bytes.
+    qint64 bytes() const { return m_bytes; }
+
+    // Método: entries
+    // Descrição: Retorna quantas malhas estão guardadas.
+    // Retorno: int - Número de entradas.
+    int entries() const { return static_cast<int>(m_lru.size()); }
+
+    // Método Estático: footprintBytes
+    // Descrição: Estima a memória ocupada por uma malha (capacidade dos vetores + a estrutura).
+    // Parâmetros:
+    //   - mesh: A malha.
+    // Retorno: qint64 - Bytes.
+    static qint64 footprintBytes(const chunk::MeshData& mesh);
+
+private:
+    // Estrutura: Key
+    // Descrição: Chave de uma entrada: coordenadas do chunk e resolução da malha.
+    struct Key {
+        int chunkX;
+        int chunkZ;
+        int resolution;
+        bool operator==(const Key& other) const {
+            return chunkX == other.chunkX && chunkZ == other.chunkZ && resolution == other.resolution;
+        }
+    };
+
+    // Estrutura: KeyHash
+    // Descrição: Função de hash da chave, para o std::unordered_map.
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            size_t h = static_cast<size_t>(static_cast<quint32>(key.chunkX)) * 73856093u;
+            h ^= static_cast<size_t>(static_cast<quint32>(key.chunkZ)) * 19349663u;
+            h ^= static_cast<size_t>(static_cast<quint32>(key.resolution)) * 83492791u;
+            return h;
+        }
+    };
+
+    // Estrutura: Entry
+    // Descrição: Uma malha guardada, com sua chave e a memória que ocupa.
+    struct Entry {
+        Key key;
+        chunk::MeshDataPtr mesh;
+        qint64 bytes;
+    };
+
+    // Método Privado: erase
+    // Descrição: Remove uma entrada do cache e desconta sua memória.
+    std::list<Entry>::iterator erase(std::list<Entry>::iterator it);
+
+    // Método Privado: evictToBudget
+    // Descrição: Descarta as entradas menos usadas até a memória caber no limite.
+    void evictToBudget();
+
+    // Membro: m_lru
+    // Tipo: std::list<Entry>
+    // Descrição: As entradas, da mais recente (início) para a menos usada (fim).
+    std::list<Entry> m_lru;
+
+    // Membro: m_index
+    // Tipo: std::unordered_map<Key, std::list<Entry>::iterator, KeyHash>
+    // Descrição: Localiza a entrada de uma chave em `m_lru`.
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+
+    // Membro: m_budgetBytes
+    // Tipo: qint64
+    // Descrição: Limite de memória do cache (0 = desativado).
+    qint64 m_budgetBytes = 0;
+
+    // Membro: m_bytes
+    // Tipo: qint64
+    // Descrição: Memória ocupada pelas entradas.
+    qint64 m_bytes = 0;
+
+    // Membro: m_hits
+    // Tipo: int
+    // Descrição: Total de acertos.
+    int m_hits = 0;
+
+    // Membro: m_misses
+    // Tipo: int
+    // Descrição: Total de falhas.
+    int m_misses = 0;
+
+    // Membro: m_evictions
+    // Tipo: int
+    // Descrição: Total de descartes por limite de memória.
+    int m_evictions = 0;
+};
+
+#endif // TERRAINMESHCACHE_H
@@ -0,0 +1,111 @@
+#include <QCoreApplication> // Para os argumentos da linha de comando.
+#include <QElapsedTimer>    // Para cronometrar cada kernel.
+#include <QThread>          // Para a medição com todos os núcleos (QThread::create).
+#include <QStringList>      // Para os argumentos.
+#include <QDebug>           // Para o relatório (qInfo).
+#include <atomic>           // Para somar as amostras das threads.
+#include <memory>           // Para std::unique_ptr (threads da medição com todos os núcleos).
+#include <vector>           // Para as linhas de alturas.
+#include "noiseutils.h"     // O motor de alturas medido.
+
+// Medição de desempenho do motor de alturas em lote (NoiseUtils::getHeightRow).
+//
+// Uso: bench_noise [oitavas] [vértices por linha] [milissegundos por medição]
+//      (padrão: 4 oitavas, 67 vértices, 1000 ms: a linha da grade de um chunk no LOD 0)
+//
+// Para cada kernel compilado e suportado pelo processador (e a referência escalar), avalia
+// linhas da grade de um chunk, como `chunk::generateMeshData`, e informa:
+//   - Msamples/s em uma thread (o número por núcleo);
+//   - Msamples/s com uma thread por núcleo (QThread::idealThreadCount), no total e por núcleo,
+//     que mostra a perda por frequência, memória ou temperatura quando todos trabalham.
+
+namespace {
+
+// Variável: g_sink
+// Descrição: Recebe uma altura de cada medição, para que o compilador não descarte as avaliações.
+volatile float g_sink = 0.0f;
+
+// Função: runRows
+// Descrição: Avalia linhas sucessivas com o kernel de `level` até passar `durationMs`.
+// Retorno: qint64 - Alturas calculadas.
+qint64 runRows(NoiseUtils::SimdLevel level, int rowLength, qint64 durationMs, float originZ)
+{
+    std::vector<float> heights(static_cast<size_t>(rowLength));
+    const float step = 1.0f;
+    qint64 samples = 0;
+    float worldZ = originZ;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < durationMs) {
+        for (int row = 0; row < 64; ++row) {
+            NoiseUtils::getHeightRowWith(level, -33.0f, step, worldZ, rowLength, heights.data());
+            worldZ += step;
+        }
+        samples += 64 * static_cast<qint64>(rowLength);
+    }
+    g_sink = heights[0];
+    return samples;
+}
+
+// Função: measure
+// Descrição: Mede um kernel com `threads` threads.
+// Retorno: double - Msamples/s somados de todas as threads.
+double measure(NoiseUtils::SimdLevel level, int threads, int rowLength, qint64 durationMs)
+{
+    std::atomic<qint64> samples(0);
+    QElapsedTimer wall;
+    wall.start();
+    if (threads == 1) {
+        samples = runRows(level, rowLength, durationMs, 0.0f);
+    } else {
+        std::vector<std::unique_ptr<QThread>> workers;
+        for (int t = 0; t < threads; ++t) {
+            const float originZ = 10000.0f * static_cast<float>(t); // Cada thread em outra faixa do terreno.
+            workers.emplace_back(QThread::create([&samples, level, rowLength, durationMs, originZ]() {
+                samples += runRows(level, rowLength, durationMs, originZ);
+            }));
+            workers.back()->start();
+        }
+        for (auto& worker : workers) {
+            worker->wait();
+        }
+    }
+    return samples.load() / (wall.nsecsElapsed() / 1.0e9) / 1.0e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int octaves = args.size() > 1 ? args.at(1).toInt() : 4;
+    const int rowLength = args.size() > 2 ? args.at(2).toInt() : 67;
+    const qint64 durationMs = args.size() > 3 ? args.at(3).toLongLong() : 1000;
+    const int cores = qMax(1, QThread::idealThreadCount());
+
+    NoiseUtils::NoiseParams params;
+    params.octaves = octaves;
+    params.amplitude = 10.0f; // Amplitude 0 pularia o ruído (terreno plano).
+    NoiseUtils::configure(params);
+
+    qInfo().noquote() << QString("Motor de alturas: %1 oitavas, linhas de %2 vértices, %3 ms por medição, %4 núcleos")
+                             .arg(NoiseUtils::params().octaves).arg(rowLength).arg(durationMs).arg(cores);
+    qInfo().noquote() << QString("Kernel detectado: %1").arg(NoiseUtils::simdLevelName(NoiseUtils::activeSimdLevel()));
+    qInfo().noquote() << "kernel   Msamples/s (1 thread)   Msamples/s (todos: total / por núcleo)";
+
+    for (NoiseUtils::SimdLevel level : {NoiseUtils::SimdLevel::Scalar, NoiseUtils::SimdLevel::Sse41,
+                                        NoiseUtils::SimdLevel::Avx2, NoiseUtils::SimdLevel::Neon}) {
+        if (!NoiseUtils::isSimdLevelAvailable(level)) {
+            continue;
+        }
+        const double single = measure(level, 1, rowLength, durationMs);
+        const double all = measure(level, cores, rowLength, durationMs);
+        qInfo().noquote() << QString("%1 %2 %3 / %4")
+                                 .arg(NoiseUtils::simdLevelName(level), -8)
+                                 .arg(single, 22, 'f', 1)
+                                 .arg(all, 25, 'f', 1)
+                                 .arg(all / cores, 0, 'f', 1);
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+# Medição de desempenho do motor de alturas: Msamples/s por núcleo de cada kernel em lote.
+# Não roda no `make check`; executar o binário diretamente (ver bench_noise.cpp).
+
+QT -= gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = bench_noise
+
+include(../noiseutils.pri)
+
+SOURCES += \
+    bench_noise.cpp
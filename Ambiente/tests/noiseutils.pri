@@ -0,0 +1,13 @@
+# Motor de alturas (NoiseUtils) compilado fora do aplicativo, para o teste dos kernels em lote
+# e a medição de desempenho. Usa as mesmas opções do Ambiente.pro (C++17, -O2 do qmake).
+
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    $$PWD/../noiseutils.cpp
+
+HEADERS += \
+    $$PWD/../heightsource.h \
+    $$PWD/../noiseutils.h
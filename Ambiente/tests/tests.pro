@@ -0,0 +1,8 @@
+# Testes e medições das partes do Ambiente que rodam sem OpenGL nem hardware.
+# Uso: qmake tests.pro && make && make check (testes) e ./bench_noise/bench_noise (medição)
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench_noise \
+    tst_noisekernels
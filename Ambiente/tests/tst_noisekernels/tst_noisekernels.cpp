@@ -0,0 +1,162 @@
+#include <QtTest>        // Para QTest, QVERIFY2 e QTEST_APPLESS_MAIN.
+#include <vector>        // Para os vetores de coordenadas e alturas.
+#include <cmath>         // Para std::fabs.
+#include "noiseutils.h"  // O motor de alturas testado.
+
+// Classe: TestNoiseKernels
+// Descrição: Compara cada kernel vetorizado compilado neste binário (e suportado pelo
+//            processador) com a referência escalar, em linhas e em lotes de coordenadas
+//            arbitrárias, com vários parâmetros de ruído e tamanhos de lote que não são
+//            múltiplos da largura do vetor (o resto do laço também é conferido).
+class TestNoiseKernels : public QObject {
+    Q_OBJECT
+
+private:
+    // Método Privado: availableLevels
+    // Descrição: Os níveis vetorizados disponíveis (o escalar é a referência, não é testado).
+    QList<NoiseUtils::SimdLevel> availableLevels() const;
+
+    // Método Privado: tolerance
+    // Descrição: Erro máximo aceito: 1e-5 da soma das amplitudes das oitavas. As diferenças
+    //            vêm só da ordem das operações (FMA nos kernels AVX2 e NEON).
+    float tolerance(const NoiseUtils::NoiseParams& params) const;
+
+private slots:
+    void cleanup();
+    void heightRowMatchesScalar_data();
+    void heightRowMatchesScalar();
+    void heightsMatchScalar_data();
+    void heightsMatchScalar();
+    void flatTerrainIsZero();
+};
+
+QList<NoiseUtils::SimdLevel> TestNoiseKernels::availableLevels() const
+{
+    QList<NoiseUtils::SimdLevel> levels;
+    for (NoiseUtils::SimdLevel level : {NoiseUtils::SimdLevel::Sse41, NoiseUtils::SimdLevel::Avx2,
+                                        NoiseUtils::SimdLevel::Neon}) {
+        if (NoiseUtils::isSimdLevelAvailable(level)) {
+            levels.append(level);
+        }
+    }
+    return levels;
+}
+
+float TestNoiseKernels::tolerance(const NoiseUtils::NoiseParams& params) const
+{
+    float amplitudeSum = 0.0f;
+    float amplitude = params.amplitude;
+    for (int o = 0; o < params.octaves; ++o) {
+        amplitudeSum += std::fabs(amplitude);
+        amplitude *= params.gain;
+    }
+    return 1.0e-5f * amplitudeSum;
+}
+
+void TestNoiseKernels::cleanup()
+{
+    NoiseUtils::configure(NoiseUtils::NoiseParams());
+}
+
+void TestNoiseKernels::heightRowMatchesScalar_data()
+{
+    QTest::addColumn<int>("octaves");
+    QTest::addColumn<float>("amplitude");
+    QTest::addColumn<float>("originX");
+    QTest::addColumn<float>("originZ");
+
+    QTest::newRow("1 oitava, origem") << 1 << 10.0f << 0.0f << 0.0f;
+    QTest::newRow("4 oitavas, negativos") << 4 << 10.0f << -1234.5f << -987.25f;
+    QTest::newRow("8 oitavas, longe da origem") << 8 << 25.0f << 15000.0f << -15000.0f;
+}
+
+void TestNoiseKernels::heightRowMatchesScalar()
+{
+    QFETCH(int, octaves);
+    QFETCH(float, amplitude);
+    QFETCH(float, originX);
+    QFETCH(float, originZ);
+
+    NoiseUtils::NoiseParams params;
+    params.octaves = octaves;
+    params.amplitude = amplitude;
+    NoiseUtils::configure(params);
+
+    const QList<NoiseUtils::SimdLevel> levels = availableLevels();
+    if (levels.isEmpty()) {
+        QSKIP("Nenhum kernel vetorizado disponível neste processador.");
+    }
+    for (NoiseUtils::SimdLevel level : levels) {
+        for (int count : {1, 7, 33, 67, 257}) {
+            std::vector<float> expected(count), actual(count);
+            for (int row = 0; row < 20; ++row) {
+                const float startX = originX - 3.3f + row * 0.71f;
+                const float worldZ = originZ + row * 3.7f;
+                NoiseUtils::getHeightRowScalar(startX, 0.37f, worldZ, count, expected.data());
+                NoiseUtils::getHeightRowWith(level, startX, 0.37f, worldZ, count, actual.data());
+                for (int i = 0; i < count; ++i) {
+                    const float error = std::fabs(actual[i] - expected[i]);
+                    QVERIFY2(error <= tolerance(params),
+                             qPrintable(QString("%1: erro %2 no ponto %3 de %4 (limite %5)")
+                                            .arg(NoiseUtils::simdLevelName(level)).arg(error).arg(i).arg(count)
+                                            .arg(tolerance(params))));
+                }
+            }
+        }
+    }
+}
+
+void TestNoiseKernels::heightsMatchScalar_data()
+{
+    heightRowMatchesScalar_data();
+}
+
+void TestNoiseKernels::heightsMatchScalar()
+{
+    QFETCH(int, octaves);
+    QFETCH(float, amplitude);
+    QFETCH(float, originX);
+    QFETCH(float, originZ);
+
+    NoiseUtils::NoiseParams params;
+    params.octaves = octaves;
+    params.amplitude = amplitude;
+    NoiseUtils::configure(params);
+
+    const QList<NoiseUtils::SimdLevel> levels = availableLevels();
+    if (levels.isEmpty()) {
+        QSKIP("Nenhum kernel vetorizado disponível neste processador.");
+    }
+    for (NoiseUtils::SimdLevel level : levels) {
+        for (int count : {1, 7, 33, 67, 257}) {
+            std::vector<float> worldX(count), worldZ(count), expected(count), actual(count);
+            for (int i = 0; i < count; ++i) {
+                worldX[i] = originX + i * 1.77f;
+                worldZ[i] = originZ - i * 0.51f;
+            }
+            NoiseUtils::getHeightsScalar(worldX.data(), worldZ.data(), count, expected.data());
+            NoiseUtils::getHeightsWith(level, worldX.data(), worldZ.data(), count, actual.data());
+            for (int i = 0; i < count; ++i) {
+                const float error = std::fabs(actual[i] - expected[i]);
+                QVERIFY2(error <= tolerance(params),
+                         qPrintable(QString("%1: erro %2 no ponto %3 de %4 (limite %5)")
+                                        .arg(NoiseUtils::simdLevelName(level)).arg(error).arg(i).arg(count)
+                                        .arg(tolerance(params))));
+            }
+        }
+    }
+}
+
+void TestNoiseKernels::flatTerrainIsZero()
+{
+    NoiseUtils::configure(NoiseUtils::NoiseParams()); // Amplitude 0: terreno plano.
+    std::vector<float> heights(67, 1.0f);
+    NoiseUtils::getHeightRow(-10.0f, 0.5f, 3.0f, 67, heights.data());
+    for (float height : heights) {
+        QCOMPARE(height, 0.0f);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestNoiseKernels)
+
+#include "tst_noisekernels.moc"
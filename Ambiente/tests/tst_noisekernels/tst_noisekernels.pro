@@ -0,0 +1,13 @@
+QT += testlib
+QT -= gui
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = tst_noisekernels
+
+include(../noiseutils.pri)
+
+SOURCES += \
+    tst_noisekernels.cpp
@@ -0,0 +1,54 @@
+#include "thermalsource.h"
+#include <QFile>        // Para abrir o arquivo de temperatura.
+#include <QTextStream>  // Para ler a linha com o valor.
+
+/**
+ * @brief Construtor: guarda o caminho do arquivo de temperatura.
+ * @param path O arquivo (ex.: /sys/class/thermal/thermal_zone0/temp).
+ */
+SysfsThermalSource::SysfsThermalSource(const QString& path)
+    : m_path(path)
+{
+}
+
+/**
+ * @brief Lê a temperatura do arquivo.
+ * @param celsius Recebe a temperatura em graus Celsius.
+ * @param error Recebe a descrição da falha (opcional).
+ * @return true se o arquivo foi aberto e o conteúdo é um número.
+ *
+ * O arquivo é reaberto a cada leitura: no sysfs o valor só é atualizado em uma nova leitura
+ * desde o início do arquivo.
+ */
+bool SysfsThermalSource::readCelsius(float* celsius, QString* error)
+{
+    QFile tempFile(m_path);
+    if (!tempFile.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("Não foi possível abrir o arquivo de temperatura em: %1").arg(m_path);
+        }
+        return false;
+    }
+
+    QTextStream in(&tempFile);
+    const QString line = in.readLine();
+    tempFile.close();
+    if (line.trimmed().isEmpty()) {
+        if (error) {
+            *error = QString("Arquivo de temperatura esta vazio: %1").arg(m_path);
+        }
+        return false;
+    }
+
+    bool ok = false;
+    // O valor do arquivo é em miliCelsius.
+    const float value = line.toFloat(&ok) / 1000.0f;
+    if (!ok) {
+        if (error) {
+            *error = QString("Não foi possível converter o conteúdo '%1' para número").arg(line);
+        }
+        return false;
+    }
+    *celsius = value;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef THERMALSOURCE_H
+#define THERMALSOURCE_H
+
+#include <QString>   // Caminho do arquivo e mensagem de erro.
+
+// Classe: ThermalSource
+// Descrição: Interface de uma fonte de temperatura do SoC, lida periodicamente pelo
+//            QualityGovernor. Separada do governador para que ele possa ser exercitado com outra
+//            fonte (um arquivo no formato do sysfs escrito à mão, por exemplo) em vez do sensor.
+class ThermalSource {
+public:
+    virtual ~ThermalSource() = default;
+
+    // Método: readCelsius
+    // Descrição: Lê a temperatura atual.
+    // Parâmetros:
+    //   - celsius: Recebe a temperatura, em graus Celsius (só é escrito em caso de sucesso).
+    //   - error: Se não for nulo, recebe a descrição da falha.
+    // Retorno: bool - true se a leitura funcionou.
+    virtual bool readCelsius(float* celsius, QString* error) = 0;
+};
+
+// Classe: SysfsThermalSource
+// Descrição: Lê a temperatura de um arquivo no formato de /sys/class/thermal/thermal_zoneN/temp:
+//            uma linha com um inteiro em milésimos de grau Celsius. Qualquer arquivo nesse
+//            formato serve (WorldConfig::thermalZonePath), o que permite simular o aquecimento.
+class SysfsThermalSource : public ThermalSource {
+public:
+    // Construtor: SysfsThermalSource
+    // Parâmetros:
+    //   - path: O arquivo de temperatura.
+    explicit SysfsThermalSource(const QString& path);
+
+    bool readCelsius(float* celsius, QString* error) override;
+
+    // Método: path
+    // Descrição: Retorna o arquivo lido.
+    const QString& path() const { return m_path; }
+
+private:
+    // Membro: m_path
+    // Tipo: QString
+    // Descrição: O arquivo de temperatura.
+    QString m_path;
+};
+
+#endif // THERMALSOURCE_H
@@ -0,0 +1,251 @@
+#include "tractorsimulation.h"
+#include "logger.h"     // Para MY_LOG_INFO.
+#include <QMutexLocker> // Para travar o mutex do filtro com RAII.
+#include <QVector2D>    // Posição prevista e velocidade do filtro.
+#include <QtMath>       // Para qAtan2 e qRadiansToDegrees.
+#include <algorithm>    // Para std::clamp, std::max e std::min.
+#include <cstring>      // Para std::memcpy (estado <-> palavras do seqlock).
+#include <type_traits>  // Para std::is_trivially_copyable.
+
+static_assert(std::is_trivially_copyable<TractorState>::value, "TractorState é copiado palavra a palavra pelo seqlock");
+static_assert(sizeof(TractorState) % sizeof(quint32) == 0, "TractorState deve ocupar palavras inteiras de 32 bits");
+
+/**
+ * @brief Construtor: define o passo e zera o estado publicado (inválido até a primeira medição).
+ * @param rateHz Passos da simulação por segundo.
+ * @param parent O objeto pai.
+ */
+TractorSimulation::TractorSimulation(int rateHz, QObject* parent)
+    : QThread(parent),
+    m_stepNs(1000000000LL / std::max(rateHz, 1)), // Duração de um passo.
+    m_sequence(0)
+{
+    for (std::atomic<quint32>& word : m_words) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    m_clock.start();
+}
+
+/**
+ * @brief Destrutor: encerra a thread antes de destruir o filtro.
+ */
+TractorSimulation::~TractorSimulation()
+{
+    stop();
+}
+
+/**
+ * @brief Pede o fim do laço e espera a thread terminar.
+ *
+ * Usa o pedido de interrupção do QThread, que vale mesmo se a thread ainda não entrou em run().
+ */
+void TractorSimulation::stop()
+{
+    requestInterruption();
+    wait();
+}
+
+/**
+ * @brief Entrega uma medição GPS ao filtro.
+ * @param x Posição medida no mundo (X).
+ * @param z Posição medida no mundo (Z).
+ *
+ * A extrapolação da simulação recomeça a contar desta medição.
+ */
+void TractorSimulation::addMeasurement(double x, double z)
+{
+    QMutexLocker locker(&m_filterMutex);
+    m_filter.updateWithMeasurement(x, z);
+    m_measurementTimer.start();
+}
+
+/**
+ * @brief Troca o perfil do filtro.
+ * @param profile As novas incertezas de medição e de processo.
+ */
+void TractorSimulation::setFilterProfile(const FilterProfile& profile)
+{
+    QMutexLocker locker(&m_filterMutex);
+    m_filter.setProfile(profile);
+}
+
+/**
+ * @brief Reinicia o filtro em uma posição.
+ * @param x Posição no mundo (X).
+ * @param z Posição no mundo (Z).
+ */
+void TractorSimulation::resetFilter(double x, double z)
+{
+    QMutexLocker locker(&m_filterMutex);
+    m_filter.reset(x, z);
+    m_measurementTimer.start();
+}
+
+/**
+ * @brief Retorna o estado mais recente publicado.
+ * @return TractorState O estado atual do último passo.
+ */
+TractorState TractorSimulation::latestState() const
+{
+    return readPair().current;
+}
+
+/**
+ * @brief Interpola o estado do trator para o instante do quadro.
+ * @return TractorState O estado interpolado.
+ *
+ * O instante renderizado fica um passo atrás do relógio: assim ele cai entre os dois últimos
+ * estados publicados e o movimento é suave mesmo que a taxa de quadros e a da simulação não
+ * coincidam. Se a simulação atrasar, o fator é limitado a 1 (o estado mais recente).
+ */
+TractorState TractorSimulation::interpolatedState() const
+{
+    const StatePair pair = readPair();
+    if (!pair.current.valid || !pair.previous.valid || pair.current.timeNs <= pair.previous.timeNs) {
+        return pair.current;
+    }
+
+    const qint64 renderTimeNs = nowNs() - (pair.current.timeNs - pair.previous.timeNs);
+    const float alpha = std::clamp(static_cast<float>(renderTimeNs - pair.previous.timeNs) /
+                                       static_cast<float>(pair.current.timeNs - pair.previous.timeNs), 0.0f, 1.0f);
+    auto lerp = [alpha](float a, float b) { return a + (b - a) * alpha; };
+
+    TractorState state = pair.current;
+    state.timeNs = pair.previous.timeNs + static_cast<qint64>((pair.current.timeNs - pair.previous.timeNs) * alpha);
+    state.x = lerp(pair.previous.x, pair.current.x);
+    state.z = lerp(pair.previous.z, pair.current.z);
+    state.velocityX = lerp(pair.previous.velocityX, pair.current.velocityX);
+    state.velocityZ = lerp(pair.previous.velocityZ, pair.current.velocityZ);
+    state.speed = lerp(pair.previous.speed, pair.current.speed);
+    // Rumo pelo menor arco (ex.: de 179° para -179° passa por 180°, não por 0°).
+    float rotationDelta = pair.current.rotation - pair.previous.rotation;
+    if (rotationDelta > 180.0f) rotationDelta -= 360.0f;
+    if (rotationDelta < -180.0f) rotationDelta += 360.0f;
+    state.rotation = pair.previous.rotation + rotationDelta * alpha;
+    return state;
+}
+
+/**
+ * @brief Laço de passo fixo da simulação.
+ *
+ * Os passos seguem uma grade de tempo absoluta (próximo passo = anterior + m_stepNs), então o
+ * atraso de um passo não se acumula. Se a thread ficar vários passos atrasada (ex.: sistema
+ * sobrecarregado), a grade é realinhada ao relógio em vez de executar os passos perdidos em rajada.
+ */
+void TractorSimulation::run()
+{
+    MY_LOG_INFO("Simulation", QString("Thread da simulação iniciada (%1 passos/s).").arg(1000000000LL / m_stepNs));
+
+    StatePair pair = readPair();
+    quint32 tick = pair.current.tick;
+    qint64 nextStepNs = nowNs();
+
+    while (!isInterruptionRequested()) {
+        pair.previous = pair.current;
+        pair.current = step(pair.previous, ++tick);
+        publish(pair);
+
+        nextStepNs += m_stepNs;
+        const qint64 remainingNs = nextStepNs - nowNs();
+        if (remainingNs > 0) {
+            QThread::usleep(static_cast<unsigned long>(remainingNs / 1000));
+        } else if (-remainingNs > 4 * m_stepNs) {
+            nextStepNs = nowNs(); // Atraso grande: realinha em vez de recuperar os passos perdidos.
+        }
+    }
+
+    MY_LOG_INFO("Simulation", "Thread da simulação encerrada.");
+}
+
+/**
+ * @brief Executa um passo: predição do filtro e cinemática do trator.
+ * @param previous O estado do passo anterior (rumo mantido quando o trator está parado).
+ * @param tick O número do novo passo.
+ * @return TractorState O novo estado.
+ *
+ * A posição é extrapolada a partir da última estimativa do filtro pelo tempo desde a medição,
+ * limitado a MAX_EXTRAPOLATION_MS.
+ */
+TractorState TractorSimulation::step(const TractorState& previous, quint32 tick)
+{
+    TractorState state;
+    state.tick = tick;
+    state.rotation = previous.rotation;
+
+    {
+        QMutexLocker locker(&m_filterMutex);
+        if (m_filter.isInitialized()) {
+            const qint64 sinceMeasurementMs = std::min(m_measurementTimer.elapsed(), MAX_EXTRAPOLATION_MS);
+            const QVector2D position = m_filter.predictSmoothPosition(sinceMeasurementMs / 1000.0);
+            const QVector2D velocity = m_filter.getStateVelocity();
+            const Eigen::VectorXd& probabilities = m_filter.getModeProbabilities();
+
+            state.valid = 1;
+            state.x = position.x();
+            state.z = position.y();
+            state.velocityX = velocity.x();
+            state.velocityZ = velocity.y();
+            state.straightProbability = static_cast<float>(probabilities(0));
+            state.turnProbability = static_cast<float>(probabilities(1));
+        }
+    }
+
+    state.speed = QVector2D(state.velocityX, state.velocityZ).length();
+    // Abaixo de 0,1 m/s a direção da velocidade é ruído: mantém o rumo anterior.
+    if (state.speed > 0.1f) {
+        state.rotation = -qRadiansToDegrees(qAtan2(state.velocityX, -state.velocityZ));
+    }
+    state.timeNs = nowNs();
+    return state;
+}
+
+/**
+ * @brief Publica um par de estados (escritor único: a thread da simulação).
+ * @param pair O estado anterior e o atual.
+ *
+ * A sequência fica ímpar durante a cópia; a barreira release garante que um leitor que veja
+ * a sequência par final também veja todas as palavras novas.
+ */
+void TractorSimulation::publish(const StatePair& pair)
+{
+    quint32 words[STATE_WORDS];
+    std::memcpy(words, &pair, sizeof(words));
+
+    const quint32 sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < STATE_WORDS; ++i) {
+        m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Lê o par de estados mais recente (qualquer thread, sem travas).
+ * @return StatePair Uma cópia consistente do último par publicado.
+ *
+ * Repete a cópia se uma escrita estava em andamento (sequência ímpar) ou aconteceu durante a
+ * leitura (sequência mudou). Uma escrita leva poucas dezenas de nanossegundos, então a
+ * repetição é rara e curta.
+ */
+TractorSimulation::StatePair TractorSimulation::readPair() const
+{
+    quint32 words[STATE_WORDS];
+    for (;;) {
+        const quint32 before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;
+        }
+        for (int i = 0; i < STATE_WORDS; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+
+    StatePair pair;
+    std::memcpy(&pair, words, sizeof(pair));
+    return pair;
+}
@@ -0,0 +1,147 @@
+#ifndef TRACTORSIMULATION_H
+#define TRACTORSIMULATION_H
+
+#include <QThread>        // Classe base: a simulação roda na sua própria thread.
+#include <QMutex>         // Protege o filtro IMM entre a thread da simulação e a thread principal.
+#include <QElapsedTimer>  // Relógio da simulação e tempo desde a última medição GPS.
+#include <QtGlobal>       // Para qint64 e quint32.
+#include <atomic>         // Para o seqlock dos estados publicados.
+#include "immfilter.h"    // O filtro IMM que estima a posição e a velocidade do trator.
+
+// Estrutura: TractorState
+// Descrição: Um estado do trator publicado pela simulação (imutável depois de publicado).
+//            Só contém tipos simples: é copiado palavra a palavra pelo seqlock.
+struct TractorState {
+    qint64 timeNs = 0;              // Instante do estado no relógio da simulação (TractorSimulation::nowNs).
+    float x = 0.0f;                 // Posição no mundo (X).
+    float z = 0.0f;                 // Posição no mundo (Z).
+    float velocityX = 0.0f;         // Velocidade filtrada, em m/s.
+    float velocityZ = 0.0f;
+    float speed = 0.0f;             // Módulo da velocidade, em m/s.
+    float rotation = 0.0f;          // Rumo do trator em graus (rotação em torno do eixo Y).
+    float straightProbability = 0.0f; // Probabilidade do modo "Reta" (FKL) no IMM.
+    float turnProbability = 0.0f;     // Probabilidade do modo "Curva" (UKF) no IMM.
+    quint32 tick = 0;               // Número do passo da simulação.
+    quint32 valid = 0;              // 1 depois que o filtro recebeu a primeira medição.
+};
+
+// Classe: TractorSimulation
+// Descrição: Roda a predição do filtro IMM e a cinemática do trator em passo fixo, em uma thread
+//            dedicada, para que um quadro lento ou o relayout de um label na thread principal não
+//            atrase o estado do trator. Cada passo publica o estado anterior e o atual juntos por
+//            um seqlock: o escritor (esta thread) nunca espera, e o leitor (o renderizador) só
+//            repete a cópia se ela coincidiu com uma escrita. O renderizador interpola entre os
+//            dois estados no instante do quadro (um passo atrás do mais recente).
+//            As medições GPS e os perfis do filtro chegam da thread principal sob um mutex
+//            curto, só em volta das chamadas do filtro.
+class TractorSimulation : public QThread {
+public:
+    // Construtor: TractorSimulation
+    // Parâmetros:
+    //   - rateHz: Passos da simulação por segundo.
+    //   - parent: O objeto pai.
+    explicit TractorSimulation(int rateHz, QObject* parent = nullptr);
+
+    // Destrutor: Para a thread e espera o passo em andamento terminar.
+    ~TractorSimulation() override;
+
+    // Método: stop
+    // Descrição: Pede o fim do laço da simulação e espera a thread terminar.
+    void stop();
+
+    // Método: addMeasurement
+    // Descrição: Entrega uma medição GPS ao filtro IMM (thread principal).
+    // Parâmetros:
+    //   - x / z: Posição medida no mundo.
+    void addMeasurement(double x, double z);
+
+    // Método: setFilterProfile
+    // Descrição: Troca o perfil (incertezas R e Q) do filtro IMM (thread principal).
+    void setFilterProfile(const FilterProfile& profile);
+
+    // Método: resetFilter
+    // Descrição: Reinicia o filtro IMM em uma posição (thread principal).
+    void resetFilter(double x, double z);
+
+    // Método: latestState
+    // Descrição: Retorna o estado mais recente publicado, sem interpolação. Pode ser chamado de
+    //            qualquer thread.
+    TractorState latestState() const;
+
+    // Método: interpolatedState
+    // Descrição: Retorna o estado no instante atual menos um passo, interpolado entre os dois
+    //            últimos estados publicados (posição, velocidade e rumo). Chamado pelo
+    //            renderizador a cada quadro.
+    TractorState interpolatedState() const;
+
+    // Método: nowNs
+    // Descrição: Relógio da simulação, em nanossegundos desde a criação do objeto.
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+protected:
+    // Método: run
+    // Descrição: Laço de passo fixo da thread: prediz, publica e dorme até o próximo passo.
+    void run() override;
+
+private:
+    // Estrutura: StatePair
+    // Descrição: O que é publicado em cada passo: o estado anterior e o atual.
+    struct StatePair {
+        TractorState previous;
+        TractorState current;
+    };
+
+    // Constante: STATE_WORDS
+    // Descrição: Tamanho de StatePair em palavras de 32 bits (a unidade copiada pelo seqlock).
+    static constexpr int STATE_WORDS = sizeof(StatePair) / sizeof(quint32);
+
+    // Constante: MAX_EXTRAPOLATION_MS
+    // Descrição: Limite da extrapolação desde a última medição GPS: sem sinal, o trator para
+    //            na última posição prevista em vez de seguir em frente indefinidamente.
+    static constexpr qint64 MAX_EXTRAPOLATION_MS = 1000;
+
+    // Método Privado: step
+    // Descrição: Um passo da simulação: prediz a posição pelo filtro e calcula a cinemática.
+    // Retorno: TractorState - O novo estado.
+    TractorState step(const TractorState& previous, quint32 tick);
+
+    // Método Privado: publish / readPair
+    // Descrição: Escrita (só a thread da simulação) e leitura (qualquer thread) do seqlock.
+    void publish(const StatePair& pair);
+    StatePair readPair() const;
+
+    // Membro: m_filter
+    // Tipo: immfilter
+    // Descrição: O filtro IMM. Acessado apenas com `m_filterMutex` travado.
+    immfilter m_filter;
+
+    // Membro: m_filterMutex
+    // Tipo: QMutex
+    // Descrição: Protege `m_filter` e `m_measurementTimer`.
+    mutable QMutex m_filterMutex;
+
+    // Membro: m_measurementTimer
+    // Tipo: QElapsedTimer
+    // Descrição: Tempo desde a última medição (horizonte da extrapolação).
+    QElapsedTimer m_measurementTimer;
+
+    // Membro: m_clock
+    // Tipo: QElapsedTimer
+    // Descrição: Relógio da simulação, iniciado no construtor e só lido depois.
+    QElapsedTimer m_clock;
+
+    // Membro: m_stepNs
+    // Tipo: qint64
+    // Descrição: Duração de um passo, em nanossegundos.
+    qint64 m_stepNs;
+
+    // Membros: m_sequence / m_words
+    // Tipo: std::atomic<quint32>
+    // Descrição: O seqlock. A sequência é ímpar durante uma escrita; o StatePair é guardado em
+    //            palavras atômicas (acessos relaxados), para que a leitura concorrente com uma
+    //            escrita não seja uma condição de corrida, só uma cópia descartada.
+    alignas(64) std::atomic<quint32> m_sequence;
+    std::atomic<quint32> m_words[STATE_WORDS];
+};
+
+#endif // TRACTORSIMULATION_H
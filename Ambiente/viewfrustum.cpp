@@ -0,0 +1,73 @@
+#include "viewfrustum.h" // Inclui o cabeçalho da classe ViewFrustum.
+#include <QVector4D>     // Linhas da matriz de visão-projeção.
+#include <cmath>         // Para std::sqrt.
+
+/**
+ * @brief Construtor: sem planos, todas as caixas são visíveis até o primeiro `update`.
+ */
+ViewFrustum::ViewFrustum() :
+    m_planes{}, // Planos zerados até o primeiro update.
+    m_valid(false)
+{}
+
+/**
+ * @brief Extrai os planos do volume de visão de uma matriz de visão-projeção.
+ * @param viewProjection projectionMatrix * viewMatrix da câmera.
+ *
+ * Cada plano é a soma ou a diferença entre a quarta linha da matriz e uma das outras três
+ * (profundidade do OpenGL em [-w, w]). Os planos são normalizados para que o teste da
+ * caixa possa usar uma margem em metros.
+ */
+void ViewFrustum::update(const QMatrix4x4& viewProjection)
+{
+    const QVector4D rowX = viewProjection.row(0);
+    const QVector4D rowY = viewProjection.row(1);
+    const QVector4D rowZ = viewProjection.row(2);
+    const QVector4D rowW = viewProjection.row(3);
+    const QVector4D planes[6] = {
+        rowW + rowX, // Esquerdo.
+        rowW - rowX, // Direito.
+        rowW + rowY, // Inferior.
+        rowW - rowY, // Superior.
+        rowW + rowZ, // Próximo.
+        rowW - rowZ  // Distante.
+    };
+
+    for (int i = 0; i < 6; ++i) {
+        const QVector4D& plane = planes[i];
+        const float length = std::sqrt(plane.x() * plane.x() + plane.y() * plane.y() + plane.z() * plane.z());
+        const float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+        m_planes[i][0] = plane.x() * invLength;
+        m_planes[i][1] = plane.y() * invLength;
+        m_planes[i][2] = plane.z() * invLength;
+        m_planes[i][3] = plane.w() * invLength;
+    }
+    m_valid = true;
+}
+
+/**
+ * @brief Testa uma caixa alinhada aos eixos contra os seis planos.
+ * @param boxMin Canto mínimo da caixa.
+ * @param boxMax Canto máximo da caixa.
+ * @param margin Distância que a caixa pode estar fora de um plano e ainda ser aceita.
+ * @return false se a caixa está inteiramente fora de algum plano.
+ *
+ * Para cada plano basta testar o canto mais "para dentro" da caixa (o canto positivo,
+ * escolhido pelos sinais da normal): se nem ele está do lado de dentro, a caixa toda está fora.
+ */
+bool ViewFrustum::intersectsBox(const QVector3D& boxMin, const QVector3D& boxMax, float margin) const
+{
+    if (!m_valid) {
+        return true;
+    }
+    for (int i = 0; i < 6; ++i) {
+        const float* plane = m_planes[i];
+        const float x = plane[0] >= 0.0f ? boxMax.x() : boxMin.x();
+        const float y = plane[1] >= 0.0f ? boxMax.y() : boxMin.y();
+        const float z = plane[2] >= 0.0f ? boxMax.z() : boxMin.z();
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < -margin) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef VIEWFRUSTUM_H
+#define VIEWFRUSTUM_H
+
+#include <QMatrix4x4>         // Matriz de visão-projeção da câmera, de onde saem os planos.
+#include <QVector3D>          // Cantos da caixa envolvente testada.
+
+// Classe: ViewFrustum
+// Descrição: Os seis planos do volume de visão da câmera, extraídos da matriz de
+//            visão-projeção (método de Gribb/Hartmann), para descartar antes do desenho os
+//            objetos que não aparecem na tela. As normais dos planos apontam para dentro.
+//            Enquanto `update` não é chamado, todas as caixas são consideradas visíveis.
+class ViewFrustum {
+public:
+    ViewFrustum();
+
+    // Método: update
+    // Descrição: Recalcula os planos a partir da matriz de visão-projeção do quadro.
+    // Parâmetros:
+    //   - viewProjection: projectionMatrix * viewMatrix da câmera.
+    void update(const QMatrix4x4& viewProjection);
+
+    // Método: intersectsBox
+    // Descrição: Testa se uma caixa alinhada aos eixos está (ao menos em parte) dentro do volume
+    //            de visão. O teste é conservador: caixas perto dos cantos podem ser aceitas.
+    // Parâmetros:
+    //   - boxMin: Canto mínimo da caixa, no espaço do mundo.
+    //   - boxMax: Canto máximo da caixa, no espaço do mundo.
+    //   - margin: Distância, em metros, que a caixa pode estar fora de um plano e ainda ser aceita.
+    // Retorno: bool - false se a caixa está inteiramente fora de algum plano.
+    bool intersectsBox(const QVector3D& boxMin, const QVector3D& boxMax, float margin = 0.0f) const;
+
+    // Método: isValid
+    // Descrição: Indica se os planos já foram calculados.
+    bool isValid() const { return m_valid; }
+
+private:
+    // Membro: m_planes
+    // Tipo: float[6][4]
+    // Descrição: Planos esquerdo, direito, inferior, superior, próximo e distante, como
+    //            (a, b, c, d) normalizados: a distância de um ponto p é a*x + b*y + c*z + d.
+    float m_planes[6][4];
+
+    // Membro: m_valid
+    // Tipo: bool
+    // Descrição: false até a primeira chamada de `update`.
+    bool m_valid;
+};
+
+#endif // VIEWFRUSTUM_H
@@ -28,6 +28,13 @@ struct WorldConfig {
     //            Também é recomendável que seja (potência de 2) + 1.
     int lowRes = 17; // (potencia de 2) + 1
 
+    // Membro: coarsestRes
+    // Tipo: int
+    // Descrição: Resolução mínima dos níveis de LOD além de 'lowRes': a partir do LOD 1, cada
+    //            nível tem metade da resolução do anterior, até não passar de 'coarsestRes'
+    //            (65, 17, 9, 5: 4 níveis). Igual a 'lowRes' para ficar só com os dois níveis.
+    int coarsestRes = 5; // (potencia de 2) + 1
+
     // Membro: gridRenderSize
     // Tipo: int
     // Descrição: Define o número de chunks a serem renderizados ao redor do chunk central
@@ -37,11 +44,206 @@ struct WorldConfig {
 
     // Membro: lodDistanceThreshold
     // Tipo: float
-    // Descrição: Define a distância da câmera a partir da qual um chunk muda seu Nível de Detalhe (LOD).
-    //            Chunks mais próximos que essa distância usarão 'highRes', enquanto os mais distantes
-    //            usarão 'lowRes'. É calculado com base no 'chunkSize'.
+    // Descrição: Define a distância da câmera até onde vai o nível de LOD 0 ('highRes').
+    //            Cada nível seguinte cobre até o dobro da distância do anterior (CDLOD), de
+    //            modo que o número de triângulos cresce pouco quando a área visível aumenta.
+    //            É calculado com base no 'chunkSize'.
     float lodDistanceThreshold = chunkSize * 2.5f;
 
+    // Membro: lodMorphFraction
+    // Tipo: float
+    // Descrição: Fração final da faixa de cada nível de LOD em que os vértices são deformados
+    //            (morphing no vertex shader) até a superfície do nível seguinte, para que as
+    //            trocas de nível não tenham saltos. A faixa é limitada pela histerese da troca.
+    float lodMorphFraction = 0.5f;
+
+    // Membro: terrainWorkerThreads
+    // Tipo: int
+    // Descrição: Número de threads dedicadas à geração de malha dos chunks (pool privado do
+    //            terreno, independente do QThreadPool global). O padrão deixa 1 núcleo livre
+    //            para a thread principal e o sistema operacional no i.MX8 de 4 núcleos.
+    int terrainWorkerThreads = 3;
+
+    // Membro: uploadBudgetBytesPerFrame
+    // Tipo: int
+    // Descrição: Máximo de bytes de malha enviados para a GPU por quadro. As malhas prontas
+    //            que não couberem esperam os próximos quadros (as mais próximas da câmera primeiro).
+    int uploadBudgetBytesPerFrame = 512 * 1024;
+
+    // Membro: uploadBudgetMsPerFrame
+    // Tipo: float
+    // Descrição: Tempo máximo, em milissegundos, gasto com uploads de malha em um quadro.
+    float uploadBudgetMsPerFrame = 2.0f;
+
+    // Membro: completionQueueCapacity
+    // Tipo: int
+    // Descrição: Capacidade da fila sem travas de malhas prontas (workers -> thread principal),
+    //            arredondada para potência de 2. Com a fila cheia, o worker espera por espaço.
+    int completionQueueCapacity = 1024;
+
+    // Membro: completionDrainPerFrame
+    // Tipo: int
+    // Descrição: Máximo de malhas prontas retiradas da fila de conclusão a cada `update`.
+    int completionDrainPerFrame = 64;
+
+    // Membro: meshCacheBudgetBytes
+    // Tipo: int
+    // Descrição: Memória máxima (RAM) do cache LRU de malhas já geradas, indexado por
+    //            (chunkX, chunkZ, resolução). Nas passadas de ida e volta do trabalho de campo,
+    //            os chunks que voltam à grade reaproveitam a malha em vez de gerá-la de novo.
+    //            0 desativa o cache. Uma malha highRes no formato Full ocupa ~120 KB.
+    int meshCacheBudgetBytes = 64 * 1024 * 1024;
+
+    // Membro: compactTerrainVertices
+    // Tipo: bool
+    // Descrição: Seleciona o formato compacto de vértice do terreno (`CompactVertex`, 8 bytes:
+    //            coluna/linha na grade, altura e altura de morphing int16 e normal em octaedro de
+    //            8 bits) com índices de 16 bits, em vez de `Vertex` (28 bytes) com índices de 32 bits.
+    //            Reduz a memória dos VBOs e a banda de upload em 3.5x, o que importa na memória
+    //            compartilhada da GPU do i.MX8.
+    //            Exige highRes e lowRes <= 256.
+    bool compactTerrainVertices = false;
+
+    // Membro: batchedTerrainDraws
+    // Tipo: bool
+    // Descrição: Desenha o terreno em lote: os vértices dos chunks de cada nível de LOD ficam em
+    //            poucos VBOs grandes (TerrainBatchBuffers) e o terreno inteiro sai em algumas
+    //            chamadas de desenho, em vez de um bind de VAO, um uniforme e um glDrawElements por
+    //            chunk. Não se aplica a 'heightTextureTerrain' (uma textura por chunk).
+    bool batchedTerrainDraws = true;
+
+    // Membro: sortTerrainFrontToBack
+    // Tipo: bool
+    // Descrição: Desenha os chunks visíveis da frente para trás (distância até a câmera), para
+    //            que o early-Z da GPU do i.MX8 descarte os fragmentos cobertos dos chunks de trás
+    //            em vez de sombreá-los e sobrescrevê-los (overdraw).
+    bool sortTerrainFrontToBack = true;
+
+    // Membro: terrainDrawOrderBenchmarkFrames
+    // Tipo: int
+    // Descrição: Se maior que zero, mede o custo da ordem de desenho: alterna entre a ordem da
+    //            frente para trás e a ordem da grade a cada N quadros, cronometra o desenho do
+    //            terreno (com glFinish, o que reduz o FPS) e registra a média de cada ordem no log.
+    //            Use só para medir; 0 desativa.
+    int terrainDrawOrderBenchmarkFrames = 0;
+
+    // Membro: terrainLodBenchmarkFrames
+    // Tipo: int
+    // Descrição: Se maior que zero, mede o LOD do terreno a cada N quadros e registra no log a
+    //            média de triângulos desenhados por quadro e as trocas de nível que chegaram à
+    //            GPU, separando as sem salto (a malha mais fina do par estava totalmente deformada
+    //            até a outra em todo o chunk) das com salto, com a maior deformação que faltava.
+    //            Use só para medir; 0 desativa.
+    int terrainLodBenchmarkFrames = 0;
+
+    // Membro: compactHeightStep
+    // Tipo: float
+    // Descrição: Resolução da altura quantizada no formato compacto, em metros por unidade.
+    //            As alturas são relativas à altura de referência de cada chunk (o meio da sua
+    //            faixa); com 0.01 (1 cm), o int16 cobre ±327 m em torno dela, em qualquer altitude.
+    float compactHeightStep = 0.01f;
+
+    // Membro: heightTextureTerrain
+    // Tipo: bool
+    // Descrição: Modo de renderização por heightmap: cada chunk envia só uma textura de alturas
+    //            (R32F, (resolução + 2)² texels) em vez de uma malha de vértices. O shader de
+    //            vértices reconstrói X/Z a partir de gl_VertexID e calcula as normais por
+    //            diferenças centrais na textura. Cerca de 6x menos memória de GPU por chunk e
+    //            quase nenhum trabalho de malha na CPU. Tem precedência sobre `compactTerrainVertices`.
+    bool heightTextureTerrain = false;
+
+    // Membro: analyticTerrainNormals
+    // Tipo: bool
+    // Descrição: Modo de alta precisão das normais do terreno: cada vértice usa as derivadas
+    //            analíticas do ruído (NoiseUtils::getNormal), uma avaliação extra do fBm por vértice.
+    //            Com false (padrão), a altura é avaliada uma vez por ponto da grade e as normais
+    //            saem por diferenças centrais entre os vizinhos.
+    bool analyticTerrainNormals = false;
+
+    // --- Motor de Alturas do Terreno ---
+    // Descrição: Ruído de gradiente 2D somado em oitavas (fBm), aplicado com NoiseUtils::configure.
+
+    // Membro: terrainNoiseSeed
+    // Tipo: unsigned int
+    // Descrição: Semente do ruído; a mesma semente gera sempre o mesmo relevo.
+    unsigned int terrainNoiseSeed = 1337;
+
+    // Membro: terrainNoiseOctaves
+    // Tipo: int
+    // Descrição: Número de oitavas do fBm (1 a NoiseUtils::MAX_OCTAVES).
+    int terrainNoiseOctaves = 4;
+
+    // Membro: terrainNoiseFrequency
+    // Tipo: float
+    // Descrição: Frequência da primeira oitava, em ciclos por metro (0.02 = ondulações de ~50 m).
+    float terrainNoiseFrequency = 0.02f;
+
+    // Membro: terrainNoiseAmplitude
+    // Tipo: float
+    // Descrição: Amplitude da primeira oitava, em metros. 0 mantém o terreno plano.
+    float terrainNoiseAmplitude = 0.0f;
+
+    // Membro: terrainNoiseLacunarity
+    // Tipo: float
+    // Descrição: Multiplicador da frequência a cada oitava.
+    float terrainNoiseLacunarity = 2.0f;
+
+    // Membro: terrainNoiseGain
+    // Tipo: float
+    // Descrição: Multiplicador da amplitude a cada oitava.
+    float terrainNoiseGain = 0.5f;
+
+    // Membro: terrainDemPath
+    // Tipo: const char*
+    // Descrição: Arquivo DEM em tiles (gerado com `--convert-dem`) com o relevo real da área.
+    //            Quando definido e válido, substitui o ruído acima (NoiseUtils::setHeightSource).
+    //            Vazio (padrão): usa o ruído procedural.
+    const char* terrainDemPath = "";
+
+    // Membro: terrainDemMaxResidentTiles
+    // Tipo: int
+    // Descrição: Número máximo de tiles do DEM mantidos na memória (256 KB cada, com tiles de 256).
+    //            Os menos usados são devolvidos ao sistema a cada recentramento da grade.
+    int terrainDemMaxResidentTiles = 64;
+
+    // Membro: terrainDemGeoreferenced
+    // Tipo: bool
+    // Descrição: Indica que terrainDemOriginLatitude/Longitude são válidos. Nesse caso, o DEM é
+    //            posicionado no mundo quando chega o primeiro fix do GPS (a origem do mundo).
+    //            Falso (padrão): o DEM fica centrado na origem do mundo.
+    bool terrainDemGeoreferenced = false;
+
+    // Membro: terrainDemOriginLatitude / terrainDemOriginLongitude
+    // Tipo: double
+    // Descrição: Latitude e longitude, em graus, do centro da célula noroeste do DEM (a primeira
+    //            amostra do grid ESRI ASCII). A conversão para o mundo usa a mesma distância e
+    //            azimute das posições do GPS (a convergência da grade UTM não é corrigida).
+    double terrainDemOriginLatitude = 0.0;
+    double terrainDemOriginLongitude = 0.0;
+
+    // Membro: gnssTerrainEnabled
+    // Tipo: bool
+    // Descrição: Constrói o relevo durante o trabalho a partir das altitudes do GNSS
+    //            (GnssHeightSource). Usado quando não há DEM; substitui o ruído acima.
+    //            Falso (padrão): o terreno é o do DEM ou o do ruído procedural.
+    bool gnssTerrainEnabled = false;
+
+    // Membro: gnssTerrainCellSize
+    // Tipo: float
+    // Descrição: Lado de cada célula da grade de altitudes, em metros.
+    float gnssTerrainCellSize = 1.0f;
+
+    // Membro: gnssTerrainSplatRadius
+    // Tipo: int
+    // Descrição: Raio, em células, em que cada altitude é espalhada. Cobre o espaço entre
+    //            passadas vizinhas (largura do implemento) para que ele seja interpolado.
+    int gnssTerrainSplatRadius = 3;
+
+    // Membro: gnssTerrainDirtyThreshold
+    // Tipo: float
+    // Descrição: Mudança mínima de altura, em metros, para que os chunks da área sejam regenerados.
+    float gnssTerrainDirtyThreshold = 0.02f;
+
     // Membro: gridSquareSize
     // Tipo: float
     // Descrição: O tamanho do lado de cada quadrado na grade do terreno ( em unidades do mundo)
@@ -58,6 +260,23 @@ struct WorldConfig {
     // um valor menor é um pouco mais eficiente. 40.0 é um bom começo.
     float gridTileSize = 40.0f;
 
+    // Membro: shaderTerrainGrid
+    // Tipo: bool
+    // Descrição: Calcula a grade no fragment shader do terreno, a partir da posição de cada
+    //            fragmento no mundo, em vez de desenhar a geometria de linhas do TerrainGrid:
+    //            a grade cobre todo o terreno visível, acompanha o relevo e não usa nenhum buffer
+    //            nem chamada de desenho extra. As linhas têm anti-aliasing pela derivada em tela
+    //            e somem com a distância ('gridFadeStart' / 'gridFadeEnd').
+    //            Usa 'gridSquareSize', 'gridLineThickness' e a cor do grid.
+    bool shaderTerrainGrid = false;
+
+    // Membros: gridFadeStart / gridFadeEnd
+    // Tipo: float
+    // Descrição: Distância da câmera, em metros, em que a grade do shader começa a sumir e em
+    //            que some por completo (onde as linhas ficariam mais finas que um pixel).
+    float gridFadeStart = 30.0f;
+    float gridFadeEnd = 80.0f;
+
     // --- Configurações da Câmera ---
     // Descrição: Parâmetros que controlam o comportamento da câmera que segue o trator.
 
@@ -77,6 +296,62 @@ struct WorldConfig {
     //            Valores menores dão mais zoom, valores maiores dão uma visão mais ampla.
     float cameraFov = 25.0f;
 
+    // Membro: simulationRateHz
+    // Tipo: int
+    // Descrição: Passos por segundo da simulação do trator (predição do filtro IMM e cinemática),
+    //            que roda em thread própria. O desenho interpola entre os dois últimos passos,
+    //            então esta taxa não precisa coincidir com a de quadros.
+    int simulationRateHz = 60;
+
+    // Membro: renderOnDemand
+    // Tipo: bool
+    // Descrição: Redesenha a tela só quando algo mudou: o trator (e a câmera que o segue) andou
+    //            ou girou mais que 'redrawPixelThreshold' pixels na tela, ou o terreno tem malhas
+    //            sendo geradas ou esperando upload. Parado, o redesenho cai para um quadro a cada
+    //            'idleFrameIntervalMs'. Falso redesenha a cada tick do timer (~60 quadros/s),
+    //            gastando CPU, GPU e calor mesmo com a imagem parada.
+    bool renderOnDemand = true;
+
+    // Membro: redrawPixelThreshold
+    // Tipo: float
+    // Descrição: Deslocamento estimado na tela, em pixels, a partir do qual um novo quadro é desenhado.
+    float redrawPixelThreshold = 0.5f;
+
+    // Membro: idleFrameIntervalMs
+    // Tipo: int
+    // Descrição: Intervalo máximo entre quadros sem mudanças (taxa mínima de redesenho).
+    int idleFrameIntervalMs = 500;
+
+    // Membro: qualityGovernorEnabled
+    // Tipo: bool
+    // Descrição: Liga o governador de qualidade (QualityGovernor): com o SoC quente ou o tempo de
+    //            quadro acima do orçamento, reduz a área de terreno ativa, as distâncias de LOD, as
+    //            threads de geração e a taxa de quadros, em até 3 níveis, e restaura com histerese.
+    bool qualityGovernorEnabled = true;
+
+    // Membro: thermalZonePath
+    // Tipo: const char*
+    // Descrição: Arquivo de temperatura lido a cada 2 s (miliCelsius, formato do sysfs). Apontar
+    //            para um arquivo comum permite simular o aquecimento (ex.: echo 82000 > /tmp/temp).
+    const char* thermalZonePath = "/sys/class/thermal/thermal_zone0/temp";
+
+    // Membros: thermalThrottleCelsius / thermalStepCelsius
+    // Tipo: float
+    // Descrição: Temperatura do primeiro nível de redução e o intervalo até cada nível seguinte
+    //            (padrão: níveis 1, 2 e 3 a partir de 70, 75 e 80 °C).
+    float thermalThrottleCelsius = 70.0f;
+    float thermalStepCelsius = 5.0f;
+
+    // Membro: thermalHysteresisCelsius
+    // Tipo: float
+    // Descrição: Quanto a temperatura precisa cair abaixo do limite do nível para voltar ao anterior.
+    float thermalHysteresisCelsius = 4.0f;
+
+    // Membro: qualityRestoreHoldMs
+    // Tipo: int
+    // Descrição: Tempo mínimo em um nível antes de restaurar o anterior (evita oscilação).
+    int qualityRestoreHoldMs = 10000;
+
     // --- Configurações de Cor ---
     // Descrição: Parâmetros que controlam as cores dos elementos na cena.
     //            Os valores de cor são em formato RGB, de 0.0 a 1.0.